@@ -23,3 +23,4 @@ hunter_add_package(GTest)
 hunter_add_package(intx)
 hunter_add_package(nlohmann_json)
 hunter_add_package(Protobuf)
+hunter_add_package(ZLIB)
@@ -0,0 +1,219 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "admission_control.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <asio/post.hpp>
+#include <asio/redirect_error.hpp>
+#include <asio/this_coro.hpp>
+#include <asio/use_awaitable.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::commands {
+
+ConcurrencyLimiter::Waiter::Waiter(ConcurrencyLimiter& limiter, const asio::any_io_executor& executor)
+: limiter{limiter}, timer{std::make_shared<asio::steady_timer>(executor, asio::steady_timer::time_point::max())} {}
+
+ConcurrencyLimiter::Waiter::~Waiter() {
+    // A waiter destroyed before being admitted must leave the queue, one admitted but never resumed must give the slot back
+    std::lock_guard lock{limiter.mutex_};
+    if (!admitted) {
+        limiter.waiters_.erase(std::remove(limiter.waiters_.begin(), limiter.waiters_.end(), this), limiter.waiters_.end());
+    } else if (!resumed) {
+        limiter.release_locked();
+    }
+}
+
+asio::awaitable<bool> ConcurrencyLimiter::acquire() {
+    auto executor = co_await asio::this_coro::executor;
+    std::optional<Waiter> waiter;
+    {
+        std::lock_guard lock{mutex_};
+        if (running_ < max_running_) {
+            ++running_;
+            co_return true;
+        }
+        if (waiters_.size() >= max_queued_) {
+            ++rejected_;
+            co_return false;
+        }
+        waiter.emplace(*this, executor);
+        waiters_.push_back(&*waiter);
+    }
+
+    asio::error_code ec;
+    co_await waiter->timer->async_wait(asio::redirect_error(asio::use_awaitable, ec));
+    waiter->resumed = true;
+    co_return true;
+}
+
+void ConcurrencyLimiter::release() {
+    std::lock_guard lock{mutex_};
+    release_locked();
+}
+
+void ConcurrencyLimiter::release_locked() {
+    if (waiters_.empty()) {
+        --running_;
+        return;
+    }
+    // The slot goes straight to the oldest waiter, woken up on its own executor: the handler keeps the timer alive
+    // because the waiter may be gone by the time it runs
+    auto waiter = waiters_.front();
+    waiters_.pop_front();
+    waiter->admitted = true;
+    asio::post(waiter->timer->get_executor(), [timer = waiter->timer]() { timer->cancel(); });
+}
+
+std::size_t ConcurrencyLimiter::running() const {
+    std::lock_guard lock{mutex_};
+    return running_;
+}
+
+std::size_t ConcurrencyLimiter::queued() const {
+    std::lock_guard lock{mutex_};
+    return waiters_.size();
+}
+
+uint64_t ConcurrencyLimiter::rejected() const {
+    std::lock_guard lock{mutex_};
+    return rejected_;
+}
+
+AdmissionPermit::AdmissionPermit(AdmissionPermit&& other) noexcept
+: method_limiter_{std::exchange(other.method_limiter_, nullptr)}, namespace_limiter_{std::exchange(other.namespace_limiter_, nullptr)} {}
+
+AdmissionPermit& AdmissionPermit::operator=(AdmissionPermit&& other) noexcept {
+    if (this != &other) {
+        release();
+        method_limiter_ = std::exchange(other.method_limiter_, nullptr);
+        namespace_limiter_ = std::exchange(other.namespace_limiter_, nullptr);
+    }
+    return *this;
+}
+
+AdmissionPermit::~AdmissionPermit() {
+    release();
+}
+
+void AdmissionPermit::release() {
+    if (namespace_limiter_) {
+        namespace_limiter_->release();
+        namespace_limiter_ = nullptr;
+    }
+    if (method_limiter_) {
+        method_limiter_->release();
+        method_limiter_ = nullptr;
+    }
+}
+
+namespace {
+
+std::vector<std::string> split(const std::string& value, char separator) {
+    std::vector<std::string> tokens;
+    std::size_t start{0};
+    while (true) {
+        const auto end = value.find(separator, start);
+        tokens.push_back(value.substr(start, end - start));
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    return tokens;
+}
+
+std::size_t parse_size(const std::string& value, const std::string& limit) {
+    if (value.empty() || !std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        throw std::invalid_argument{"invalid concurrency limit: " + limit};
+    }
+    return std::stoul(value);
+}
+
+} // namespace
+
+AdmissionControl::AdmissionControl(const std::string& limits_spec) {
+    if (limits_spec.empty()) {
+        return;
+    }
+    for (const auto& limit : split(limits_spec, ',')) {
+        const auto fields = split(limit, ':');
+        if (fields.size() < 2 || fields.size() > 3 || fields[0].empty()) {
+            throw std::invalid_argument{"invalid concurrency limit: " + limit};
+        }
+        const auto max_running = parse_size(fields[1], limit);
+        const auto max_queued = fields.size() == 3 ? parse_size(fields[2], limit) : max_running;
+        if (max_running == 0) {
+            throw std::invalid_argument{"invalid concurrency limit: " + limit};
+        }
+        if (!limiters_.emplace(fields[0], std::make_unique<ConcurrencyLimiter>(max_running, max_queued)).second) {
+            throw std::invalid_argument{"duplicated concurrency limit: " + fields[0]};
+        }
+        SILKRPC_INFO << "AdmissionControl " << fields[0] << " max running: " << max_running << " max queued: " << max_queued << "\n";
+    }
+}
+
+asio::awaitable<std::optional<AdmissionPermit>> AdmissionControl::admit(const std::string& method) {
+    AdmissionPermit permit;
+    if (limiters_.empty()) {
+        co_return std::move(permit);
+    }
+
+    // Acquire in fixed order, method first: any slot already acquired is released by the permit on rejection
+    const auto method_limiter = find_limiter(method);
+    if (method_limiter) {
+        if (!co_await method_limiter->acquire()) {
+            log_rejection(method, method, *method_limiter);
+            co_return std::nullopt;
+        }
+        permit.method_limiter_ = method_limiter;
+    }
+    const auto api_namespace = method.substr(0, method.find('_'));
+    const auto namespace_limiter = api_namespace != method ? find_limiter(api_namespace) : nullptr;
+    if (namespace_limiter) {
+        if (!co_await namespace_limiter->acquire()) {
+            log_rejection(method, api_namespace, *namespace_limiter);
+            co_return std::nullopt;
+        }
+        permit.namespace_limiter_ = namespace_limiter;
+    }
+    co_return std::move(permit);
+}
+
+void AdmissionControl::for_each_limiter(const std::function<void(const std::string&, const ConcurrencyLimiter&)>& visitor) const {
+    for (const auto& [name, limiter] : limiters_) {
+        visitor(name, *limiter);
+    }
+}
+
+void AdmissionControl::log_rejection(const std::string& method, const std::string& name, const ConcurrencyLimiter& limiter) {
+    SILKRPC_WARN << "AdmissionControl rejected method: " << method << " limit: " << name << " running: " << limiter.running()
+        << " queued: " << limiter.queued() << " rejected: " << limiter.rejected() << "\n";
+}
+
+ConcurrencyLimiter* AdmissionControl::find_limiter(const std::string& name) const {
+    const auto it = limiters_.find(name);
+    return it != limiters_.end() ? it->second.get() : nullptr;
+}
+
+} // namespace silkrpc::commands
@@ -0,0 +1,132 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMANDS_ADMISSION_CONTROL_HPP_
+#define SILKRPC_COMMANDS_ADMISSION_CONTROL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <silkrpc/config.hpp>
+
+#include <asio/any_io_executor.hpp>
+#include <asio/awaitable.hpp>
+#include <asio/steady_timer.hpp>
+
+namespace silkrpc::commands {
+
+// Bounds the number of requests running concurrently, queueing the excess up to a maximum and rejecting the rest.
+// Requests may run on any io_context thread, so the limiter is thread-safe.
+class ConcurrencyLimiter {
+public:
+    ConcurrencyLimiter(std::size_t max_running, std::size_t max_queued) : max_running_{max_running}, max_queued_{max_queued} {}
+
+    ConcurrencyLimiter(const ConcurrencyLimiter&) = delete;
+    ConcurrencyLimiter& operator=(const ConcurrencyLimiter&) = delete;
+
+    // Wait for a free slot, return false without waiting if the queue is full
+    asio::awaitable<bool> acquire();
+
+    // Free the slot, handing it over to the oldest waiter if any
+    void release();
+
+    std::size_t max_running() const { return max_running_; }
+    std::size_t max_queued() const { return max_queued_; }
+    std::size_t running() const;
+    std::size_t queued() const;
+    uint64_t rejected() const;
+
+private:
+    // Living in the frame of the waiting coroutine, which can be destroyed without being resumed (e.g. on shutdown)
+    struct Waiter {
+        ConcurrencyLimiter& limiter;
+        std::shared_ptr<asio::steady_timer> timer; // shared with the wake-up handler, which can outlive the waiter
+        bool admitted{false}; // the slot has been handed over, guarded by the limiter mutex
+        bool resumed{false}; // the waiting coroutine has taken the slot over
+
+        Waiter(ConcurrencyLimiter& limiter, const asio::any_io_executor& executor);
+        ~Waiter();
+    };
+
+    // Free the slot while holding the mutex
+    void release_locked();
+
+    const std::size_t max_running_;
+    const std::size_t max_queued_;
+
+    mutable std::mutex mutex_;
+    std::size_t running_{0};
+    std::deque<Waiter*> waiters_;
+    uint64_t rejected_{0};
+};
+
+// Proof of admission holding the acquired slots until destroyed
+class AdmissionPermit {
+public:
+    AdmissionPermit() = default;
+    AdmissionPermit(AdmissionPermit&& other) noexcept;
+    AdmissionPermit& operator=(AdmissionPermit&& other) noexcept;
+    ~AdmissionPermit();
+
+    AdmissionPermit(const AdmissionPermit&) = delete;
+    AdmissionPermit& operator=(const AdmissionPermit&) = delete;
+
+private:
+    friend class AdmissionControl;
+
+    void release();
+
+    ConcurrencyLimiter* method_limiter_{nullptr};
+    ConcurrencyLimiter* namespace_limiter_{nullptr};
+};
+
+// Admission control in front of the method dispatch, applying per-method and per-namespace concurrency limits.
+// The limits are specified as comma-separated list of <name>:<max running>[:<max queued>], where name is either
+// a method (e.g. eth_getLogs) or a namespace (e.g. debug) and max queued defaults to max running.
+class AdmissionControl {
+public:
+    // Build the limits from their specification, throw std::invalid_argument if not valid
+    explicit AdmissionControl(const std::string& limits_spec);
+
+    AdmissionControl(const AdmissionControl&) = delete;
+    AdmissionControl& operator=(const AdmissionControl&) = delete;
+
+    // Wait until the method is admitted by both its own and its namespace limits, if any. Return no permit if rejected
+    asio::awaitable<std::optional<AdmissionPermit>> admit(const std::string& method);
+
+    // Visit all the limiters, e.g. to observe their queue depth and rejection count
+    void for_each_limiter(const std::function<void(const std::string&, const ConcurrencyLimiter&)>& visitor) const;
+
+private:
+    ConcurrencyLimiter* find_limiter(const std::string& name) const;
+
+    static void log_rejection(const std::string& method, const std::string& name, const ConcurrencyLimiter& limiter);
+
+    // Limiters are created at startup and never changed, so lookups need no lock
+    std::map<std::string, std::unique_ptr<ConcurrencyLimiter>> limiters_;
+};
+
+} // namespace silkrpc::commands
+
+#endif  // SILKRPC_COMMANDS_ADMISSION_CONTROL_HPP_
@@ -0,0 +1,157 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "admission_control.hpp"
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include <asio/co_spawn.hpp>
+#include <asio/detached.hpp>
+#include <asio/io_context.hpp>
+#include <asio/use_future.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc::commands {
+
+TEST_CASE("concurrency limiter", "[silkrpc][commands][admission_control]") {
+    asio::io_context io_context;
+    ConcurrencyLimiter limiter{1, 1};
+
+    std::vector<std::optional<bool>> results(3);
+    for (auto& result : results) {
+        asio::co_spawn(io_context, [&]() -> asio::awaitable<void> { result = co_await limiter.acquire(); }, asio::detached);
+    }
+    io_context.poll();
+    io_context.restart();
+
+    CHECK(results[0] == true);
+    CHECK(!results[1]);
+    CHECK(results[2] == false);
+    CHECK(limiter.running() == 1);
+    CHECK(limiter.queued() == 1);
+    CHECK(limiter.rejected() == 1);
+
+    limiter.release();
+    io_context.poll();
+    io_context.restart();
+    CHECK(results[1] == true);
+    CHECK(limiter.running() == 1);
+    CHECK(limiter.queued() == 0);
+
+    limiter.release();
+    CHECK(limiter.running() == 0);
+}
+
+TEST_CASE("concurrency limiter waiter destroyed", "[silkrpc][commands][admission_control]") {
+    asio::io_context io_context;
+    ConcurrencyLimiter limiter{1, 1};
+    auto result{asio::co_spawn(io_context, limiter.acquire(), asio::use_future)};
+    io_context.run();
+    CHECK(result.get());
+
+    // The waiting coroutine is destroyed together with its io_context, never resumed
+    auto waiter_io_context = std::make_unique<asio::io_context>();
+    asio::co_spawn(*waiter_io_context, limiter.acquire(), asio::detached);
+    waiter_io_context->poll();
+    REQUIRE(limiter.queued() == 1);
+
+    SECTION("before admission") {
+        waiter_io_context.reset();
+        CHECK(limiter.queued() == 0);
+        CHECK(limiter.running() == 1);
+    }
+
+    SECTION("after admission") {
+        limiter.release();
+        CHECK(limiter.queued() == 0);
+        CHECK(limiter.running() == 1);
+        waiter_io_context.reset();
+        CHECK(limiter.running() == 0);
+    }
+}
+
+TEST_CASE("admission control limits", "[silkrpc][commands][admission_control]") {
+    SECTION("valid specs") {
+        CHECK_NOTHROW(AdmissionControl{""});
+        CHECK_NOTHROW(AdmissionControl{"eth_getLogs:8"});
+        CHECK_NOTHROW(AdmissionControl{"eth_getLogs:8:0,debug:2:16"});
+    }
+
+    SECTION("invalid specs") {
+        CHECK_THROWS_AS(AdmissionControl{"eth_getLogs"}, std::invalid_argument);
+        CHECK_THROWS_AS(AdmissionControl{"eth_getLogs:0"}, std::invalid_argument);
+        CHECK_THROWS_AS(AdmissionControl{"eth_getLogs:x"}, std::invalid_argument);
+        CHECK_THROWS_AS(AdmissionControl{"eth_getLogs:1:2:3"}, std::invalid_argument);
+        CHECK_THROWS_AS(AdmissionControl{":1"}, std::invalid_argument);
+        CHECK_THROWS_AS(AdmissionControl{"debug:1,debug:2"}, std::invalid_argument);
+        CHECK_THROWS_AS(AdmissionControl{"eth_call:1,"}, std::invalid_argument);
+    }
+
+    SECTION("visit limiters") {
+        AdmissionControl admission_control{"eth_getLogs:8,debug:2:16"};
+        std::vector<std::string> names;
+        admission_control.for_each_limiter([&](const std::string& name, const ConcurrencyLimiter& limiter) {
+            names.push_back(name);
+            if (name == "debug") {
+                CHECK(limiter.max_running() == 2);
+                CHECK(limiter.max_queued() == 16);
+            } else {
+                CHECK(limiter.max_queued() == 8);
+            }
+        });
+        CHECK(names == std::vector<std::string>{"debug", "eth_getLogs"});
+    }
+}
+
+TEST_CASE("admission control admit", "[silkrpc][commands][admission_control]") {
+    asio::io_context io_context;
+    AdmissionControl admission_control{"eth_getLogs:1:0,debug:1:0"};
+
+    const auto admit = [&](const std::string& method) {
+        auto result{asio::co_spawn(io_context, admission_control.admit(method), asio::use_future)};
+        io_context.run();
+        io_context.restart();
+        return result.get();
+    };
+
+    SECTION("unlimited method") {
+        auto permit1 = admit("eth_blockNumber");
+        auto permit2 = admit("eth_blockNumber");
+        CHECK(permit1);
+        CHECK(permit2);
+    }
+
+    SECTION("method limit") {
+        auto permit = admit("eth_getLogs");
+        CHECK(permit);
+        CHECK(!admit("eth_getLogs"));
+        permit.reset();
+        CHECK(admit("eth_getLogs"));
+    }
+
+    SECTION("namespace limit") {
+        auto permit = admit("debug_traceTransaction");
+        CHECK(permit);
+        CHECK(!admit("debug_accountRange"));
+        CHECK(admit("eth_getLogs"));
+    }
+}
+
+} // namespace silkrpc::commands
@@ -16,6 +16,7 @@
 
 #include "debug_api.hpp"
 
+#include <exception>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -49,12 +50,12 @@
 namespace silkrpc::commands {
 
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_accountrange
-asio::awaitable<void> DebugRpcApi::handle_debug_account_range(const nlohmann::json& request, nlohmann::json& reply) {
+asio::awaitable<void> DebugRpcApi::handle_debug_account_range(const nlohmann::json& request, JsonStream& stream) {
     auto params = request["params"];
     if (params.size() != 5) {
         auto error_msg = "invalid debug_accountRange params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        stream.write_json(make_json_error(request["id"], 100, error_msg));
         co_return;
     }
     const auto block_number_or_hash = params[0].get<BlockNumberOrHash>();
@@ -77,26 +78,51 @@ asio::awaitable<void> DebugRpcApi::handle_debug_account_range(const nlohmann::js
         << " exclude_storage: " << exclude_storage
         << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
+    std::exception_ptr reply_aborted;
 
     try {
         auto start = std::chrono::system_clock::now();
+
+        // Each batch of accounts is written as soon as it is loaded, so the dump is never collected all together
+        open_json_content(stream, request["id"]);
+        open_json_dump(stream);
+        const AccountDumper::AccountsConsumer write_accounts = [&](AccountsMap& accounts) -> asio::awaitable<void> {
+            write_json_dump_accounts(stream, accounts);
+            co_await stream.flush();
+        };
         AccountDumper dumper{*tx};
-        DumpAccounts dump_accounts = co_await dumper.dump_accounts(block_number_or_hash, start_address, max_result, exclude_code, exclude_storage);
+        const auto dump_accounts = co_await dumper.dump_accounts(block_number_or_hash, start_address, max_result, exclude_code, exclude_storage, write_accounts);
+        close_json_dump(stream, dump_accounts);
+        close_json_content(stream);
+
         auto end = std::chrono::system_clock::now();
         std::chrono::duration<double> elapsed_seconds = end - start;
         SILKRPC_DEBUG << "dump_accounts: elapsed " << elapsed_seconds.count() << " sec\n";
-
-        reply = make_json_content(request["id"], dump_accounts);
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        if (stream.flushed()) {
+            reply_aborted = std::current_exception();
+        } else {
+            stream.clear();
+            stream.write_json(make_json_error(request["id"], 100, e.what()));
+        }
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        if (stream.flushed()) {
+            reply_aborted = std::current_exception();
+        } else {
+            stream.clear();
+            stream.write_json(make_json_error(request["id"], 100, "unexpected exception"));
+        }
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
+
+    // Part of the dump has already been sent, so the reply must be aborted instead of completed with an error
+    if (reply_aborted) {
+        std::rethrow_exception(reply_aborted);
+    }
     co_return;
 }
 
@@ -117,7 +143,7 @@ asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_number(
     }
     SILKRPC_DEBUG << "start_block_id: " << start_block_id << " end_block_id: " << end_block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -158,7 +184,7 @@ asio::awaitable<void> DebugRpcApi::handle_debug_get_modified_accounts_by_hash(co
     }
     SILKRPC_DEBUG << "start_hash: " << start_hash << " end_hash: " << end_hash << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -205,7 +231,7 @@ asio::awaitable<void> DebugRpcApi::handle_debug_storage_range_at(const nlohmann:
         << " max_result: " << max_result
         << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -261,7 +287,7 @@ asio::awaitable<void> DebugRpcApi::handle_debug_storage_range_at(const nlohmann:
 
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_tracetransaction
 asio::awaitable<void> DebugRpcApi::handle_debug_trace_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -281,7 +307,7 @@ asio::awaitable<void> DebugRpcApi::handle_debug_trace_transaction(const nlohmann
 
 // https://github.com/ethereum/retesteth/wiki/RPC-Methods#debug_tracecall
 asio::awaitable<void> DebugRpcApi::handle_debug_trace_call(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
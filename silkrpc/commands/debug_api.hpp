@@ -27,6 +27,7 @@
 #include <nlohmann/json.hpp>
 
 #include <silkrpc/core/rawdb/accessors.hpp>
+#include <silkrpc/json/stream.hpp>
 #include <silkrpc/json/types.hpp>
 #include <silkrpc/ethdb/database.hpp>
 #include <silkrpc/ethdb/transaction_database.hpp>
@@ -46,7 +47,7 @@ public:
     DebugRpcApi& operator=(const DebugRpcApi&) = delete;
 
 protected:
-    asio::awaitable<void> handle_debug_account_range(const nlohmann::json& request, nlohmann::json& reply);
+    asio::awaitable<void> handle_debug_account_range(const nlohmann::json& request, JsonStream& stream);
     asio::awaitable<void> handle_debug_get_modified_accounts_by_number(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_debug_get_modified_accounts_by_hash(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_debug_storage_range_at(const nlohmann::json& request, nlohmann::json& reply);
@@ -34,12 +34,14 @@
 
 #include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/reply_cache.hpp>
 #include <silkrpc/common/util.hpp>
 #include <silkrpc/core/cached_chain.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/core/evm_executor.hpp>
 #include <silkrpc/core/estimate_gas_oracle.hpp>
 #include <silkrpc/core/gas_price_oracle.hpp>
+#include <silkrpc/core/logs.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
 #include <silkrpc/core/receipts.hpp>
 #include <silkrpc/core/state_reader.hpp>
@@ -57,7 +59,7 @@ namespace silkrpc::commands {
 
 // https://eth.wiki/json-rpc/API#eth_blocknumber
 asio::awaitable<void> EthereumRpcApi::handle_eth_block_number(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -77,7 +79,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_block_number(const nlohmann::js
 
 // https://eth.wiki/json-rpc/API#eth_chainid
 asio::awaitable<void> EthereumRpcApi::handle_eth_chain_id(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -113,7 +115,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_protocol_version(const nlohmann
 
 // https://eth.wiki/json-rpc/API#eth_syncing
 asio::awaitable<void> EthereumRpcApi::handle_eth_syncing(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -141,7 +143,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_syncing(const nlohmann::json& r
 
 // https://eth.wiki/json-rpc/API#eth_gasprice
 asio::awaitable<void> EthereumRpcApi::handle_eth_gas_price(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -168,19 +170,25 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_gas_price(const nlohmann::json&
 }
 
 // https://eth.wiki/json-rpc/API#eth_getblockbyhash
-asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_hash(const nlohmann::json& request, nlohmann::json& reply) {
+asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_hash(const nlohmann::json& request, JsonStream& stream) {
     auto params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid eth_getBlockByHash params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        stream.write_json(make_json_error(request["id"], 100, error_msg));
         co_return;
     }
     auto block_hash = params[0].get<evmc::bytes32>();
     auto full_tx = params[1].get<bool>();
     SILKRPC_DEBUG << "block_hash: " << block_hash << " full_tx: " << std::boolalpha << full_tx << "\n";
 
-    auto tx = co_await database_->begin();
+    const auto cache_key = ReplyCache::make_key(request);
+    if (const auto result = context_.reply_cache->get(cache_key)) {
+        write_json_content_serialized(stream, request["id"], *result);
+        co_return;
+    }
+
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -190,16 +198,23 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_hash(const nlohman
         const auto total_difficulty = co_await core::rawdb::read_total_difficulty(tx_database, block_hash, block_number);
         const Block extended_block{block_with_hash, total_difficulty, full_tx};
 
-        reply = make_json_content(request["id"], extended_block);
+        // Replies concerning finalized blocks never change, so their results can be cached
+        if (co_await core::is_block_finalized(block_number, tx_database)) {
+            auto result = make_json_result(extended_block);
+            write_json_content_serialized(stream, request["id"], result);
+            context_.reply_cache->insert(cache_key, std::move(result));
+        } else {
+            write_json_content(stream, request["id"], extended_block);
+        }
     } catch (const std::invalid_argument& iv) {
         SILKRPC_DEBUG << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], {});
+        stream.write_json(make_json_content(request["id"], {}));
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        stream.write_json(make_json_error(request["id"], 100, e.what()));
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        stream.write_json(make_json_error(request["id"], 100, "unexpected exception"));
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
@@ -207,19 +222,25 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_hash(const nlohman
 }
 
 // https://eth.wiki/json-rpc/API#eth_getblockbynumber
-asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_number(const nlohmann::json& request, nlohmann::json& reply) {
+asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_number(const nlohmann::json& request, JsonStream& stream) {
     auto params = request["params"];
     if (params.size() != 2) {
         auto error_msg = "invalid getBlockByNumber params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        stream.write_json(make_json_error(request["id"], 100, error_msg));
         co_return;
     }
     const auto block_id = params[0].get<std::string>();
     auto full_tx = params[1].get<bool>();
     SILKRPC_DEBUG << "block_id: " << block_id << " full_tx: " << std::boolalpha << full_tx << "\n";
 
-    auto tx = co_await database_->begin();
+    const auto cache_key = ReplyCache::make_key(request);
+    if (const auto result = context_.reply_cache->get(cache_key)) {
+        write_json_content_serialized(stream, request["id"], *result);
+        co_return;
+    }
+
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -229,16 +250,22 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_by_number(const nlohm
         const auto total_difficulty = co_await core::rawdb::read_total_difficulty(tx_database, block_with_hash.hash, block_number);
         const Block extended_block{block_with_hash, total_difficulty, full_tx};
 
-        reply = make_json_content(request["id"], extended_block);
+        if (co_await core::is_block_finalized(block_number, tx_database)) {
+            auto result = make_json_result(extended_block);
+            write_json_content_serialized(stream, request["id"], result);
+            context_.reply_cache->insert(cache_key, std::move(result));
+        } else {
+            write_json_content(stream, request["id"], extended_block);
+        }
     } catch (const std::invalid_argument& iv) {
         SILKRPC_DEBUG << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], {});
+        stream.write_json(make_json_content(request["id"], {}));
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        stream.write_json(make_json_error(request["id"], 100, e.what()));
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        stream.write_json(make_json_error(request["id"], 100, "unexpected exception"));
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
@@ -257,7 +284,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_transaction_count_by_
     auto block_hash = params[0].get<evmc::bytes32>();
     SILKRPC_DEBUG << "block_hash: " << block_hash << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -290,7 +317,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_block_transaction_count_by_
     const auto block_id = params[0].get<std::string>();
     SILKRPC_DEBUG << "block_id: " << block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -324,7 +351,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_by_block_hash_and_ind
     auto index_string = params[1].get<std::string>();
     SILKRPC_DEBUG << "block_hash: " << block_hash << " index: " << index_string << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -372,7 +399,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_by_block_number_and_i
     const auto index = params[1].get<std::string>();
     SILKRPC_DEBUG << "block_id: " << block_id << " index: " << index << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -418,7 +445,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_count_by_block_hash(c
     auto block_hash = params[0].get<evmc::bytes32>();
     SILKRPC_DEBUG << "block_hash: " << block_hash << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -451,7 +478,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_uncle_count_by_block_number
     const auto block_id = params[0].get<std::string>();
     SILKRPC_DEBUG << "block_id: " << block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -485,7 +512,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_hash(const n
     auto transaction_hash = params[0].get<evmc::bytes32>();
     SILKRPC_DEBUG << "transaction_hash: " << transaction_hash << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -526,7 +553,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_block_hash_a
     const auto index = params[1].get<std::string>();
     SILKRPC_DEBUG << "block_hash: " << block_hash << " index: " << index << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -568,7 +595,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_block_number
     const auto index = params[1].get<std::string>();
     SILKRPC_DEBUG << "block_id: " << block_id << " index: " << index << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -599,21 +626,27 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_by_block_number
 }
 
 // https://eth.wiki/json-rpc/API#eth_gettransactionreceipt
-asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_receipt(const nlohmann::json& request, nlohmann::json& reply) {
+asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_receipt(const nlohmann::json& request, JsonStream& stream) {
     auto params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_getTransactionReceipt params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        stream.write_json(make_json_error(request["id"], 100, error_msg));
         co_return;
     }
     auto transaction_hash = params[0].get<evmc::bytes32>();
     SILKRPC_DEBUG << "transaction_hash: " << transaction_hash << "\n";
-    auto tx = co_await database_->begin();
+
+    const auto cache_key = ReplyCache::make_key(request);
+    if (const auto result = context_.reply_cache->get(cache_key)) {
+        write_json_content_serialized(stream, request["id"], *result);
+        co_return;
+    }
+
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
-        reply = make_json_content(request["id"], nullptr);
         const auto block_with_hash = co_await core::rawdb::read_block_by_transaction_hash(tx_database, transaction_hash);
         auto receipts = co_await core::get_receipts(tx_database, block_with_hash.hash, block_with_hash.block.header.number);
         auto transactions = block_with_hash.block.transactions;
@@ -635,16 +668,22 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_receipt(const n
         if (tx_index == -1) {
             throw std::invalid_argument{"Unexpected transaction index in handle_eth_get_transaction_receipt"};
         }
-        reply = make_json_content(request["id"], receipts[tx_index]);
+        if (co_await core::is_block_finalized(block_with_hash.block.header.number, tx_database)) {
+            auto result = make_json_result(receipts[tx_index]);
+            write_json_content_serialized(stream, request["id"], result);
+            context_.reply_cache->insert(cache_key, std::move(result));
+        } else {
+            write_json_content(stream, request["id"], receipts[tx_index]);
+        }
     } catch (const std::invalid_argument& iv) {
         SILKRPC_DEBUG << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], {});
+        stream.write_json(make_json_content(request["id"], {}));
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        stream.write_json(make_json_error(request["id"], 100, e.what()));
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        stream.write_json(make_json_error(request["id"], 100, "unexpected exception"));
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
@@ -663,7 +702,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_estimate_gas(const nlohmann::js
     const auto call = params[0].get<Call>();
     SILKRPC_DEBUG << "call: " << call << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -676,7 +715,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_estimate_gas(const nlohmann::js
         const auto latest_block_with_hash = co_await core::read_block_by_number(*context_.block_cache, tx_database, latest_block_number);
         const auto latest_block = latest_block_with_hash.block;
 
-        EVMExecutor evm_executor{context_, tx_database, *chain_config_ptr, workers_, latest_block.header.number};
+        EVMExecutor evm_executor{context_, tx_database, *chain_config_ptr, workers_.pool_for("eth_estimateGas"), latest_block.header.number};
 
         ego::Executor executor = [&latest_block, &evm_executor](const silkworm::Transaction &transaction) {
             return evm_executor.call(latest_block, transaction);
@@ -728,7 +767,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_balance(const nlohmann::jso
     const auto block_id = params[1].get<std::string>();
     SILKRPC_DEBUG << "address: " << silkworm::to_hex(address) << " block_id: " << block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -763,7 +802,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_code(const nlohmann::json&
     const auto block_id = params[1].get<std::string>();
     SILKRPC_DEBUG << "address: " << silkworm::to_hex(address) << " block_id: " << block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -803,7 +842,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_transaction_count(const nlo
     const auto block_id = params[1].get<std::string>();
     SILKRPC_DEBUG << "address: " << silkworm::to_hex(address) << " block_id: " << block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -842,7 +881,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_storage_at(const nlohmann::
     const auto block_id = params[2].get<std::string>();
     SILKRPC_DEBUG << "address: " << silkworm::to_hex(address) << " block_id: " << block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -881,7 +920,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_call(const nlohmann::json& requ
     const auto block_id = params[1].get<std::string>();
     SILKRPC_DEBUG << "call: " << call << " block_id: " << block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -890,7 +929,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_call(const nlohmann::json& requ
         const auto chain_config_ptr = silkworm::lookup_chain_config(chain_id);
         const auto block_number = co_await core::get_block_number(block_id, tx_database);
 
-        EVMExecutor executor{context_, tx_database, *chain_config_ptr, workers_, block_number};
+        EVMExecutor executor{context_, tx_database, *chain_config_ptr, workers_.pool_for("eth_call"), block_number};
         const auto block_with_hash = co_await core::read_block_by_number(*context_.block_cache, tx_database, block_number);
         silkworm::Transaction txn{call.to_transaction()};
         const auto execution_result = co_await executor.call(block_with_hash.block, txn);
@@ -921,7 +960,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_call(const nlohmann::json& requ
 
 // https://eth.wiki/json-rpc/API#eth_newfilter
 asio::awaitable<void> EthereumRpcApi::handle_eth_new_filter(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -941,7 +980,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_new_filter(const nlohmann::json
 
 // https://eth.wiki/json-rpc/API#eth_newblockfilter
 asio::awaitable<void> EthereumRpcApi::handle_eth_new_block_filter(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -961,7 +1000,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_new_block_filter(const nlohmann
 
 // https://eth.wiki/json-rpc/API#eth_newpendingtransactionfilter
 asio::awaitable<void> EthereumRpcApi::handle_eth_new_pending_transaction_filter(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -981,7 +1020,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_new_pending_transaction_filter(
 
 // https://eth.wiki/json-rpc/API#eth_getfilterchanges
 asio::awaitable<void> EthereumRpcApi::handle_eth_get_filter_changes(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -1001,7 +1040,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_filter_changes(const nlohma
 
 // https://eth.wiki/json-rpc/API#eth_uninstallfilter
 asio::awaitable<void> EthereumRpcApi::handle_eth_uninstall_filter(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -1020,20 +1059,23 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_uninstall_filter(const nlohmann
 }
 
 // https://eth.wiki/json-rpc/API#eth_getlogs
-asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs(const nlohmann::json& request, nlohmann::json& reply) {
+asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs(const nlohmann::json& request, JsonStream& stream) {
     auto params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid eth_getLogs params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        stream.write_json(make_json_error(request["id"], 100, error_msg));
         co_return;
     }
     auto filter = params[0].get<Filter>();
     SILKRPC_DEBUG << "filter: " << filter << "\n";
 
-    std::vector<Log> logs;
+    // The logs are written block by block as soon as they are found, never collected all together
+    bool logs_opened{false};
+    std::size_t num_logs{0};
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
+    std::exception_ptr reply_aborted;
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -1044,7 +1086,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs(const nlohmann::json&
             if (!block_hash_bytes.has_value()) {
                 auto error_msg = "invalid eth_getLogs filter block_hash: " + filter.block_hash.value();
                 SILKRPC_ERROR << error_msg << "\n";
-                reply = make_json_error(request["id"], 100, error_msg);
+                stream.write_json(make_json_error(request["id"], 100, error_msg));
                 co_await tx->close(); // RAII not (yet) available with coroutines
                 co_return;
             }
@@ -1087,11 +1129,14 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs(const nlohmann::json&
         SILKRPC_TRACE << "block_numbers: " << block_numbers.toString() << "\n";
 
         if (block_numbers.cardinality() == 0) {
-            reply = make_json_content(request["id"], logs);
+            write_json_content(stream, request["id"], std::vector<Log>{});
             co_await tx->close(); // RAII not (yet) available with coroutines
             co_return;
         }
 
+        open_json_content(stream, request["id"]);
+        stream.open_array();
+        logs_opened = true;
         for (auto block_to_match : block_numbers) {
             uint64_t log_index{0};
 
@@ -1108,7 +1153,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs(const nlohmann::json&
                     log.index = log_index++;
                 }
                 SILKRPC_DEBUG << "chunck_logs.size(): " << chunck_logs.size() << "\n";
-                auto filtered_chunck_logs = filter_logs(chunck_logs, filter);
+                auto filtered_chunck_logs = core::filter_logs(chunck_logs, filter);
                 SILKRPC_DEBUG << "filtered_chunck_logs.size(): " << filtered_chunck_logs.size() << "\n";
                 if (filtered_chunck_logs.size() > 0) {
                     const auto tx_id = boost::endian::load_big_u32(&k[sizeof(uint64_t)]);
@@ -1130,25 +1175,52 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_get_logs(const nlohmann::json&
                     log.block_number = block_to_match;
                     log.block_hash = block_with_hash.hash;
                     log.tx_hash = silkworm::to_bytes32({tx_hash.bytes, silkworm::kHashLength});
+                    write_json(stream, log);
                 }
-                logs.insert(logs.end(), filtered_block_logs.begin(), filtered_block_logs.end());
+                num_logs += filtered_block_logs.size();
+                co_await stream.flush();
             }
         }
-        SILKRPC_INFO << "logs.size(): " << logs.size() << "\n";
+        SILKRPC_INFO << "num_logs: " << num_logs << "\n";
 
-        reply = make_json_content(request["id"], logs);
+        // Not cached: a reply shared across requests would have to be buffered whole, like the coalesced ones
+        stream.close_array();
+        close_json_content(stream);
     } catch (const std::invalid_argument& iv) {
         SILKRPC_DEBUG << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], logs);
+        if (stream.flushed()) {
+            reply_aborted = std::current_exception();
+        } else if (logs_opened) {
+            // Reply with the logs found so far
+            stream.close_array();
+            close_json_content(stream);
+        } else {
+            write_json_content(stream, request["id"], std::vector<Log>{});
+        }
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        if (stream.flushed()) {
+            reply_aborted = std::current_exception();
+        } else {
+            stream.clear();
+            stream.write_json(make_json_error(request["id"], 100, e.what()));
+        }
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        if (stream.flushed()) {
+            reply_aborted = std::current_exception();
+        } else {
+            stream.clear();
+            stream.write_json(make_json_error(request["id"], 100, "unexpected exception"));
+        }
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
+
+    // Part of the result has already been sent, so the reply must be aborted instead of completed with an error
+    if (reply_aborted) {
+        std::rethrow_exception(reply_aborted);
+    }
     co_return;
 }
 
@@ -1229,7 +1301,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_send_raw_transaction(const nloh
 
 // https://eth.wiki/json-rpc/API#eth_sendtransaction
 asio::awaitable<void> EthereumRpcApi::handle_eth_send_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -1249,7 +1321,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_send_transaction(const nlohmann
 
 // https://eth.wiki/json-rpc/API#eth_signtransaction
 asio::awaitable<void> EthereumRpcApi::handle_eth_sign_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -1269,7 +1341,7 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_sign_transaction(const nlohmann
 
 // https://eth.wiki/json-rpc/API#eth_getproof
 asio::awaitable<void> EthereumRpcApi::handle_eth_get_proof(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -1418,41 +1490,15 @@ asio::awaitable<void> EthereumRpcApi::handle_eth_submit_work(const nlohmann::jso
 
 // https://eth.wiki/json-rpc/API#eth_subscribe
 asio::awaitable<void> EthereumRpcApi::handle_eth_subscribe(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
-
-    try {
-        ethdb::TransactionDatabase tx_database{*tx};
-
-        reply = make_json_content(request["id"], to_quantity(0));
-    } catch (const std::exception& e) {
-        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
-    } catch (...) {
-        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
-    }
-
-    co_await tx->close(); // RAII not (yet) available with coroutines
+    // Subscriptions need a persistent connection, so they are served by the WebSocket transport only
+    reply = make_json_error(request["id"], -32601, "notifications not supported");
     co_return;
 }
 
 // https://eth.wiki/json-rpc/API#eth_unsubscribe
 asio::awaitable<void> EthereumRpcApi::handle_eth_unsubscribe(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
-
-    try {
-        ethdb::TransactionDatabase tx_database{*tx};
-
-        reply = make_json_content(request["id"], to_quantity(0));
-    } catch (const std::exception& e) {
-        SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
-    } catch (...) {
-        SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
-    }
-
-    co_await tx->close(); // RAII not (yet) available with coroutines
+    // Subscriptions need a persistent connection, so they are served by the WebSocket transport only
+    reply = make_json_error(request["id"], -32601, "notifications not supported");
     co_return;
 }
 
@@ -1495,50 +1541,4 @@ asio::awaitable<roaring::Roaring> EthereumRpcApi::get_addresses_bitmap(core::raw
     co_return result_bitmap;
 }
 
-std::vector<Log> EthereumRpcApi::filter_logs(std::vector<Log>& logs, const Filter& filter) {
-    std::vector<Log> filtered_logs;
-
-    auto addresses = filter.addresses;
-    auto topics = filter.topics;
-    SILKRPC_DEBUG << "filter.addresses: " << filter.addresses << "\n";
-    for (auto log : logs) {
-        SILKRPC_DEBUG << "log: " << log << "\n";
-        if (addresses.has_value() && std::find(addresses.value().begin(), addresses.value().end(), log.address) == addresses.value().end()) {
-            SILKRPC_DEBUG << "skipped log for address: 0x" << silkworm::to_hex(log.address) << "\n";
-            continue;
-        }
-        auto matches = true;
-        if (topics.has_value()) {
-            if (topics.value().size() > log.topics.size()) {
-                SILKRPC_DEBUG << "#topics: " << topics.value().size() << " #log.topics: " << log.topics.size() << "\n";
-                continue;
-            }
-            for (size_t i{0}; i < topics.value().size(); i++) {
-                SILKRPC_DEBUG << "log.topics[i]: " << log.topics[i] << "\n";
-                auto subtopics = topics.value()[i];
-                auto matches_subtopics = subtopics.empty(); // empty rule set == wildcard
-                SILKRPC_TRACE << "matches_subtopics: " << std::boolalpha << matches_subtopics << "\n";
-                for (auto topic : subtopics) {
-                    SILKRPC_DEBUG << "topic: " << topic << "\n";
-                    if (log.topics[i] == topic) {
-                        matches_subtopics = true;
-                        SILKRPC_TRACE << "matches_subtopics: " << matches_subtopics << "\n";
-                        break;
-                    }
-                }
-                if (!matches_subtopics) {
-                    SILKRPC_TRACE << "No subtopic matches\n";
-                    matches = false;
-                    break;
-                }
-            }
-        }
-        SILKRPC_DEBUG << "matches: " << matches << "\n";
-        if (matches) {
-            filtered_logs.push_back(log);
-        }
-    }
-    return filtered_logs;
-}
-
 } // namespace silkrpc::commands
@@ -23,7 +23,6 @@
 #include <silkrpc/config.hpp> // NOLINT(build/include_order)
 
 #include <asio/awaitable.hpp>
-#include <asio/thread_pool.hpp>
 #include <evmc/evmc.hpp>
 #include <nlohmann/json.hpp>
 
@@ -32,12 +31,14 @@
 #include <silkrpc/context_pool.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
 #include <silkrpc/croaring/roaring.hh>
+#include <silkrpc/json/stream.hpp>
 #include <silkrpc/json/types.hpp>
 #include <silkrpc/ethbackend/backend.hpp>
 #include <silkrpc/ethdb/database.hpp>
 #include <silkrpc/ethdb/transaction.hpp>
 #include <silkrpc/types/log.hpp>
 #include <silkrpc/types/receipt.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
 
 namespace silkrpc::http { class RequestHandler; }
 
@@ -45,7 +46,7 @@ namespace silkrpc::commands {
 
 class EthereumRpcApi {
 public:
-    explicit EthereumRpcApi(Context& context, asio::thread_pool& workers)
+    explicit EthereumRpcApi(Context& context, WorkerPools& workers)
     : context_(context), database_(context.database), backend_(context.backend), miner_{context.miner}, tx_pool_{context.tx_pool}, workers_{workers} {}
     virtual ~EthereumRpcApi() {}
 
@@ -58,8 +59,8 @@ protected:
     asio::awaitable<void> handle_eth_protocol_version(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_syncing(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_gas_price(const nlohmann::json& request, nlohmann::json& reply);
-    asio::awaitable<void> handle_eth_get_block_by_hash(const nlohmann::json& request, nlohmann::json& reply);
-    asio::awaitable<void> handle_eth_get_block_by_number(const nlohmann::json& request, nlohmann::json& reply);
+    asio::awaitable<void> handle_eth_get_block_by_hash(const nlohmann::json& request, JsonStream& stream);
+    asio::awaitable<void> handle_eth_get_block_by_number(const nlohmann::json& request, JsonStream& stream);
     asio::awaitable<void> handle_eth_get_block_transaction_count_by_hash(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_get_block_transaction_count_by_number(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_get_uncle_by_block_hash_and_index(const nlohmann::json& request, nlohmann::json& reply);
@@ -69,7 +70,7 @@ protected:
     asio::awaitable<void> handle_eth_get_transaction_by_hash(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_get_transaction_by_block_hash_and_index(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_get_transaction_by_block_number_and_index(const nlohmann::json& request, nlohmann::json& reply);
-    asio::awaitable<void> handle_eth_get_transaction_receipt(const nlohmann::json& request, nlohmann::json& reply);
+    asio::awaitable<void> handle_eth_get_transaction_receipt(const nlohmann::json& request, JsonStream& stream);
     asio::awaitable<void> handle_eth_estimate_gas(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_get_balance(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_get_code(const nlohmann::json& request, nlohmann::json& reply);
@@ -81,7 +82,7 @@ protected:
     asio::awaitable<void> handle_eth_new_pending_transaction_filter(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_get_filter_changes(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_uninstall_filter(const nlohmann::json& request, nlohmann::json& reply);
-    asio::awaitable<void> handle_eth_get_logs(const nlohmann::json& request, nlohmann::json& reply);
+    asio::awaitable<void> handle_eth_get_logs(const nlohmann::json& request, JsonStream& stream);
     asio::awaitable<void> handle_eth_send_raw_transaction(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_send_transaction(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<void> handle_eth_sign_transaction(const nlohmann::json& request, nlohmann::json& reply);
@@ -96,14 +97,13 @@ protected:
     asio::awaitable<void> handle_eth_unsubscribe(const nlohmann::json& request, nlohmann::json& reply);
     asio::awaitable<roaring::Roaring> get_topics_bitmap(core::rawdb::DatabaseReader& db_reader, FilterTopics& topics, uint64_t start, uint64_t end);
     asio::awaitable<roaring::Roaring> get_addresses_bitmap(core::rawdb::DatabaseReader& db_reader, FilterAddresses& addresses, uint64_t start, uint64_t end);
-    std::vector<Log> filter_logs(std::vector<Log>& logs, const Filter& filter);
 
     Context& context_;
     std::unique_ptr<ethdb::Database>& database_;
     std::unique_ptr<ethbackend::BackEnd>& backend_;
     std::unique_ptr<txpool::Miner>& miner_;
     std::unique_ptr<txpool::TransactionPool>& tx_pool_;
-    asio::thread_pool& workers_;
+    WorkerPools& workers_;
 
     friend class silkrpc::http::RequestHandler;
 };
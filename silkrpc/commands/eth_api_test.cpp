@@ -20,13 +20,13 @@
 #include <thread>
 
 #include <asio/co_spawn.hpp>
-#include <asio/thread_pool.hpp>
 #include <asio/use_future.hpp>
 #include <catch2/catch.hpp>
 #include <grpcpp/grpcpp.h>
 #include <nlohmann/json.hpp>
 
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
 #include <silkrpc/context_pool.hpp>
 #include <silkrpc/ethdb/cursor.hpp>
 #include <silkrpc/ethdb/database.hpp>
@@ -38,7 +38,7 @@ using Catch::Matchers::Message;
 
 class EthereumRpcApiTest : public commands::EthereumRpcApi {
 public:
-    explicit EthereumRpcApiTest(Context& context, asio::thread_pool& workers) : commands::EthereumRpcApi{context, workers} {}
+    explicit EthereumRpcApiTest(Context& context, commands::WorkerPools& workers) : commands::EthereumRpcApi{context, workers} {}
 
     using commands::EthereumRpcApi::handle_eth_block_number;
     using commands::EthereumRpcApi::handle_eth_send_raw_transaction;
@@ -50,7 +50,7 @@ void test_eth_api(HandleTestMethod test_handle_method, const nlohmann::json& req
     SILKRPC_LOG_VERBOSITY(LogLevel::None);
     ContextPool cp{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
     auto context_pool_thread = std::thread([&]() { cp.run(); });
-    asio::thread_pool workers{1};
+    commands::WorkerPools workers{1};
     try {
         EthereumRpcApiTest eth_api{cp.get_context(), workers};
         auto result{asio::co_spawn(cp.get_io_context(), [&]() {
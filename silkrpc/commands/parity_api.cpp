@@ -17,6 +17,7 @@
 #include "parity_api.hpp"
 
 #include <string>
+#include <utility>
 
 #include <silkworm/common/util.hpp>
 
@@ -34,18 +35,24 @@
 namespace silkrpc::commands {
 
 // https://eth.wiki/json-rpc/API#parity_getblockreceipts
-asio::awaitable<void> ParityRpcApi::handle_parity_get_block_receipts(const nlohmann::json& request, nlohmann::json& reply) {
+asio::awaitable<void> ParityRpcApi::handle_parity_get_block_receipts(const nlohmann::json& request, JsonStream& stream) {
     auto params = request["params"];
     if (params.size() != 1) {
         auto error_msg = "invalid parity_getBlockReceipts params: " + params.dump();
         SILKRPC_ERROR << error_msg << "\n";
-        reply = make_json_error(request["id"], 100, error_msg);
+        stream.write_json(make_json_error(request["id"], 100, error_msg));
         co_return;
     }
     const auto block_id = params[0].get<std::string>();
     SILKRPC_DEBUG << "block_id: " << block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    const auto cache_key = ReplyCache::make_key(request);
+    if (const auto result = reply_cache_->get(cache_key)) {
+        write_json_content_serialized(stream, request["id"], *result);
+        co_return;
+    }
+
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -61,16 +68,22 @@ asio::awaitable<void> ParityRpcApi::handle_parity_get_block_receipts(const nlohm
             receipts[i].effective_gas_price = block.transactions[i].effective_gas_price(block.header.base_fee_per_gas.value_or(0));
         }
 
-        reply = make_json_content(request["id"], receipts);
+        if (co_await core::is_block_finalized(block_number, tx_database)) {
+            auto result = make_json_result(receipts);
+            write_json_content_serialized(stream, request["id"], result);
+            reply_cache_->insert(cache_key, std::move(result));
+        } else {
+            write_json_content(stream, request["id"], receipts);
+        }
     } catch (const std::invalid_argument& iv) {
         SILKRPC_DEBUG << "invalid_argument: " << iv.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_content(request["id"], {});
+        stream.write_json(make_json_content(request["id"], {}));
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << " processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, e.what());
+        stream.write_json(make_json_error(request["id"], 100, e.what()));
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception processing request: " << request.dump() << "\n";
-        reply = make_json_error(request["id"], 100, "unexpected exception");
+        stream.write_json(make_json_error(request["id"], 100, "unexpected exception"));
     }
 
     co_await tx->close(); // RAII not (yet) available with coroutines
@@ -24,7 +24,10 @@
 #include <asio/awaitable.hpp>
 #include <nlohmann/json.hpp>
 
+#include <silkrpc/common/reply_cache.hpp>
+#include <silkrpc/context_pool.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
+#include <silkrpc/json/stream.hpp>
 #include <silkrpc/json/types.hpp>
 #include <silkrpc/ethdb/database.hpp>
 
@@ -34,17 +37,18 @@ namespace silkrpc::commands {
 
 class ParityRpcApi {
 public:
-    explicit ParityRpcApi(std::unique_ptr<ethdb::Database>& database) : database_(database) {}
+    explicit ParityRpcApi(Context& context) : database_(context.database), reply_cache_(context.reply_cache) {}
     virtual ~ParityRpcApi() {}
 
     ParityRpcApi(const ParityRpcApi&) = delete;
     ParityRpcApi& operator=(const ParityRpcApi&) = delete;
 
 protected:
-    asio::awaitable<void> handle_parity_get_block_receipts(const nlohmann::json& request, nlohmann::json& reply);
+    asio::awaitable<void> handle_parity_get_block_receipts(const nlohmann::json& request, JsonStream& stream);
 
 private:
     std::unique_ptr<ethdb::Database>& database_;
+    std::shared_ptr<ReplyCache>& reply_cache_;
 
     friend class silkrpc::http::RequestHandler;
 };
@@ -19,8 +19,6 @@
 
 #include <memory>
 
-#include <asio/thread_pool.hpp>
-
 #include <silkrpc/commands/eth_api.hpp>
 #include <silkrpc/commands/debug_api.hpp>
 #include <silkrpc/commands/net_api.hpp>
@@ -29,6 +27,7 @@
 #include <silkrpc/commands/trace_api.hpp>
 #include <silkrpc/commands/web3_api.hpp>
 #include <silkrpc/commands/engine_api.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
 
 namespace silkrpc::http { class RequestHandler; }
 
@@ -38,9 +37,9 @@ class RpcApiTable;
 
 class RpcApi : protected EthereumRpcApi, NetRpcApi, Web3RpcApi, DebugRpcApi, ParityRpcApi, TurboGethRpcApi, TraceRpcApi, EngineRpcApi {
 public:
-    explicit RpcApi(Context& context, asio::thread_pool& workers) :
+    explicit RpcApi(Context& context, WorkerPools& workers) :
         EthereumRpcApi{context, workers}, NetRpcApi{context.backend}, Web3RpcApi{context}, DebugRpcApi{context.database},
-        ParityRpcApi{context.database}, TurboGethRpcApi{context.database}, TraceRpcApi{context.database},
+        ParityRpcApi{context}, TurboGethRpcApi{context.database}, TraceRpcApi{context.database},
         EngineRpcApi(context.backend) {}
     virtual ~RpcApi() {}
 
@@ -36,6 +36,14 @@ std::optional<RpcApiTable::HandleMethod> RpcApiTable::find_handler(const std::st
     return handle_method_pair->second;
 }
 
+std::optional<RpcApiTable::HandleStream> RpcApiTable::find_stream_handler(const std::string& method) const {
+    const auto handle_stream_pair = stream_handlers_.find(method);
+    if (handle_stream_pair == stream_handlers_.end()) {
+        return std::nullopt;
+    }
+    return handle_stream_pair->second;
+}
+
 void RpcApiTable::build_handlers(const std::string& api_spec) {
     auto start = 0u;
     auto end = api_spec.find(kApiSpecSeparator);
@@ -70,7 +78,7 @@ void RpcApiTable::add_handlers(const std::string& api_namespace) {
 }
 
 void RpcApiTable::add_debug_handlers() {
-    handlers_[http::method::k_debug_accountRange] = &commands::RpcApi::handle_debug_account_range;
+    stream_handlers_[http::method::k_debug_accountRange] = &commands::RpcApi::handle_debug_account_range;
     handlers_[http::method::k_debug_getModifiedAccountsByNumber] = &commands::RpcApi::handle_debug_get_modified_accounts_by_number;
     handlers_[http::method::k_debug_getModifiedAccountsByHash] = &commands::RpcApi::handle_debug_get_modified_accounts_by_hash;
     handlers_[http::method::k_debug_storageRangeAt] = &commands::RpcApi::handle_debug_storage_range_at;
@@ -84,8 +92,8 @@ void RpcApiTable::add_eth_handlers() {
     handlers_[http::method::k_eth_protocolVersion] = &commands::RpcApi::handle_eth_protocol_version;
     handlers_[http::method::k_eth_syncing] = &commands::RpcApi::handle_eth_syncing;
     handlers_[http::method::k_eth_gasPrice] = &commands::RpcApi::handle_eth_gas_price;
-    handlers_[http::method::k_eth_getBlockByHash] = &commands::RpcApi::handle_eth_get_block_by_hash;
-    handlers_[http::method::k_eth_getBlockByNumber] = &commands::RpcApi::handle_eth_get_block_by_number;
+    stream_handlers_[http::method::k_eth_getBlockByHash] = &commands::RpcApi::handle_eth_get_block_by_hash;
+    stream_handlers_[http::method::k_eth_getBlockByNumber] = &commands::RpcApi::handle_eth_get_block_by_number;
     handlers_[http::method::k_eth_getBlockTransactionCountByHash] = &commands::RpcApi::handle_eth_get_block_transaction_count_by_hash;
     handlers_[http::method::k_eth_getBlockTransactionCountByNumber] = &commands::RpcApi::handle_eth_get_block_transaction_count_by_number;
     handlers_[http::method::k_eth_getUncleByBlockHashAndIndex] = &commands::RpcApi::handle_eth_get_uncle_by_block_hash_and_index;
@@ -95,7 +103,7 @@ void RpcApiTable::add_eth_handlers() {
     handlers_[http::method::k_eth_getTransactionByHash] = &commands::RpcApi::handle_eth_get_transaction_by_hash;
     handlers_[http::method::k_eth_getTransactionByBlockHashAndIndex] = &commands::RpcApi::handle_eth_get_transaction_by_block_hash_and_index;
     handlers_[http::method::k_eth_getTransactionByBlockNumberAndIndex] = &commands::RpcApi::handle_eth_get_transaction_by_block_number_and_index;
-    handlers_[http::method::k_eth_getTransactionReceipt] = &commands::RpcApi::handle_eth_get_transaction_receipt;
+    stream_handlers_[http::method::k_eth_getTransactionReceipt] = &commands::RpcApi::handle_eth_get_transaction_receipt;
     handlers_[http::method::k_eth_estimateGas] = &commands::RpcApi::handle_eth_estimate_gas;
     handlers_[http::method::k_eth_getBalance] = &commands::RpcApi::handle_eth_get_balance;
     handlers_[http::method::k_eth_getCode] = &commands::RpcApi::handle_eth_get_code;
@@ -107,7 +115,7 @@ void RpcApiTable::add_eth_handlers() {
     handlers_[http::method::k_eth_newPendingTransactionFilter] = &commands::RpcApi::handle_eth_new_pending_transaction_filter;
     handlers_[http::method::k_eth_getFilterChanges] = &commands::RpcApi::handle_eth_get_filter_changes;
     handlers_[http::method::k_eth_uninstallFilter] = &commands::RpcApi::handle_eth_uninstall_filter;
-    handlers_[http::method::k_eth_getLogs] = &commands::RpcApi::handle_eth_get_logs;
+    stream_handlers_[http::method::k_eth_getLogs] = &commands::RpcApi::handle_eth_get_logs;
     handlers_[http::method::k_eth_sendRawTransaction] = &commands::RpcApi::handle_eth_send_raw_transaction;
     handlers_[http::method::k_eth_sendTransaction] = &commands::RpcApi::handle_eth_send_transaction;
     handlers_[http::method::k_eth_signTransaction] = &commands::RpcApi::handle_eth_sign_transaction;
@@ -120,7 +128,7 @@ void RpcApiTable::add_eth_handlers() {
     handlers_[http::method::k_eth_submitWork] = &commands::RpcApi::handle_eth_submit_work;
     handlers_[http::method::k_eth_subscribe] = &commands::RpcApi::handle_eth_subscribe;
     handlers_[http::method::k_eth_unsubscribe] = &commands::RpcApi::handle_eth_unsubscribe;
-    handlers_[http::method::k_eth_getBlockReceipts] = &commands::RpcApi::handle_parity_get_block_receipts;
+    stream_handlers_[http::method::k_eth_getBlockReceipts] = &commands::RpcApi::handle_parity_get_block_receipts;
 }
 
 void RpcApiTable::add_net_handlers() {
@@ -130,7 +138,7 @@ void RpcApiTable::add_net_handlers() {
 }
 
 void RpcApiTable::add_parity_handlers() {
-    handlers_[http::method::k_parity_getBlockReceipts] = &commands::RpcApi::handle_parity_get_block_receipts;
+    stream_handlers_[http::method::k_parity_getBlockReceipts] = &commands::RpcApi::handle_parity_get_block_receipts;
 }
 
 void RpcApiTable::add_tg_handlers() {
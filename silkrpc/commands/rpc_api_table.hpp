@@ -27,12 +27,14 @@
 #include <nlohmann/json.hpp>
 
 #include <silkrpc/commands/rpc_api.hpp>
+#include <silkrpc/json/stream.hpp>
 
 namespace silkrpc::commands {
 
 class RpcApiTable {
 public:
     typedef asio::awaitable<void> (RpcApi::*HandleMethod)(const nlohmann::json&, nlohmann::json&);
+    typedef asio::awaitable<void> (RpcApi::*HandleStream)(const nlohmann::json&, JsonStream&);
 
     explicit RpcApiTable(const std::string& api_spec);
 
@@ -40,6 +42,7 @@ public:
     RpcApiTable& operator=(const RpcApiTable&) = delete;
 
     std::optional<HandleMethod> find_handler(const std::string& method) const;
+    std::optional<HandleStream> find_stream_handler(const std::string& method) const;
 
 private:
     void build_handlers(const std::string& api_spec);
@@ -54,6 +57,7 @@ private:
     void add_engine_handlers();
 
     std::map<std::string, HandleMethod> handlers_;
+    std::map<std::string, HandleStream> stream_handlers_;
 };
 
 } // namespace silkrpc::commands
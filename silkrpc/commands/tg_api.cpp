@@ -46,7 +46,7 @@ asio::awaitable<void> TurboGethRpcApi::handle_tg_get_header_by_hash(const nlohma
     const auto block_hash = params[0].get<evmc::bytes32>();
     SILKRPC_DEBUG << "block_hash: " << block_hash << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -86,7 +86,7 @@ asio::awaitable<void> TurboGethRpcApi::handle_tg_get_header_by_number(const nloh
         co_return;
     }
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -119,7 +119,7 @@ asio::awaitable<void> TurboGethRpcApi::handle_tg_get_logs_by_hash(const nlohmann
     const auto block_hash = params[0].get<evmc::bytes32>();
     SILKRPC_DEBUG << "block_hash: " << block_hash << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -151,7 +151,7 @@ asio::awaitable<void> TurboGethRpcApi::handle_tg_get_logs_by_hash(const nlohmann
 
 // https://eth.wiki/json-rpc/API#tg_forks
 asio::awaitable<void> TurboGethRpcApi::handle_tg_forks(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -186,7 +186,7 @@ asio::awaitable<void> TurboGethRpcApi::handle_tg_issuance(const nlohmann::json&
     const auto block_id = params[0].get<std::string>();
     SILKRPC_DEBUG << "block_id: " << block_id << "\n";
 
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -30,7 +30,7 @@ namespace silkrpc::commands {
 
 // https://eth.wiki/json-rpc/API#trace_call
 asio::awaitable<void> TraceRpcApi::handle_trace_call(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -50,7 +50,7 @@ asio::awaitable<void> TraceRpcApi::handle_trace_call(const nlohmann::json& reque
 
 // https://eth.wiki/json-rpc/API#trace_callmany
 asio::awaitable<void> TraceRpcApi::handle_trace_call_many(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -70,7 +70,7 @@ asio::awaitable<void> TraceRpcApi::handle_trace_call_many(const nlohmann::json&
 
 // https://eth.wiki/json-rpc/API#trace_rawtransaction
 asio::awaitable<void> TraceRpcApi::handle_trace_raw_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -90,7 +90,7 @@ asio::awaitable<void> TraceRpcApi::handle_trace_raw_transaction(const nlohmann::
 
 // https://eth.wiki/json-rpc/API#trace_replayblocktransactions
 asio::awaitable<void> TraceRpcApi::handle_trace_replay_block_transactions(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -110,7 +110,7 @@ asio::awaitable<void> TraceRpcApi::handle_trace_replay_block_transactions(const
 
 // https://eth.wiki/json-rpc/API#trace_replaytransaction
 asio::awaitable<void> TraceRpcApi::handle_trace_replay_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -130,7 +130,7 @@ asio::awaitable<void> TraceRpcApi::handle_trace_replay_transaction(const nlohman
 
 // https://eth.wiki/json-rpc/API#trace_block
 asio::awaitable<void> TraceRpcApi::handle_trace_block(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -150,7 +150,7 @@ asio::awaitable<void> TraceRpcApi::handle_trace_block(const nlohmann::json& requ
 
 // https://eth.wiki/json-rpc/API#trace_filter
 asio::awaitable<void> TraceRpcApi::handle_trace_filter(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -170,7 +170,7 @@ asio::awaitable<void> TraceRpcApi::handle_trace_filter(const nlohmann::json& req
 
 // https://eth.wiki/json-rpc/API#trace_get
 asio::awaitable<void> TraceRpcApi::handle_trace_get(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -190,7 +190,7 @@ asio::awaitable<void> TraceRpcApi::handle_trace_get(const nlohmann::json& reques
 
 // https://eth.wiki/json-rpc/API#trace_transaction
 asio::awaitable<void> TraceRpcApi::handle_trace_transaction(const nlohmann::json& request, nlohmann::json& reply) {
-    auto tx = co_await database_->begin();
+    auto tx = co_await database_->begin_pooled();
 
     try {
         ethdb::TransactionDatabase tx_database{*tx};
@@ -0,0 +1,149 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "worker_pools.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::commands {
+
+namespace {
+
+std::vector<std::string> split(const std::string& value, char separator) {
+    std::vector<std::string> tokens;
+    std::size_t start{0};
+    while (true) {
+        const auto end = value.find(separator, start);
+        tokens.push_back(value.substr(start, end - start));
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+    return tokens;
+}
+
+std::size_t parse_size(const std::string& value, const std::string& pool) {
+    if (value.empty() || !std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        throw std::invalid_argument{"invalid worker pool: " + pool};
+    }
+    return std::stoul(value);
+}
+
+// Parse either a fixed thread count or a <min>-<max> range
+std::pair<std::size_t, std::size_t> parse_threads(const std::string& value, const std::string& pool) {
+    const auto dash = value.find('-');
+    const auto min_threads = parse_size(value.substr(0, dash), pool);
+    const auto max_threads = dash == std::string::npos ? min_threads : parse_size(value.substr(dash + 1), pool);
+    if (min_threads == 0 || max_threads < min_threads) {
+        throw std::invalid_argument{"invalid worker pool: " + pool};
+    }
+    return {min_threads, max_threads};
+}
+
+} // namespace
+
+WorkerPools::WorkerPools(std::size_t min_default_threads, std::size_t max_default_threads, const std::string& pools_spec,
+    const std::string& routes_spec, const std::vector<std::size_t>& cpus) {
+    auto default_pool = std::make_unique<WorkerPool>(kDefaultPoolName, min_default_threads, max_default_threads,
+        std::numeric_limits<std::size_t>::max(), cpus);
+    default_pool_ = default_pool.get();
+    pools_.emplace(kDefaultPoolName, std::move(default_pool));
+
+    if (!pools_spec.empty()) {
+        for (const auto& pool : split(pools_spec, ',')) {
+            const auto fields = split(pool, ':');
+            if (fields.size() < 2 || fields.size() > 3 || fields[0].empty()) {
+                throw std::invalid_argument{"invalid worker pool: " + pool};
+            }
+            const auto [min_threads, max_threads] = parse_threads(fields[1], pool);
+            const auto max_queued = fields.size() == 3 ? parse_size(fields[2], pool) : max_threads;
+            if (pools_.contains(fields[0])) {
+                throw std::invalid_argument{"duplicated worker pool: " + fields[0]};
+            }
+            pools_.emplace(fields[0], std::make_unique<WorkerPool>(fields[0], min_threads, max_threads, max_queued, cpus));
+            SILKRPC_INFO << "WorkerPool " << fields[0] << " threads: " << min_threads << "-" << max_threads << " max queued: " << max_queued << "\n";
+        }
+    }
+
+    if (!routes_spec.empty()) {
+        for (const auto& route : split(routes_spec, ',')) {
+            const auto fields = split(route, ':');
+            if (fields.size() != 2 || fields[0].empty()) {
+                throw std::invalid_argument{"invalid worker pool route: " + route};
+            }
+            const auto it = pools_.find(fields[1]);
+            if (it == pools_.end()) {
+                throw std::invalid_argument{"unknown worker pool: " + fields[1]};
+            }
+            if (!routes_.emplace(fields[0], it->second.get()).second) {
+                throw std::invalid_argument{"duplicated worker pool route: " + fields[0]};
+            }
+        }
+    }
+
+    metrics_collector_id_ = Metrics::add_collector([this](std::vector<MetricSample>& samples) { collect_metrics(samples); });
+}
+
+WorkerPools::~WorkerPools() {
+    Metrics::remove_collector(metrics_collector_id_);
+}
+
+WorkerPool* WorkerPools::find_routed_pool(const std::string& method) const {
+    const auto method_it = routes_.find(method);
+    if (method_it != routes_.end()) {
+        return method_it->second;
+    }
+    const auto api_namespace = method.substr(0, method.find('_'));
+    const auto namespace_it = api_namespace != method ? routes_.find(api_namespace) : routes_.end();
+    return namespace_it != routes_.end() ? namespace_it->second : nullptr;
+}
+
+WorkerPool& WorkerPools::pool_for(const std::string& method) {
+    const auto pool = find_routed_pool(method);
+    return pool ? *pool : *default_pool_;
+}
+
+void WorkerPools::for_each_pool(const std::function<void(WorkerPool&)>& visitor) {
+    for (auto& [_, pool] : pools_) {
+        visitor(*pool);
+    }
+}
+
+void WorkerPools::collect_metrics(std::vector<MetricSample>& samples) const {
+    for (const auto& [name, pool] : pools_) {
+        const auto labels = "pool=\"" + name + "\"";
+        samples.push_back({"silkrpc_worker_pool_threads", "gauge", "Number of threads in the worker pool", labels,
+                           static_cast<double>(pool->num_threads())});
+        samples.push_back({"silkrpc_worker_pool_queue_wait_seconds", "gauge", "Moving average of the time tasks wait to start in the worker pool",
+                           labels, std::chrono::duration<double>(pool->queue_wait()).count()});
+        samples.push_back({"silkrpc_worker_pool_blocked_ratio", "gauge", "Fraction of worker pool threads blocked on remote reads", labels,
+                           pool->blocked_ratio()});
+        samples.push_back({"silkrpc_worker_pool_pending", "gauge", "Number of requests running or queued in the worker pool", labels,
+                           static_cast<double>(pool->pending())});
+        samples.push_back({"silkrpc_worker_pool_rejected_total", "counter", "Number of requests rejected by the worker pool", labels,
+                           static_cast<double>(pool->rejected())});
+    }
+}
+
+} // namespace silkrpc::commands
@@ -0,0 +1,78 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMANDS_WORKER_POOLS_HPP_
+#define SILKRPC_COMMANDS_WORKER_POOLS_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <silkrpc/common/metrics.hpp>
+#include <silkrpc/common/worker_pool.hpp>
+
+namespace silkrpc::commands {
+
+// The worker pools used by the API handlers: the default pool, whose queue is unbounded, plus the named pools listed as
+// comma-separated <name>:<threads>[:<max queued>], where threads is either a fixed count or an adaptive range <min>-<max>
+// and max queued defaults to the max threads. Methods are routed to a pool by comma-separated <name>:<pool>, where name
+// is either a method (e.g. eth_estimateGas) or a namespace (e.g. debug); the method route wins over the namespace one
+// and any other method runs on the default pool. All the threads are pinned to the same CPUs, if any.
+class WorkerPools {
+public:
+    static constexpr const char* kDefaultPoolName{"default"};
+
+    // Build the pools and routes from their specification, throw std::invalid_argument if not valid
+    WorkerPools(std::size_t min_default_threads, std::size_t max_default_threads, const std::string& pools_spec = "",
+        const std::string& routes_spec = "", const std::vector<std::size_t>& cpus = {});
+    ~WorkerPools();
+
+    WorkerPools(const WorkerPools&) = delete;
+    WorkerPools& operator=(const WorkerPools&) = delete;
+
+    WorkerPool& default_pool() { return *default_pool_; }
+
+    // The pool routed by the method or its namespace, if any
+    WorkerPool* find_routed_pool(const std::string& method) const;
+
+    // The pool running the tasks of the method, the default one if not routed
+    WorkerPool& pool_for(const std::string& method);
+
+    // Visit all the pools, e.g. to observe their size
+    void for_each_pool(const std::function<void(WorkerPool&)>& visitor);
+
+private:
+    // Add the samples of pool size, queue wait, blocked threads, pending and rejected requests, labelled by pool
+    void collect_metrics(std::vector<MetricSample>& samples) const;
+
+    // Pools and routes are created at startup and never changed, so lookups need no lock
+    std::map<std::string, std::unique_ptr<WorkerPool>> pools_;
+    std::map<std::string, WorkerPool*> routes_;
+    WorkerPool* default_pool_;
+
+    // The identifier of the metrics collector registered by the pools
+    std::size_t metrics_collector_id_;
+};
+
+} // namespace silkrpc::commands
+
+#endif  // SILKRPC_COMMANDS_WORKER_POOLS_HPP_
@@ -0,0 +1,96 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "worker_pools.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc::commands {
+
+TEST_CASE("worker pools specs", "[silkrpc][commands][worker_pools]") {
+    SECTION("valid specs") {
+        CHECK_NOTHROW(WorkerPools(1, 1));
+        CHECK_NOTHROW(WorkerPools(1, 4));
+        CHECK_NOTHROW(WorkerPools(1, 1, "evm:4", "eth_call:evm"));
+        CHECK_NOTHROW(WorkerPools(1, 1, "evm:4:0,debug:2:16", "eth_call:evm,eth_estimateGas:evm,debug:debug,debug_traceCall:default"));
+        CHECK_NOTHROW(WorkerPools(1, 1, "evm:2-8:16", "eth_call:evm"));
+    }
+
+    SECTION("invalid specs") {
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:0"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:x"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:1:2:3"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:0-2"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:4-2"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:1-"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, ":1"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:1,evm:2"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "default:2"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:1,"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:1", "eth_call"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:1", "eth_call:vm"), std::invalid_argument);
+        CHECK_THROWS_AS(WorkerPools(1, 1, "evm:1", "eth_call:evm,eth_call:default"), std::invalid_argument);
+    }
+
+    SECTION("visit pools") {
+        WorkerPools pools{2, 4, "evm:4:8,debug:1-3"};
+        std::vector<std::string> names;
+        std::size_t num_threads{0};
+        std::size_t max_threads{0};
+        pools.for_each_pool([&](WorkerPool& pool) {
+            names.push_back(pool.name());
+            num_threads += pool.num_threads();
+            max_threads += pool.max_threads();
+        });
+        CHECK(names == std::vector<std::string>{"debug", "default", "evm"});
+        CHECK(num_threads == 7);
+        CHECK(max_threads == 11);
+    }
+}
+
+TEST_CASE("worker pools routes", "[silkrpc][commands][worker_pools]") {
+    WorkerPools pools{1, 1, "evm:2,debug:1", "eth_estimateGas:evm,eth_call:evm,debug:debug,debug_traceCall:evm"};
+
+    SECTION("method route") {
+        REQUIRE(pools.find_routed_pool("eth_call"));
+        CHECK(pools.find_routed_pool("eth_call")->name() == "evm");
+        CHECK(&pools.pool_for("eth_estimateGas") == pools.find_routed_pool("eth_call"));
+    }
+
+    SECTION("namespace route") {
+        REQUIRE(pools.find_routed_pool("debug_traceTransaction"));
+        CHECK(pools.find_routed_pool("debug_traceTransaction")->name() == "debug");
+    }
+
+    SECTION("method route wins over namespace route") {
+        REQUIRE(pools.find_routed_pool("debug_traceCall"));
+        CHECK(pools.find_routed_pool("debug_traceCall")->name() == "evm");
+    }
+
+    SECTION("not routed") {
+        CHECK(!pools.find_routed_pool("eth_getLogs"));
+        CHECK(!pools.find_routed_pool("engine_newPayloadV1"));
+        CHECK(&pools.pool_for("eth_getLogs") == &pools.default_pool());
+    }
+}
+
+} // namespace silkrpc::commands
@@ -0,0 +1,106 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "affinity.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+std::size_t parse_cpu(std::string_view text, const std::string& cpu_list) {
+    std::size_t cpu{0};
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), cpu);
+    if (text.empty() || ec != std::errc{} || end != text.data() + text.size()) {
+        throw std::invalid_argument{"invalid CPU list: " + cpu_list};
+    }
+    return cpu;
+}
+
+} // namespace
+
+std::vector<std::size_t> parse_cpu_list(const std::string& cpu_list) {
+    std::vector<std::size_t> cpus;
+    std::string_view remaining{cpu_list};
+    while (!remaining.empty()) {
+        const auto comma = remaining.find(',');
+        const auto item = remaining.substr(0, comma);
+        const auto dash = item.find('-');
+        const auto first = parse_cpu(item.substr(0, dash), cpu_list);
+        const auto last = dash == std::string_view::npos ? first : parse_cpu(item.substr(dash + 1), cpu_list);
+        if (last < first) {
+            throw std::invalid_argument{"invalid CPU list: " + cpu_list};
+        }
+        for (auto cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+        remaining = comma == std::string_view::npos ? std::string_view{} : remaining.substr(comma + 1);
+        if (comma != std::string_view::npos && remaining.empty()) {
+            throw std::invalid_argument{"invalid CPU list: " + cpu_list};
+        }
+    }
+    return cpus;
+}
+
+std::vector<std::size_t> partition_cpus(const std::vector<std::size_t>& cpus, std::size_t num_parts, std::size_t index) {
+    if (cpus.empty() || num_parts == 0) {
+        return {};
+    }
+    if (cpus.size() < num_parts) {
+        return {cpus[index % cpus.size()]};
+    }
+    const auto part = index % num_parts;
+    const auto begin = cpus.begin() + static_cast<std::ptrdiff_t>(part * cpus.size() / num_parts);
+    const auto end = cpus.begin() + static_cast<std::ptrdiff_t>((part + 1) * cpus.size() / num_parts);
+    return {begin, end};
+}
+
+bool pin_current_thread(const std::vector<std::size_t>& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    const auto result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (result != 0) {
+        SILKRPC_WARN << "pin_current_thread failed error: " << result << "\n";
+    }
+    return result == 0;
+#else
+    SILKRPC_WARN << "pin_current_thread not supported on this platform\n";
+    return false;
+#endif
+}
+
+} // namespace silkrpc
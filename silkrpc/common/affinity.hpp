@@ -0,0 +1,40 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_AFFINITY_HPP_
+#define SILKRPC_COMMON_AFFINITY_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace silkrpc {
+
+// Parse a list of CPUs such as 0-3,8,10-11 (the format of /sys/devices/system/cpu/online), throw std::invalid_argument if not valid
+std::vector<std::size_t> parse_cpu_list(const std::string& cpu_list);
+
+// Split the CPUs in num_parts groups of consecutive ones as even as possible and return the group at index.
+// Groups are never empty, so single CPUs are shared round-robin if the CPUs are less than the parts
+std::vector<std::size_t> partition_cpus(const std::vector<std::size_t>& cpus, std::size_t num_parts, std::size_t index);
+
+// Pin the calling thread to the given CPUs, return false if not supported or not possible. Nothing is done if no CPU is given.
+// On Linux memory is allocated on the NUMA node of the thread first touching it, so pinned threads also get local memory
+bool pin_current_thread(const std::vector<std::size_t>& cpus);
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_COMMON_AFFINITY_HPP_
@@ -0,0 +1,51 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "affinity.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("parse CPU list", "[silkrpc][common][affinity]") {
+    CHECK(parse_cpu_list("").empty());
+    CHECK(parse_cpu_list("3") == std::vector<std::size_t>{3});
+    CHECK(parse_cpu_list("0-3,8,10-11") == std::vector<std::size_t>{0, 1, 2, 3, 8, 10, 11});
+    CHECK_THROWS_AS(parse_cpu_list("a"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_cpu_list("3-1"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_cpu_list("1,"), std::invalid_argument);
+    CHECK_THROWS_AS(parse_cpu_list("1-"), std::invalid_argument);
+}
+
+TEST_CASE("partition CPUs", "[silkrpc][common][affinity]") {
+    const std::vector<std::size_t> cpus{0, 1, 2, 3, 4, 5};
+    CHECK(partition_cpus({}, 2, 0).empty());
+    CHECK(partition_cpus(cpus, 2, 0) == std::vector<std::size_t>{0, 1, 2});
+    CHECK(partition_cpus(cpus, 2, 1) == std::vector<std::size_t>{3, 4, 5});
+    CHECK(partition_cpus(cpus, 4, 0) == std::vector<std::size_t>{0});
+    CHECK(partition_cpus(cpus, 4, 3) == std::vector<std::size_t>{4, 5});
+    CHECK(partition_cpus(cpus, 8, 7) == std::vector<std::size_t>{1});
+}
+
+TEST_CASE("pin current thread", "[silkrpc][common][affinity]") {
+    CHECK(pin_current_thread({}));
+}
+
+} // namespace silkrpc
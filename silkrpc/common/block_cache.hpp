@@ -17,6 +17,8 @@
 #ifndef SILKRPC_COMMON_BLOCK_CACHE_HPP_
 #define SILKRPC_COMMON_BLOCK_CACHE_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
 
 #include <evmc/evmc.hpp>
@@ -39,9 +41,9 @@ public:
     boost::optional <silkworm::BlockWithHash> get(const evmc::bytes32& key) {
         if (shared_cache_) {
             const std::lock_guard<std::mutex> lock(access_);
-            return block_cache_.get(key);
+            return count(block_cache_.get(key));
         }
-        return block_cache_.get(key);
+        return count(block_cache_.get(key));
     }
 
     void insert(const evmc::bytes32 &key, const silkworm::BlockWithHash& block) {
@@ -52,10 +54,20 @@ public:
         block_cache_.insert(key, block);
     }
 
+    uint64_t num_hits() const { return num_hits_.load(std::memory_order_relaxed); }
+    uint64_t num_misses() const { return num_misses_.load(std::memory_order_relaxed); }
+
 private:
+    boost::optional<silkworm::BlockWithHash> count(boost::optional<silkworm::BlockWithHash> block) {
+        (block ? num_hits_ : num_misses_).fetch_add(1, std::memory_order_relaxed);
+        return block;
+    }
+
     mutable std::mutex access_;
     boost::compute::detail::lru_cache<evmc::bytes32, silkworm::BlockWithHash> block_cache_;
     bool shared_cache_;
+    std::atomic<uint64_t> num_hits_{0};
+    std::atomic<uint64_t> num_misses_{0};
 };
 
 } // namespace silkrpc
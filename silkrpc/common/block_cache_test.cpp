@@ -62,6 +62,8 @@ TEST_CASE("insert entry in cache(no-lock)", "[silkrpc][commands][block_cache]")
 
     ret_block_option = block_cache.get(bh1);
     CHECK((*ret_block_option).hash == block1.hash);
+    CHECK(block_cache.num_hits() == 1);
+    CHECK(block_cache.num_misses() == 1);
 }
 
 } // namespace silkrpc
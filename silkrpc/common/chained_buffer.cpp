@@ -0,0 +1,123 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "chained_buffer.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <silkrpc/common/constants.hpp>
+
+namespace silkrpc {
+
+void ChainedBuffer::append(char c) {
+    writable_chunk().push_back(c);
+    ++size_;
+}
+
+void ChainedBuffer::append(std::string_view data) {
+    while (!data.empty()) {
+        auto& chunk = writable_chunk();
+        const auto count = std::min(data.size(), chunk.capacity() - chunk.size());
+        chunk.append(data.data(), count);
+        data.remove_prefix(count);
+        size_ += count;
+    }
+}
+
+void ChainedBuffer::append(ChainedBuffer&& other) {
+    const auto other_begin = other.chunks_.begin();
+    const auto other_end = other_begin + static_cast<std::ptrdiff_t>(other.used_chunks_);
+    chunks_.insert(chunks_.begin() + static_cast<std::ptrdiff_t>(used_chunks_), std::make_move_iterator(other_begin), std::make_move_iterator(other_end));
+    used_chunks_ += other.used_chunks_;
+    size_ += other.size_;
+
+    other.chunks_.erase(other_begin, other_end);
+    other.used_chunks_ = 0;
+    other.size_ = 0;
+}
+
+std::size_t ChainedBuffer::capacity() const {
+    std::size_t capacity{0};
+    for (const auto& chunk : chunks_) {
+        capacity += chunk.capacity();
+    }
+    return capacity;
+}
+
+void ChainedBuffer::clear() {
+    std::size_t retained_size{0};
+    std::size_t retained_chunks{0};
+    while (retained_chunks < chunks_.size() && retained_size + chunks_[retained_chunks].capacity() <= kReplyChunkMaxSize) {
+        chunks_[retained_chunks].clear();
+        retained_size += chunks_[retained_chunks].capacity();
+        ++retained_chunks;
+    }
+    chunks_.resize(retained_chunks);
+    used_chunks_ = 0;
+    size_ = 0;
+}
+
+bool ChainedBuffer::starts_with(std::string_view prefix) const {
+    if (prefix.size() > size_) {
+        return false;
+    }
+    for (std::size_t i{0}; i < used_chunks_ && !prefix.empty(); ++i) {
+        const std::string_view chunk{chunks_[i]};
+        const auto count = std::min(prefix.size(), chunk.size());
+        if (chunk.substr(0, count) != prefix.substr(0, count)) {
+            return false;
+        }
+        prefix.remove_prefix(count);
+    }
+    return true;
+}
+
+void ChainedBuffer::to_buffers(std::vector<asio::const_buffer>& buffers) const {
+    for (std::size_t i{0}; i < used_chunks_; ++i) {
+        if (!chunks_[i].empty()) {
+            buffers.push_back(asio::buffer(chunks_[i]));
+        }
+    }
+}
+
+std::string ChainedBuffer::to_string() const {
+    std::string content;
+    content.reserve(size_);
+    for (std::size_t i{0}; i < used_chunks_; ++i) {
+        content.append(chunks_[i]);
+    }
+    return content;
+}
+
+std::string& ChainedBuffer::writable_chunk() {
+    if (used_chunks_ > 0 && chunks_[used_chunks_ - 1].size() < chunks_[used_chunks_ - 1].capacity()) {
+        return chunks_[used_chunks_ - 1];
+    }
+    if (used_chunks_ == chunks_.size()) {
+        const auto capacity = chunks_.empty() ? kReplyChunkMinSize : std::min(chunks_.back().capacity() * 2, kReplyChunkMaxSize);
+        chunks_.emplace_back().reserve(capacity);
+    }
+    return chunks_[used_chunks_++];
+}
+
+std::ostream& operator<<(std::ostream& out, const ChainedBuffer& buffer) {
+    out << buffer.to_string();
+    return out;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,74 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_CHAINED_BUFFER_HPP_
+#define SILKRPC_COMMON_CHAINED_BUFFER_HPP_
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <asio/buffer.hpp>
+
+namespace silkrpc {
+
+// Output buffer made of a chain of chunks, so that growing never copies already written data. Chunks start small
+// and double up to kReplyChunkMaxSize, they are kept across clear() calls to be reused by the next output.
+class ChainedBuffer {
+public:
+    ChainedBuffer() = default;
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t num_chunks() const { return used_chunks_; }
+
+    // Bytes allocated by all the chunks, including the ones retained for reuse
+    std::size_t capacity() const;
+
+    void append(char c);
+    void append(std::string_view data);
+
+    // Move all the chunks of other at the end of this buffer without copying them, leaving other empty
+    void append(ChainedBuffer&& other);
+
+    // Check if the content begins with the given prefix, possibly spanning several chunks
+    bool starts_with(std::string_view prefix) const;
+
+    // Discard the content retaining up to kReplyChunkMaxSize bytes of allocated chunks
+    void clear();
+
+    // Add the buffers referring to the content, which must stay unchanged until they are in use
+    void to_buffers(std::vector<asio::const_buffer>& buffers) const;
+
+    std::string to_string() const;
+
+private:
+    std::string& writable_chunk();
+
+    std::vector<std::string> chunks_;
+    std::size_t used_chunks_{0};
+    std::size_t size_{0};
+};
+
+std::ostream& operator<<(std::ostream& out, const ChainedBuffer& buffer);
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_COMMON_CHAINED_BUFFER_HPP_
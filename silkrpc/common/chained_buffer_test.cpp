@@ -0,0 +1,118 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "chained_buffer.hpp"
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/common/constants.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("create empty chained buffer", "[silkrpc][common][chained_buffer]") {
+    ChainedBuffer buffer;
+    CHECK(buffer.empty());
+    CHECK(buffer.size() == 0);
+    CHECK(buffer.num_chunks() == 0);
+    CHECK(buffer.to_string().empty());
+}
+
+TEST_CASE("append to chained buffer", "[silkrpc][common][chained_buffer]") {
+    ChainedBuffer buffer;
+
+    SECTION("small data fits in one chunk") {
+        buffer.append('{');
+        buffer.append("\"id\":1");
+        buffer.append('}');
+        CHECK(buffer.size() == 8);
+        CHECK(buffer.num_chunks() == 1);
+        CHECK(buffer.to_string() == "{\"id\":1}");
+    }
+
+    SECTION("large data spans several chunks") {
+        std::string data;
+        for (std::size_t i{0}; i < 4 * kReplyChunkMaxSize; ++i) {
+            data.push_back(static_cast<char>('a' + i % 26));
+        }
+        buffer.append(data);
+        CHECK(buffer.size() == data.size());
+        CHECK(buffer.num_chunks() > 4);
+        CHECK(buffer.to_string() == data);
+
+        std::vector<asio::const_buffer> buffers;
+        buffer.to_buffers(buffers);
+        CHECK(buffers.size() == buffer.num_chunks());
+        CHECK(asio::buffer_size(buffers) == data.size());
+    }
+
+    SECTION("chained buffer moved at the end") {
+        ChainedBuffer other;
+        buffer.append("[1");
+        other.append(",2");
+        buffer.append(std::move(other));
+        buffer.append(']');
+        CHECK(buffer.to_string() == "[1,2]");
+        CHECK(buffer.num_chunks() == 2);
+        CHECK(other.empty());
+        CHECK(other.num_chunks() == 0);
+    }
+}
+
+TEST_CASE("clear chained buffer", "[silkrpc][common][chained_buffer]") {
+    ChainedBuffer buffer;
+    buffer.append(std::string(2 * kReplyChunkMaxSize, 'x'));
+    CHECK(buffer.capacity() >= 2 * kReplyChunkMaxSize);
+    buffer.clear();
+    CHECK(buffer.empty());
+    CHECK(buffer.num_chunks() == 0);
+    CHECK(buffer.to_string().empty());
+    CHECK(buffer.capacity() <= kReplyChunkMaxSize);
+
+    buffer.append("reused");
+    CHECK(buffer.to_string() == "reused");
+    CHECK(buffer.num_chunks() == 1);
+}
+
+TEST_CASE("check chained buffer prefix", "[silkrpc][common][chained_buffer]") {
+    ChainedBuffer buffer;
+    CHECK(buffer.starts_with(""));
+    CHECK(!buffer.starts_with("a"));
+
+    ChainedBuffer other;
+    other.append("def");
+    buffer.append("abc");
+    buffer.append(std::move(other));
+    CHECK(buffer.num_chunks() == 2);
+    CHECK(buffer.starts_with("abcd"));
+    CHECK(buffer.starts_with("abcdef"));
+    CHECK(!buffer.starts_with("abd"));
+    CHECK(!buffer.starts_with("abcdefg"));
+}
+
+TEST_CASE("print chained buffer", "[silkrpc][common][chained_buffer]") {
+    ChainedBuffer buffer;
+    buffer.append("abc");
+    std::ostringstream oss;
+    oss << buffer;
+    CHECK(oss.str() == "abc");
+}
+
+} // namespace silkrpc
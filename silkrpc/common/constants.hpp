@@ -40,15 +40,57 @@ constexpr const char* kDefaultEth2Local{"localhost:8550"};
 constexpr const char* kDefaultTarget{"localhost:9090"};
 constexpr const char* kDefaultEth1ApiSpec{"debug,eth,net,parity,tg,trace,web3"};
 constexpr const char* kDefaultEth2ApiSpec{"engine"};
+
+constexpr const char* kMetricsPath{"/metrics"};
+
 constexpr const std::chrono::milliseconds kDefaultTimeout{10000};
 
 constexpr const std::size_t kHttpIncomingBufferSize{8192};
 
+constexpr const std::size_t kDefaultMaxConnections{0};
+constexpr const std::chrono::milliseconds kDefaultIdleTimeout{60000};
+constexpr const std::chrono::milliseconds kDefaultReadTimeout{30000};
+constexpr const std::chrono::milliseconds kDefaultWriteTimeout{30000};
+
+constexpr const std::size_t kCompletionPollSpins{100};
+constexpr const std::chrono::microseconds kCompletionPollMinWait{10};
+constexpr const std::chrono::microseconds kCompletionPollMaxWait{1000};
+
+constexpr const std::chrono::milliseconds kWorkerIdleTimeout{10000};
+constexpr const std::chrono::microseconds kWorkerMaxQueueWait{1000};
+
+constexpr const std::size_t kMaxCursorReadAhead{64};
+constexpr const std::chrono::milliseconds kMaxPooledTransactionAge{2000};
+
+constexpr const std::chrono::milliseconds kTimerWheelTick{250};
+constexpr const std::size_t kTimerWheelSlots{256};
+
 constexpr const std::size_t kRequestContentInitialCapacity{1024};
+constexpr const std::size_t kRequestContentMaxRetainedCapacity{64 * 1024};
 constexpr const std::size_t kRequestHeadersInitialCapacity{8};
 constexpr const std::size_t kRequestMethodInitialCapacity{64};
 constexpr const std::size_t kRequestUriInitialCapacity{64};
 
+constexpr const std::size_t kMaxBatchConcurrency{32};
+
+constexpr const std::size_t kReplyCacheSize{64 * 1024 * 1024};
+
+constexpr const std::size_t kReplyChunkMinSize{512};
+constexpr const std::size_t kReplyChunkMaxSize{64 * 1024};
+constexpr const std::size_t kReplyFlushSize{64 * 1024};
+
+constexpr const std::size_t kMinCompressionSize{1024};
+constexpr const int kCompressionLevel{1};
+constexpr const std::size_t kCompressionBufferSize{16 * 1024};
+constexpr const std::size_t kMaxIdleCompressors{16}; // default number of workers, i.e. of concurrent compressions
+
+constexpr const std::size_t kMaxWebSocketMessageSize{16 * 1024 * 1024};
+constexpr const std::size_t kMaxWebSocketPendingMessages{1024};
+
+constexpr const std::size_t kMaxIpcMessageSize{16 * 1024 * 1024};
+
+constexpr const std::chrono::milliseconds kSubscriptionRetryDelay{1000};
+
 } // namespace silkrpc
 
 #endif  // SILKRPC_COMMON_CONSTANTS_HPP_
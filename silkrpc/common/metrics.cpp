@@ -0,0 +1,273 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+#include <silkrpc/common/clock_time.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+struct HistogramSum {
+    std::array<uint64_t, LatencyHistogram::kNumBuckets> buckets{};
+    uint64_t count{0};
+    uint64_t sum_ns{0};
+
+    void add(const LatencyHistogram& histogram) {
+        for (std::size_t i{0}; i < buckets.size(); ++i) {
+            buckets[i] += histogram.bucket(i);
+        }
+        count += histogram.count();
+        sum_ns += histogram.sum_ns();
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Metrics>> metrics;
+    std::vector<Metrics*> released; // instances of exited threads, whose counters are kept and keep growing when reused
+    std::map<std::size_t, MetricsCollector> collectors;
+    std::size_t next_collector_id{0};
+};
+
+Registry& registry() {
+    // Never destroyed, because detached threads may still record during the destruction of static objects at exit
+    static auto* registry = new Registry;
+    return *registry;
+}
+
+// Owner of the instance of a thread, which gives it back when the thread exits. The registry lock hands it over to the
+// next thread, so each instance keeps having a single writer
+struct LocalMetrics {
+    Metrics* metrics;
+
+    LocalMetrics() {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock{r.mutex};
+        if (r.released.empty()) {
+            metrics = r.metrics.emplace_back(std::make_unique<Metrics>()).get();
+        } else {
+            metrics = r.released.back();
+            r.released.pop_back();
+        }
+    }
+
+    ~LocalMetrics() {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock{r.mutex};
+        r.released.push_back(metrics);
+    }
+};
+
+// Increment a counter having a single writer, avoiding the locked instruction of fetch_add
+void increment(std::atomic<uint64_t>& counter, uint64_t value = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Real values, i.e. durations in seconds and ratios
+void write_number(std::string& out, double value) {
+    char buffer[32];
+    const auto size = std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    out.append(buffer, static_cast<std::size_t>(size));
+}
+
+// Counts must be written in full, or busy counters would stop increasing once rounded to the significant digits
+void write_number(std::string& out, uint64_t value) {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void write_header(std::string& out, std::string_view name, std::string_view type, std::string_view help) {
+    out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+}
+
+template <typename T>
+void write_sample(std::string& out, std::string_view name, std::string_view labels, T value) {
+    out.append(name);
+    if (!labels.empty()) {
+        out.append("{").append(labels).append("}");
+    }
+    out.append(" ");
+    write_number(out, value);
+    out.append("\n");
+}
+
+void write_histograms(std::string& out, const std::string& name, const char* help, const char* label,
+                      const std::map<std::string, HistogramSum>& histograms) {
+    write_header(out, name, "histogram", help);
+    for (const auto& [label_value, histogram] : histograms) {
+        const auto labels = std::string{label} + "=\"" + label_value + "\"";
+        uint64_t cumulative_count{0};
+        for (std::size_t i{0}; i < histogram.buckets.size(); ++i) {
+            cumulative_count += histogram.buckets[i];
+            out.append(name).append("_bucket{").append(labels).append(",le=\"");
+            if (i + 1 < histogram.buckets.size()) {
+                write_number(out, static_cast<double>(LatencyHistogram::upper_bound_us(i)) / 1e6);
+            } else {
+                out.append("+Inf");
+            }
+            out.append("\"} ");
+            write_number(out, cumulative_count);
+            out.append("\n");
+        }
+        write_sample(out, name + "_sum", labels, static_cast<double>(histogram.sum_ns) / 1e9);
+        write_sample(out, name + "_count", labels, histogram.count);
+    }
+}
+
+} // namespace
+
+std::size_t LatencyHistogram::bucket_index(uint64_t latency_ns) {
+    const uint64_t latency_us = (latency_ns + 999) / 1000;
+    if (latency_us <= 1) {
+        return 0;
+    }
+    return std::min<std::size_t>(std::bit_width(latency_us - 1), kNumBuckets - 1);
+}
+
+void LatencyHistogram::record(uint64_t latency_ns) {
+    increment(buckets_[bucket_index(latency_ns)]);
+    increment(count_);
+    increment(sum_ns_, latency_ns);
+}
+
+Metrics& Metrics::local() {
+    thread_local LocalMetrics local;
+    return *local.metrics;
+}
+
+template <typename T>
+T& Metrics::stats(StatsMap<T>& map, std::string_view name) {
+    // Only the owner thread modifies the map, so it can look up without locking
+    const auto it = map.find(name);
+    if (it != map.end()) {
+        return *it->second;
+    }
+    std::lock_guard<std::mutex> lock{mutex_};
+    return *map.emplace(std::string{name}, std::make_unique<T>()).first->second;
+}
+
+void Metrics::record_request(std::string_view method, uint64_t latency_ns, bool error) {
+    auto& request_stats = stats(requests_, method);
+    request_stats.latency.record(latency_ns);
+    if (error) {
+        increment(request_stats.errors);
+    }
+}
+
+void Metrics::record_kv_operation(std::string_view table, uint64_t latency_ns) {
+    stats(kv_operations_, table).record(latency_ns);
+}
+
+void Metrics::record_worker_task(uint64_t busy_ns) {
+    increment(worker_tasks_);
+    increment(worker_busy_ns_, busy_ns);
+}
+
+std::size_t Metrics::add_collector(MetricsCollector collector) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    const auto id = r.next_collector_id++;
+    r.collectors.emplace(id, std::move(collector));
+    return id;
+}
+
+void Metrics::remove_collector(std::size_t id) {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock{r.mutex};
+    r.collectors.erase(id);
+}
+
+std::string Metrics::scrape() {
+    std::map<std::string, HistogramSum> request_latencies;
+    std::map<std::string, uint64_t> request_errors;
+    std::map<std::string, HistogramSum> kv_latencies;
+    uint64_t worker_tasks{0};
+    uint64_t worker_busy_ns{0};
+    std::vector<MetricSample> samples;
+
+    auto& r = registry();
+    {
+        // Collectors are invoked while holding the lock, so that they cannot be removed meanwhile
+        std::lock_guard<std::mutex> registry_lock{r.mutex};
+        for (const auto& metrics : r.metrics) {
+            std::lock_guard<std::mutex> lock{metrics->mutex_};
+            for (const auto& [method, request_stats] : metrics->requests_) {
+                request_latencies[method].add(request_stats->latency);
+                request_errors[method] += request_stats->errors.load(std::memory_order_relaxed);
+            }
+            for (const auto& [table, latency] : metrics->kv_operations_) {
+                kv_latencies[table].add(*latency);
+            }
+            worker_tasks += metrics->worker_tasks_.load(std::memory_order_relaxed);
+            worker_busy_ns += metrics->worker_busy_ns_.load(std::memory_order_relaxed);
+        }
+        for (const auto& [_, collector] : r.collectors) {
+            collector(samples);
+        }
+    }
+
+    std::string out;
+    write_header(out, "silkrpc_requests_total", "counter", "Number of handled requests per method");
+    for (const auto& [method, latency] : request_latencies) {
+        write_sample(out, "silkrpc_requests_total", "method=\"" + method + "\"", latency.count);
+    }
+    write_header(out, "silkrpc_request_errors_total", "counter", "Number of requests per method replied with an error");
+    for (const auto& [method, errors] : request_errors) {
+        write_sample(out, "silkrpc_request_errors_total", "method=\"" + method + "\"", errors);
+    }
+    write_histograms(out, "silkrpc_request_duration_seconds", "Latency of requests per method", "method", request_latencies);
+    write_histograms(out, "silkrpc_kv_operation_duration_seconds", "Latency of remote KV cursor operations per table", "table", kv_latencies);
+    write_header(out, "silkrpc_worker_tasks_total", "counter", "Number of tasks run by the worker pool");
+    write_sample(out, "silkrpc_worker_tasks_total", "", worker_tasks);
+    write_header(out, "silkrpc_worker_busy_seconds_total", "counter", "Time spent by the worker pool running tasks");
+    write_sample(out, "silkrpc_worker_busy_seconds_total", "", static_cast<double>(worker_busy_ns) / 1e9);
+
+    // Group the collected samples by metric, each one must be declared just once
+    std::stable_sort(samples.begin(), samples.end(), [](const auto& lhs, const auto& rhs) { return lhs.name < rhs.name; });
+    for (std::size_t i{0}; i < samples.size(); ++i) {
+        const auto& sample = samples[i];
+        if (i == 0 || sample.name != samples[i - 1].name) {
+            write_header(out, sample.name, sample.type, sample.help);
+        }
+        // Collected counters are all counts, exactly represented by the double value up to 2^53
+        if (std::string_view{sample.type} == "counter") {
+            write_sample(out, sample.name, sample.labels, static_cast<uint64_t>(std::llround(sample.value)));
+        } else {
+            write_sample(out, sample.name, sample.labels, sample.value);
+        }
+    }
+    return out;
+}
+
+WorkerTaskTimer::WorkerTaskTimer() : start_time_{clock_time::now()} {}
+
+WorkerTaskTimer::~WorkerTaskTimer() {
+    Metrics::local().record_worker_task(clock_time::since(start_time_));
+}
+
+} // namespace silkrpc
@@ -0,0 +1,127 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_METRICS_HPP_
+#define SILKRPC_COMMON_METRICS_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace silkrpc {
+
+// Latency histogram with exponential buckets doubling from 1us up to about 33s, plus the overflow one.
+// It has a single writer, so recording uses just relaxed loads and stores: no locks nor read-modify-write instructions.
+// Other threads can read it at any time, getting values which are at most a few samples behind.
+class LatencyHistogram {
+public:
+    static constexpr std::size_t kNumBuckets{27};
+
+    // Upper bound in microseconds of the i-th bucket, the last one has no bound
+    static constexpr uint64_t upper_bound_us(std::size_t i) { return uint64_t{1} << i; }
+
+    // Index of the bucket counting the given latency
+    static std::size_t bucket_index(uint64_t latency_ns);
+
+    void record(uint64_t latency_ns);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum_ns() const { return sum_ns_.load(std::memory_order_relaxed); }
+    uint64_t bucket(std::size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_ns_{0};
+};
+
+// Point-in-time value owned by some component, e.g. the number of open connections of a server
+struct MetricSample {
+    std::string name;
+    const char* type; // either gauge or counter
+    const char* help;
+    std::string labels; // comma-separated list of name="value", possibly empty
+    double value;
+};
+
+using MetricsCollector = std::function<void(std::vector<MetricSample>&)>;
+
+// Per-thread metrics: each thread records into its own instance without contention and scraping merges all of them.
+// The owner thread looks up stats without locking, the mutex is taken just to add new ones and to scrape.
+class Metrics {
+public:
+    // The instance of the calling thread, taken at first use and recycled by the next new thread when this one exits,
+    // so that threads started and retired over time (e.g. by worker pools) do not grow the number of instances
+    static Metrics& local();
+
+    void record_request(std::string_view method, uint64_t latency_ns, bool error);
+
+    void record_kv_operation(std::string_view table, uint64_t latency_ns);
+
+    void record_worker_task(uint64_t busy_ns);
+
+    // Register the collector invoked at each scrape, return the identifier to remove it
+    static std::size_t add_collector(MetricsCollector collector);
+
+    static void remove_collector(std::size_t id);
+
+    // Render the merged metrics of all threads and the collected samples in Prometheus text exposition format
+    static std::string scrape();
+
+private:
+    struct RequestStats {
+        LatencyHistogram latency;
+        std::atomic<uint64_t> errors{0};
+    };
+
+    template <typename T>
+    using StatsMap = std::map<std::string, std::unique_ptr<T>, std::less<>>;
+
+    template <typename T>
+    T& stats(StatsMap<T>& map, std::string_view name);
+
+    std::mutex mutex_;
+    StatsMap<RequestStats> requests_;
+    StatsMap<LatencyHistogram> kv_operations_;
+    std::atomic<uint64_t> worker_tasks_{0};
+    std::atomic<uint64_t> worker_busy_ns_{0};
+};
+
+// Record the time spent by a task running on the worker pool, i.e. from construction to destruction
+class WorkerTaskTimer {
+public:
+    WorkerTaskTimer();
+    ~WorkerTaskTimer();
+
+    WorkerTaskTimer(const WorkerTaskTimer&) = delete;
+    WorkerTaskTimer& operator=(const WorkerTaskTimer&) = delete;
+
+private:
+    uint64_t start_time_;
+};
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_COMMON_METRICS_HPP_
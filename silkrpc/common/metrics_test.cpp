@@ -0,0 +1,102 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "metrics.hpp"
+
+#include <string>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("latency histogram buckets", "[silkrpc][common][metrics]") {
+    CHECK(LatencyHistogram::bucket_index(0) == 0);
+    CHECK(LatencyHistogram::bucket_index(1000) == 0);
+    CHECK(LatencyHistogram::bucket_index(1001) == 1);
+    CHECK(LatencyHistogram::bucket_index(2000) == 1);
+    CHECK(LatencyHistogram::bucket_index(3000) == 2);
+    CHECK(LatencyHistogram::bucket_index(1'000'000) == 10);
+    CHECK(LatencyHistogram::bucket_index(uint64_t{1} << 62) == LatencyHistogram::kNumBuckets - 1);
+
+    LatencyHistogram histogram;
+    histogram.record(1500);
+    histogram.record(1800);
+    histogram.record(5'000'000);
+    CHECK(histogram.count() == 3);
+    CHECK(histogram.sum_ns() == 5'003'300);
+    CHECK(histogram.bucket(1) == 2);
+    CHECK(histogram.bucket(13) == 1);
+}
+
+TEST_CASE("metrics scrape", "[silkrpc][common][metrics]") {
+    SECTION("merge per-thread requests") {
+        Metrics::local().record_request("test_merge", 1000, false);
+        std::thread other{[] { Metrics::local().record_request("test_merge", 3000, true); }};
+        other.join();
+        const auto text = Metrics::scrape();
+        CHECK(text.find("silkrpc_requests_total{method=\"test_merge\"} 2\n") != std::string::npos);
+        CHECK(text.find("silkrpc_request_errors_total{method=\"test_merge\"} 1\n") != std::string::npos);
+        CHECK(text.find("silkrpc_request_duration_seconds_bucket{method=\"test_merge\",le=\"1e-06\"} 1\n") != std::string::npos);
+        CHECK(text.find("silkrpc_request_duration_seconds_bucket{method=\"test_merge\",le=\"4e-06\"} 2\n") != std::string::npos);
+        CHECK(text.find("silkrpc_request_duration_seconds_bucket{method=\"test_merge\",le=\"+Inf\"} 2\n") != std::string::npos);
+        CHECK(text.find("silkrpc_request_duration_seconds_sum{method=\"test_merge\"} 4e-06\n") != std::string::npos);
+    }
+
+    SECTION("recycle instances of exited threads") {
+        Metrics* first{nullptr};
+        std::thread{[&] { first = &Metrics::local(); first->record_request("test_recycle", 1000, false); }}.join();
+        Metrics* second{nullptr};
+        std::thread{[&] { second = &Metrics::local(); second->record_request("test_recycle", 1000, false); }}.join();
+        CHECK(second == first);
+        CHECK(&Metrics::local() != first);
+        const auto text = Metrics::scrape();
+        CHECK(text.find("silkrpc_requests_total{method=\"test_recycle\"} 2\n") != std::string::npos);
+    }
+
+    SECTION("kv operations") {
+        Metrics::local().record_kv_operation("TestTable", 1'000'000);
+        const auto text = Metrics::scrape();
+        CHECK(text.find("silkrpc_kv_operation_duration_seconds_count{table=\"TestTable\"} 1\n") != std::string::npos);
+    }
+
+    SECTION("collected samples") {
+        const auto id = Metrics::add_collector([](auto& samples) {
+            samples.push_back({"test_gauge", "gauge", "Test gauge", "endpoint=\"a\"", 1});
+            samples.push_back({"test_gauge", "gauge", "Test gauge", "endpoint=\"b\"", 2});
+        });
+        auto text = Metrics::scrape();
+        CHECK(text.find("# TYPE test_gauge gauge\ntest_gauge{endpoint=\"a\"} 1\ntest_gauge{endpoint=\"b\"} 2\n") != std::string::npos);
+
+        Metrics::remove_collector(id);
+        text = Metrics::scrape();
+        CHECK(text.find("test_gauge") == std::string::npos);
+    }
+
+    SECTION("large counters written in full") {
+        const auto id = Metrics::add_collector([](auto& samples) {
+            samples.push_back({"test_total", "counter", "Test counter", "", 12'345'678'901.0});
+            samples.push_back({"test_seconds", "gauge", "Test gauge", "", 0.25});
+        });
+        const auto text = Metrics::scrape();
+        CHECK(text.find("test_total 12345678901\n") != std::string::npos);
+        CHECK(text.find("test_seconds 0.25\n") != std::string::npos);
+        Metrics::remove_collector(id);
+    }
+}
+
+} // namespace silkrpc
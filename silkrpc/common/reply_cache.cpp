@@ -0,0 +1,93 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "reply_cache.hpp"
+
+#include <utility>
+
+namespace silkrpc {
+
+std::string ReplyCache::make_key(const nlohmann::json& request) {
+    std::string key{request["method"].get<std::string>()};
+    key.push_back(' ');
+    if (request.contains("params")) {
+        key.append(request["params"].dump());
+    }
+    return key;
+}
+
+std::shared_ptr<const std::string> ReplyCache::get(const std::string& key) {
+    const std::lock_guard<std::mutex> lock(access_);
+    const auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++num_misses_;
+        return nullptr;
+    }
+    ++num_hits_;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->result;
+}
+
+void ReplyCache::insert(const std::string& key, std::string result) {
+    const auto entry_size = key.size() + result.size();
+    if (entry_size > max_size_) {
+        return;
+    }
+    auto shared_result = std::make_shared<const std::string>(std::move(result));
+
+    const std::lock_guard<std::mutex> lock(access_);
+    const auto it = index_.find(key);
+    if (it != index_.end()) {
+        // Identical requests may have been served concurrently, the result is the same anyway
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+    evict(max_size_ - entry_size);
+    entries_.push_front(Entry{key, std::move(shared_result)});
+    index_.emplace(key, entries_.begin());
+    size_ += entry_size;
+}
+
+void ReplyCache::evict(std::size_t max_size) {
+    while (size_ > max_size) {
+        const auto& entry = entries_.back();
+        size_ -= entry.key.size() + entry.result->size();
+        index_.erase(entry.key);
+        entries_.pop_back();
+    }
+}
+
+std::size_t ReplyCache::size() const {
+    const std::lock_guard<std::mutex> lock(access_);
+    return size_;
+}
+
+std::size_t ReplyCache::num_entries() const {
+    const std::lock_guard<std::mutex> lock(access_);
+    return entries_.size();
+}
+
+uint64_t ReplyCache::num_hits() const {
+    const std::lock_guard<std::mutex> lock(access_);
+    return num_hits_;
+}
+
+uint64_t ReplyCache::num_misses() const {
+    const std::lock_guard<std::mutex> lock(access_);
+    return num_misses_;
+}
+
+} // namespace silkrpc
@@ -0,0 +1,77 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_COMMON_REPLY_CACHE_HPP_
+#define SILKRPC_COMMON_REPLY_CACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+namespace silkrpc {
+
+// Size-bounded LRU cache of the serialized JSON results of requests targeting finalized blocks, which never change.
+// Shared by all the contexts, so it is thread-safe.
+class ReplyCache {
+public:
+    explicit ReplyCache(std::size_t max_size) : max_size_(max_size) {}
+
+    ReplyCache(const ReplyCache&) = delete;
+    ReplyCache& operator=(const ReplyCache&) = delete;
+
+    // Build the key of the request made of its method and params, serialized with sorted keys
+    static std::string make_key(const nlohmann::json& request);
+
+    // Return the cached result, if any: it is shared, so that the lock is not held while copying it
+    std::shared_ptr<const std::string> get(const std::string& key);
+
+    // Insert the result, evicting the least recently used ones to stay within the maximum size
+    void insert(const std::string& key, std::string result);
+
+    // Total size in bytes of the cached keys and results
+    std::size_t size() const;
+
+    std::size_t num_entries() const;
+
+    uint64_t num_hits() const;
+    uint64_t num_misses() const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const std::string> result;
+    };
+
+    void evict(std::size_t max_size);
+
+    const std::size_t max_size_;
+    mutable std::mutex access_;
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::size_t size_{0};
+    uint64_t num_hits_{0};
+    uint64_t num_misses_{0};
+};
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_COMMON_REPLY_CACHE_HPP_
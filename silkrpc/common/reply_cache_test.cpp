@@ -0,0 +1,84 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "reply_cache.hpp"
+
+#include <string>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("reply cache key", "[silkrpc][common][reply_cache]") {
+    const auto request1 = nlohmann::json::parse(R"({"jsonrpc":"2.0","id":1,"method":"eth_getLogs","params":[{"blockHash":"0x01","address":"0x02"}]})");
+    const auto request2 = nlohmann::json::parse(R"({"id":2,"params":[{"address":"0x02","blockHash":"0x01"}],"method":"eth_getLogs","jsonrpc":"2.0"})");
+    const auto request3 = nlohmann::json::parse(R"({"jsonrpc":"2.0","id":1,"method":"eth_getLogs","params":[{"blockHash":"0x01"}]})");
+    CHECK(ReplyCache::make_key(request1) == ReplyCache::make_key(request2));
+    CHECK(ReplyCache::make_key(request1) != ReplyCache::make_key(request3));
+}
+
+TEST_CASE("reply cache", "[silkrpc][common][reply_cache]") {
+    ReplyCache cache{32};
+
+    SECTION("hit and miss") {
+        CHECK(!cache.get("a"));
+        cache.insert("a", "0x1234");
+        const auto result = cache.get("a");
+        REQUIRE(result);
+        CHECK(*result == "0x1234");
+        CHECK(cache.num_hits() == 1);
+        CHECK(cache.num_misses() == 1);
+        CHECK(cache.size() == 7);
+    }
+
+    SECTION("evict least recently used") {
+        cache.insert("a", std::string(9, 'a'));
+        cache.insert("b", std::string(9, 'b'));
+        cache.insert("c", std::string(9, 'c'));
+        CHECK(cache.get("a"));
+        cache.insert("d", std::string(9, 'd'));
+        CHECK(cache.num_entries() == 3);
+        CHECK(cache.get("a"));
+        CHECK(!cache.get("b"));
+        CHECK(cache.get("c"));
+        CHECK(cache.get("d"));
+        CHECK(cache.size() <= 32);
+    }
+
+    SECTION("result outlives its eviction") {
+        cache.insert("a", std::string(20, 'a'));
+        const auto result = cache.get("a");
+        cache.insert("b", std::string(20, 'b'));
+        CHECK(!cache.get("a"));
+        REQUIRE(result);
+        CHECK(*result == std::string(20, 'a'));
+    }
+
+    SECTION("entry too big") {
+        cache.insert("a", std::string(32, 'a'));
+        CHECK(cache.num_entries() == 0);
+        CHECK(cache.size() == 0);
+    }
+
+    SECTION("duplicate insertion") {
+        cache.insert("a", "0x1");
+        cache.insert("a", "0x1");
+        CHECK(cache.num_entries() == 1);
+        CHECK(cache.size() == 4);
+    }
+}
+
+} // namespace silkrpc
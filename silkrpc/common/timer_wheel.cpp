@@ -0,0 +1,139 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace silkrpc {
+
+void TimerWheel::Timer::expires_after(std::chrono::milliseconds timeout) {
+    wheel_.schedule(*this, timeout);
+}
+
+void TimerWheel::Timer::cancel() {
+    if (list_ != nullptr) {
+        wheel_.unlink(*this);
+    }
+}
+
+TimerWheel::TimerWheel(asio::io_context& io_context, std::chrono::milliseconds tick, std::size_t num_slots)
+: tick_{tick}, slots_(num_slots, nullptr), ticker_{io_context} {
+    if (tick_.count() <= 0 || num_slots == 0) {
+        throw std::invalid_argument{"TimerWheel::TimerWheel invalid tick or number of slots"};
+    }
+}
+
+void TimerWheel::start() {
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    ticker_.expires_after(tick_);
+    publish_next_tick();
+    wait_tick();
+}
+
+void TimerWheel::stop() {
+    running_ = false;
+    ticker_.cancel();
+    next_tick_ns_.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds TimerWheel::lag() const {
+    const auto now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    const auto overdue_ns = now_ns - next_tick_ns_.load(std::memory_order_relaxed);
+    return std::chrono::nanoseconds{std::max(lag_ns_.load(std::memory_order_relaxed), overdue_ns)};
+}
+
+void TimerWheel::advance() {
+    current_slot_ = (current_slot_ + 1) % slots_.size();
+
+    // Move the due timers out of the slot first, so that expiry callbacks can freely (re)schedule or cancel any timer
+    Timer* expired{nullptr};
+    for (Timer* timer = slots_[current_slot_]; timer != nullptr;) {
+        Timer* next = timer->next_;
+        if (timer->rounds_ > 0) {
+            --timer->rounds_;
+        } else {
+            unlink(*timer);
+            link(*timer, &expired);
+        }
+        timer = next;
+    }
+    while (expired != nullptr) {
+        Timer& timer = *expired;
+        unlink(timer);
+        timer.on_expiry_();
+    }
+}
+
+void TimerWheel::schedule(Timer& timer, std::chrono::milliseconds timeout) {
+    timer.cancel();
+    const auto ticks = std::max<std::size_t>((timeout.count() + tick_.count() - 1) / tick_.count(), 1);
+    timer.rounds_ = (ticks - 1) / slots_.size();
+    link(timer, &slots_[(current_slot_ + ticks) % slots_.size()]);
+}
+
+void TimerWheel::link(Timer& timer, Timer** list) {
+    timer.list_ = list;
+    timer.prev_ = nullptr;
+    timer.next_ = *list;
+    if (*list != nullptr) {
+        (*list)->prev_ = &timer;
+    }
+    *list = &timer;
+    ++size_;
+}
+
+void TimerWheel::unlink(Timer& timer) {
+    if (timer.prev_ != nullptr) {
+        timer.prev_->next_ = timer.next_;
+    } else {
+        *timer.list_ = timer.next_;
+    }
+    if (timer.next_ != nullptr) {
+        timer.next_->prev_ = timer.prev_;
+    }
+    timer.list_ = nullptr;
+    timer.prev_ = nullptr;
+    timer.next_ = nullptr;
+    --size_;
+}
+
+void TimerWheel::wait_tick() {
+    ticker_.async_wait([this](const asio::error_code& ec) {
+        if (ec == asio::error::operation_aborted || !running_) {
+            return;
+        }
+        const auto lag = std::chrono::steady_clock::now() - ticker_.expiry();
+        lag_ns_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(lag).count(), std::memory_order_relaxed);
+        advance();
+        // Next tick is relative to the previous expiry, so that slow handlers do not make the wheel drift
+        ticker_.expires_at(ticker_.expiry() + tick_);
+        publish_next_tick();
+        wait_tick();
+    });
+}
+
+void TimerWheel::publish_next_tick() {
+    const auto expiry = std::chrono::duration_cast<std::chrono::nanoseconds>(ticker_.expiry().time_since_epoch());
+    next_tick_ns_.store(expiry.count(), std::memory_order_relaxed);
+}
+
+} // namespace silkrpc
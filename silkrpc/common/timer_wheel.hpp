@@ -0,0 +1,110 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_TIMER_WHEEL_HPP_
+#define SILKRPC_COMMON_TIMER_WHEEL_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <asio/io_context.hpp>
+#include <asio/steady_timer.hpp>
+
+namespace silkrpc {
+
+// Hashed timer wheel serving many coarse-grained timeouts with just one steady_timer ticking on the io_context.
+// Timers are intrusive: they live within their owners, so (re)scheduling and cancelling are O(1) without allocations.
+// Not thread-safe: the wheel and all its timers must be used only from the thread running the io_context.
+class TimerWheel {
+public:
+    class Timer {
+    public:
+        Timer(TimerWheel& wheel, std::function<void()> on_expiry) : wheel_(wheel), on_expiry_(std::move(on_expiry)) {}
+        ~Timer() { cancel(); }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        // Schedule the expiry after the given timeout (rounded up to the wheel tick), replacing any previous one
+        void expires_after(std::chrono::milliseconds timeout);
+
+        // Remove the timer from the wheel, if scheduled
+        void cancel();
+
+        bool pending() const { return list_ != nullptr; }
+
+    private:
+        friend class TimerWheel;
+
+        TimerWheel& wheel_;
+        std::function<void()> on_expiry_;
+        Timer** list_{nullptr};
+        Timer* prev_{nullptr};
+        Timer* next_{nullptr};
+        std::size_t rounds_{0};
+    };
+
+    TimerWheel(asio::io_context& io_context, std::chrono::milliseconds tick, std::size_t num_slots);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Start ticking on the io_context
+    void start();
+
+    // Stop ticking, the scheduled timers do not expire anymore until started again
+    void stop();
+
+    // Move the wheel forward by one tick, expiring the due timers (called by the ticker, exposed for testing)
+    void advance();
+
+    std::chrono::milliseconds tick() const { return tick_; }
+    std::size_t size() const { return size_; }
+
+    // Delay of the last tick with respect to its expiry, i.e. how long ready handlers are waiting in the io_context
+    // queue, or how long the next tick is overdue if longer. Unlike anything else in the wheel it can be read from any
+    // thread, so that a stalled io_context shows its growing lag even before the tick runs
+    std::chrono::nanoseconds lag() const;
+
+private:
+    void schedule(Timer& timer, std::chrono::milliseconds timeout);
+    void link(Timer& timer, Timer** list);
+    void unlink(Timer& timer);
+    void wait_tick();
+    void publish_next_tick();
+
+    std::chrono::milliseconds tick_;
+    std::vector<Timer*> slots_;
+    std::size_t current_slot_{0};
+    std::size_t size_{0};
+    asio::steady_timer ticker_;
+    bool running_{false};
+    std::atomic<int64_t> lag_ns_{0};
+    std::atomic<int64_t> next_tick_ns_{std::numeric_limits<int64_t>::max()};
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_COMMON_TIMER_WHEEL_HPP_
@@ -0,0 +1,166 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("create timer wheel", "[silkrpc][common][timer_wheel]") {
+    asio::io_context io_context;
+    CHECK_THROWS_AS(TimerWheel(io_context, 0ms, 8), std::invalid_argument);
+    CHECK_THROWS_AS(TimerWheel(io_context, 10ms, 0), std::invalid_argument);
+    CHECK_NOTHROW(TimerWheel(io_context, 10ms, 8));
+}
+
+TEST_CASE("timer wheel expiry", "[silkrpc][common][timer_wheel]") {
+    asio::io_context io_context;
+    TimerWheel wheel{io_context, 10ms, 4};
+    int expired{0};
+    TimerWheel::Timer timer{wheel, [&]() { ++expired; }};
+
+    SECTION("timeout rounded up to tick") {
+        timer.expires_after(15ms);
+        CHECK(timer.pending());
+        CHECK(wheel.size() == 1);
+        wheel.advance();
+        CHECK(expired == 0);
+        wheel.advance();
+        CHECK(expired == 1);
+        CHECK(!timer.pending());
+        CHECK(wheel.size() == 0);
+    }
+
+    SECTION("zero timeout expires at next tick") {
+        timer.expires_after(0ms);
+        wheel.advance();
+        CHECK(expired == 1);
+    }
+
+    SECTION("timeout longer than one revolution") {
+        timer.expires_after(100ms);
+        for (int i{0}; i < 9; ++i) {
+            wheel.advance();
+        }
+        CHECK(expired == 0);
+        wheel.advance();
+        CHECK(expired == 1);
+    }
+
+    SECTION("rescheduling replaces previous expiry") {
+        timer.expires_after(10ms);
+        timer.expires_after(30ms);
+        CHECK(wheel.size() == 1);
+        wheel.advance();
+        wheel.advance();
+        CHECK(expired == 0);
+        wheel.advance();
+        CHECK(expired == 1);
+    }
+
+    SECTION("cancel") {
+        timer.expires_after(10ms);
+        timer.cancel();
+        CHECK(!timer.pending());
+        wheel.advance();
+        CHECK(expired == 0);
+        CHECK_NOTHROW(timer.cancel());
+    }
+
+    SECTION("destroyed timer is removed") {
+        auto other = std::make_unique<TimerWheel::Timer>(wheel, [&]() { expired += 10; });
+        other->expires_after(10ms);
+        timer.expires_after(10ms);
+        other.reset();
+        CHECK(wheel.size() == 1);
+        wheel.advance();
+        CHECK(expired == 1);
+    }
+}
+
+TEST_CASE("timer wheel expiry callbacks", "[silkrpc][common][timer_wheel]") {
+    asio::io_context io_context;
+    TimerWheel wheel{io_context, 10ms, 4};
+    std::vector<int> expired;
+    TimerWheel::Timer timer1{wheel, [&]() { expired.push_back(1); }};
+    std::unique_ptr<TimerWheel::Timer> timer2;
+    timer2 = std::make_unique<TimerWheel::Timer>(wheel, [&]() { expired.push_back(2); });
+
+    SECTION("callback reschedules its own timer") {
+        int count{0};
+        TimerWheel::Timer self{wheel, [&]() { ++count; self.expires_after(10ms); }};
+        self.expires_after(10ms);
+        wheel.advance();
+        wheel.advance();
+        wheel.advance();
+        CHECK(count == 3);
+        CHECK(self.pending());
+    }
+
+    SECTION("callback destroys another due timer") {
+        TimerWheel::Timer killer{wheel, [&]() { timer2.reset(); }};
+        timer2->expires_after(10ms);
+        killer.expires_after(10ms);
+        timer1.expires_after(10ms);
+        wheel.advance();
+        // Whether timer2 expires depends on the order, anyway it must not be invoked after destruction
+        CHECK(std::count(expired.begin(), expired.end(), 1) == 1);
+        CHECK(wheel.size() == 0);
+    }
+}
+
+TEST_CASE("timer wheel ticking", "[silkrpc][common][timer_wheel]") {
+    asio::io_context io_context;
+    TimerWheel wheel{io_context, 1ms, 8};
+    bool expired{false};
+    TimerWheel::Timer timer{wheel, [&]() { expired = true; wheel.stop(); }};
+    timer.expires_after(3ms);
+    wheel.start();
+    io_context.run();
+    CHECK(expired);
+}
+
+TEST_CASE("timer wheel lag", "[silkrpc][common][timer_wheel]") {
+    asio::io_context io_context;
+    TimerWheel wheel{io_context, 1ms, 8};
+    CHECK(wheel.lag() == 0ns);
+
+    // A handler stalling the io_context keeps the tick from running, the overdue tick must count as lag anyway
+    std::chrono::nanoseconds stalled_lag{0};
+    wheel.start();
+    asio::post(io_context, [&]() {
+        std::this_thread::sleep_for(20ms);
+        stalled_lag = wheel.lag();
+        wheel.stop();
+    });
+    io_context.run();
+    CHECK(stalled_lag >= 15ms);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,162 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "worker_pool.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <silkrpc/common/affinity.hpp>
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+// The pool owning the calling thread, if any
+thread_local WorkerPool* current_pool{nullptr};
+
+} // namespace
+
+WorkerPool::WorkerPool(const std::string& name, std::size_t min_threads, std::size_t max_threads, std::size_t max_queued,
+    std::vector<std::size_t> cpus)
+: name_{name}, min_threads_{min_threads}, max_threads_{std::max(min_threads, max_threads)}, max_queued_{max_queued}, cpus_{std::move(cpus)},
+  work_guard_{io_context_.get_executor()} {
+    std::lock_guard lock{mutex_};
+    for (std::size_t i{0}; i < min_threads_; ++i) {
+        add_thread();
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    work_guard_.reset();
+    io_context_.stop();
+
+    std::map<std::thread::id, std::thread> threads;
+    std::vector<std::thread> exited;
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+        threads.swap(threads_);
+        exited.swap(exited_);
+    }
+    for (auto& [_, thread] : threads) {
+        thread.join();
+    }
+    for (auto& thread : exited) {
+        thread.join();
+    }
+}
+
+std::optional<WorkerPool::Slot> WorkerPool::try_acquire() {
+    // The bound may be exceeded by concurrent callers for an instant, never persistently
+    const auto max_pending = max_queued_ > std::numeric_limits<std::size_t>::max() - max_threads_ ?
+        std::numeric_limits<std::size_t>::max() : max_threads_ + max_queued_;
+    if (pending_.fetch_add(1) >= max_pending) {
+        --pending_;
+        ++rejected_;
+        return std::nullopt;
+    }
+    return Slot{*this};
+}
+
+double WorkerPool::blocked_ratio() const {
+    const auto num_threads = num_threads_.load(std::memory_order_relaxed);
+    return num_threads > 0 ? static_cast<double>(blocked_.load(std::memory_order_relaxed)) / num_threads : 0.0;
+}
+
+void WorkerPool::task_started(uint64_t posted_time) {
+    --queued_;
+    ++busy_;
+
+    // Moving average over the last few tasks: concurrent updates may lose a sample, which is fine for a trend
+    const auto wait_ns = clock_time::since(posted_time);
+    const auto average_ns = queue_wait_ns_.load(std::memory_order_relaxed);
+    queue_wait_ns_.store(average_ns - average_ns / 8 + wait_ns / 8, std::memory_order_relaxed);
+}
+
+void WorkerPool::grow_if_needed() {
+    const auto num_threads = num_threads_.load(std::memory_order_relaxed);
+    if (num_threads >= max_threads_ || busy_ + queued_ <= num_threads) {
+        return;
+    }
+
+    // More threads help only if the busy ones are mostly waiting for remote reads or the tasks wait too long anyway
+    const bool mostly_blocked = blocked_ * 2 >= num_threads;
+    const bool slow_start = queue_wait() >= kWorkerMaxQueueWait;
+    if (!mostly_blocked && !slow_start) {
+        return;
+    }
+
+    std::lock_guard lock{mutex_};
+    if (!stopping_ && num_threads_ < max_threads_) {
+        add_thread();
+        SILKRPC_DEBUG << "WorkerPool " << name_ << " grown to threads: " << num_threads_ << " blocked: " << blocked_
+            << " queue wait: " << queue_wait().count() << "ns\n";
+    }
+}
+
+void WorkerPool::add_thread() {
+    // Exited threads are gone or about to be, since they leave right after releasing the mutex
+    for (auto& thread : exited_) {
+        thread.join();
+    }
+    exited_.clear();
+
+    std::thread thread{[this]() { run_thread(); }};
+    const auto id = thread.get_id();
+    threads_.emplace(id, std::move(thread));
+    ++num_threads_;
+}
+
+void WorkerPool::run_thread() {
+    pin_current_thread(cpus_);
+    current_pool = this;
+
+    while (!io_context_.stopped()) {
+        if (io_context_.run_one_for(kWorkerIdleTimeout) > 0) {
+            continue;
+        }
+
+        // Idle for the whole timeout: give the thread back unless the pool is at its minimum
+        std::lock_guard lock{mutex_};
+        if (stopping_ || num_threads_ <= min_threads_) {
+            continue;
+        }
+        --num_threads_;
+        const auto it = threads_.find(std::this_thread::get_id());
+        exited_.push_back(std::move(it->second));
+        threads_.erase(it);
+        SILKRPC_DEBUG << "WorkerPool " << name_ << " shrunk to threads: " << num_threads_ << "\n";
+        return;
+    }
+}
+
+BlockedWorker::BlockedWorker() : pool_{current_pool} {
+    if (pool_) {
+        ++pool_->blocked_;
+    }
+}
+
+BlockedWorker::~BlockedWorker() {
+    if (pool_) {
+        --pool_->blocked_;
+    }
+}
+
+} // namespace silkrpc
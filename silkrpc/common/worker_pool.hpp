@@ -0,0 +1,162 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#ifndef SILKRPC_COMMON_WORKER_POOL_HPP_
+#define SILKRPC_COMMON_WORKER_POOL_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+
+#include <silkrpc/common/clock_time.hpp>
+
+namespace silkrpc {
+
+// A named pool of worker threads running CPU-bound tasks (e.g. EVM execution) off the io_context threads. The requests
+// routed to the pool are bounded by its max thread count plus its queue bound, so that a burst is rejected rather than queued.
+// The pool is adaptive when max threads exceeds min threads: a task finding all the threads busy adds one more if either
+// the tasks wait too long to start or at least half of the threads are blocked waiting for remote reads, while a thread
+// idle for kWorkerIdleTimeout exits unless the pool is at its minimum.
+class WorkerPool {
+public:
+    // Proof of a slot taken in the pool, released when destroyed
+    class Slot {
+    public:
+        explicit Slot(WorkerPool& pool) : pool_{&pool} {}
+        Slot(Slot&& other) noexcept : pool_{std::exchange(other.pool_, nullptr)} {}
+        ~Slot() { if (pool_) pool_->release(); }
+
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+        Slot& operator=(Slot&&) = delete;
+
+    private:
+        WorkerPool* pool_;
+    };
+
+    WorkerPool(const std::string& name, std::size_t num_threads, std::size_t max_queued, std::vector<std::size_t> cpus = {})
+    : WorkerPool(name, num_threads, num_threads, max_queued, std::move(cpus)) {}
+
+    // Start min_threads threads pinned to the given CPUs (no affinity if empty)
+    WorkerPool(const std::string& name, std::size_t min_threads, std::size_t max_threads, std::size_t max_queued,
+        std::vector<std::size_t> cpus = {});
+
+    // Stop the threads, abandoning the tasks not started yet
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Take a slot in the pool, return no slot if the threads are busy and the queue is full
+    std::optional<Slot> try_acquire();
+
+    // Run the task on one of the worker threads
+    template <typename Task>
+    void post(Task&& task) {
+        const auto posted_time = clock_time::now();
+        ++queued_;
+        grow_if_needed();
+        asio::post(io_context_, [this, posted_time, task = std::forward<Task>(task)]() mutable {
+            task_started(posted_time);
+            task();
+            --busy_;
+        });
+    }
+
+    const std::string& name() const { return name_; }
+    std::size_t min_threads() const { return min_threads_; }
+    std::size_t max_threads() const { return max_threads_; }
+    std::size_t max_queued() const { return max_queued_; }
+    std::size_t num_threads() const { return num_threads_.load(std::memory_order_relaxed); }
+    std::size_t pending() const { return pending_; }
+    uint64_t rejected() const { return rejected_; }
+
+    // The tasks posted and not started yet
+    std::size_t queued() const { return queued_; }
+
+    // The moving average of the time spent by the last tasks between posting and starting
+    std::chrono::nanoseconds queue_wait() const { return std::chrono::nanoseconds{queue_wait_ns_.load(std::memory_order_relaxed)}; }
+
+    // The fraction of threads blocked waiting for remote reads
+    double blocked_ratio() const;
+
+private:
+    friend class BlockedWorker;
+
+    void release() { --pending_; }
+
+    void task_started(uint64_t posted_time);
+
+    void grow_if_needed();
+
+    // Start a new thread, the mutex must be held
+    void add_thread();
+
+    void run_thread();
+
+    const std::string name_;
+    const std::size_t min_threads_;
+    const std::size_t max_threads_;
+    const std::size_t max_queued_;
+    const std::vector<std::size_t> cpus_;
+
+    asio::io_context io_context_;
+    asio::executor_work_guard<asio::io_context::executor_type> work_guard_;
+
+    // Threads are added by any thread posting tasks and removed by themselves, the exited ones are joined later
+    std::mutex mutex_;
+    std::map<std::thread::id, std::thread> threads_;
+    std::vector<std::thread> exited_;
+    bool stopping_{false};
+
+    std::atomic<std::size_t> num_threads_{0};
+    std::atomic<std::size_t> queued_{0};
+    std::atomic<std::size_t> busy_{0};
+    std::atomic<std::size_t> blocked_{0};
+    std::atomic<uint64_t> queue_wait_ns_{0};
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<uint64_t> rejected_{0};
+};
+
+// Count the calling thread as blocked waiting for a remote read during its lifetime, if the thread belongs to a worker pool
+class BlockedWorker {
+public:
+    BlockedWorker();
+    ~BlockedWorker();
+
+    BlockedWorker(const BlockedWorker&) = delete;
+    BlockedWorker& operator=(const BlockedWorker&) = delete;
+
+private:
+    WorkerPool* pool_;
+};
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_COMMON_WORKER_POOL_HPP_
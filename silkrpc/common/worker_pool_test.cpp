@@ -0,0 +1,96 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "worker_pool.hpp"
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("worker pool slots", "[silkrpc][common][worker_pool]") {
+    WorkerPool pool{"evm", 1, 1};
+    CHECK(pool.name() == "evm");
+    CHECK(pool.num_threads() == 1);
+    CHECK(pool.max_queued() == 1);
+
+    auto slot1 = pool.try_acquire();
+    auto slot2 = pool.try_acquire();
+    CHECK(slot1);
+    CHECK(slot2);
+    CHECK(!pool.try_acquire());
+    CHECK(pool.pending() == 2);
+    CHECK(pool.rejected() == 1);
+
+    slot1.reset();
+    CHECK(pool.pending() == 1);
+    CHECK(pool.try_acquire());
+    CHECK(pool.pending() == 1);
+}
+
+TEST_CASE("worker pool tasks", "[silkrpc][common][worker_pool]") {
+    WorkerPool pool{"test", 2, 0};
+
+    std::promise<std::thread::id> task_thread;
+    pool.post([&]() { task_thread.set_value(std::this_thread::get_id()); });
+    CHECK(task_thread.get_future().get() != std::this_thread::get_id());
+    CHECK(pool.queued() == 0);
+    CHECK(pool.blocked_ratio() == 0.0);
+
+    // Move-only tasks are accepted as well
+    std::promise<int> result;
+    auto value = std::make_unique<int>(42);
+    pool.post([&, value = std::move(value)]() { result.set_value(*value); });
+    CHECK(result.get_future().get() == 42);
+}
+
+TEST_CASE("worker pool growth", "[silkrpc][common][worker_pool]") {
+    // The first task blocks the only thread as if waiting for a remote read, until the second task runs
+    std::promise<void> first_blocked;
+    std::promise<void> second_done;
+    auto second_done_future = second_done.get_future().share();
+    const auto post_tasks = [&](WorkerPool& pool) {
+        pool.post([&, second_done_future]() {
+            BlockedWorker blocked_worker;
+            first_blocked.set_value();
+            second_done_future.wait_for(std::chrono::seconds{1});
+        });
+        first_blocked.get_future().wait();
+        CHECK(pool.blocked_ratio() == 1.0);
+        pool.post([&]() { second_done.set_value(); });
+    };
+
+    SECTION("adaptive pool grows when threads are blocked") {
+        WorkerPool pool{"adaptive", 1, 2, 8};
+        post_tasks(pool);
+        CHECK(pool.num_threads() == 2);
+        CHECK(second_done_future.wait_for(std::chrono::milliseconds{500}) == std::future_status::ready);
+    }
+
+    SECTION("fixed pool does not grow") {
+        WorkerPool pool{"fixed", 1, 8};
+        post_tasks(pool);
+        CHECK(pool.num_threads() == 1);
+        CHECK(second_done_future.wait_for(std::chrono::milliseconds{100}) == std::future_status::timeout);
+    }
+}
+
+} // namespace silkrpc
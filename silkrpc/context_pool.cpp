@@ -16,11 +16,18 @@
 
 #include "context_pool.hpp"
 
+#include <algorithm>
+#include <random>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <utility>
 
+#include <asio/post.hpp>
+
+#include <silkrpc/common/affinity.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/metrics.hpp>
 #include <silkrpc/ethdb/kv/remote_database.hpp>
 #include <silkrpc/ethbackend/backend_grpc.hpp>
 
@@ -34,17 +41,40 @@ std::ostream& operator<<(std::ostream& out, const Context& c) {
         << " backend: " << &*c.backend
         << " miner: " << &*c.miner
         << " txpool: " << &*c.tx_pool
-        << " cache: " << &*c.block_cache;
+        << " cache: " << &*c.block_cache
+        << " replies: " << &*c.reply_cache
+        << " subscriptions: " << &*c.subscription_manager
+        << " compressors: " << &*c.compressor_pool
+        << " coalescer: " << &*c.request_coalescer
+        << " timers: " << &*c.timer_wheel
+        << " load: " << &*c.load;
     return out;
 }
 
-ContextPool::ContextPool(std::size_t pool_size, ChannelFactory create_channel) : next_index_{0} {
+ContextSelection parse_context_selection(const std::string& name) {
+    if (name == "round_robin") {
+        return ContextSelection::kRoundRobin;
+    } else if (name == "least_loaded") {
+        return ContextSelection::kLeastLoaded;
+    } else if (name == "power_of_two") {
+        return ContextSelection::kPowerOfTwoChoices;
+    }
+    throw std::invalid_argument{"invalid context selection: " + name};
+}
+
+ContextPool::ContextPool(std::size_t pool_size, ChannelFactory create_channel, std::chrono::milliseconds request_timeout,
+    ContextSelection selection, bool single_thread, std::size_t max_pooled_transactions)
+    : selection_{selection}, single_thread_{single_thread}, next_index_{0} {
     if (pool_size == 0) {
         throw std::logic_error("ContextPool::ContextPool pool_size is 0");
     }
-    SILKRPC_INFO << "ContextPool::ContextPool creating pool with size: " << pool_size << "\n";
+    SILKRPC_INFO << "ContextPool::ContextPool creating pool with size: " << pool_size << " request timeout: " << request_timeout.count() << "ms\n";
 
     auto block_cache = std::make_shared<silkrpc::BlockCache>(1024);
+    auto reply_cache = std::make_shared<silkrpc::ReplyCache>(kReplyCacheSize);
+
+    // The pooled transactions of all the contexts are rotated together, whichever context observes a new block first
+    auto head_generation = std::make_shared<ethdb::kv::HeadGeneration>();
 
     // Create all the io_contexts and give them work to do so that their event loop will not exit until they are explicitly stopped.
     for (std::size_t i{0}; i < pool_size; ++i) {
@@ -52,33 +82,62 @@ ContextPool::ContextPool(std::size_t pool_size, ChannelFactory create_channel) :
         auto grpc_channel = create_channel();
         auto grpc_queue = std::make_unique<grpc::CompletionQueue>();
         auto grpc_runner = std::make_unique<CompletionRunner>(*grpc_queue, *io_context);
-        auto database = std::make_unique<ethdb::kv::RemoteDatabase<>>(*io_context, grpc_channel, grpc_queue.get()); // TODO(canepat): move elsewhere
+        auto timer_wheel = std::make_unique<TimerWheel>(*io_context, kTimerWheelTick, kTimerWheelSlots);
+        timer_wheel->start();
+        auto database = std::make_unique<ethdb::kv::RemoteDatabase<>>(*io_context, grpc_channel, grpc_queue.get(), request_timeout,
+            max_pooled_transactions, head_generation, timer_wheel.get()); // TODO(canepat): move elsewhere
         auto backend = std::make_unique<ethbackend::BackEndGrpc>(*io_context, grpc_channel, grpc_queue.get()); // TODO(canepat): move elsewhere
         auto miner = std::make_unique<txpool::Miner>(*io_context, grpc_channel, grpc_queue.get()); // TODO(canepat): move elsewhere
         auto tx_pool = std::make_unique<txpool::TransactionPool>(*io_context, grpc_channel, grpc_queue.get()); // TODO(canepat): move elsewhere
+        auto subscription_manager = std::make_unique<subscriptions::SubscriptionManager>(*io_context, grpc_channel, grpc_queue.get(), *database);
+        if (max_pooled_transactions > 0 && i == 0) {
+            // One headers stream is enough to rotate the pooled transactions of all the contexts, sharing the head generation
+            asio::post(*io_context, [subscription_manager = subscription_manager.get()]() {
+                subscription_manager->rotate_on_new_heads();
+            });
+        }
         contexts_.push_back({
             io_context,
             std::move(grpc_queue),
             std::move(grpc_runner),
+            std::move(timer_wheel),
             std::move(database),
             std::move(backend),
             std::move(miner),
             std::move(tx_pool),
-            block_cache
+            block_cache,
+            reply_cache,
+            std::move(subscription_manager),
+            std::make_unique<http::CompressorPool>(),
+            std::make_unique<http::RequestCoalescer>(),
+            std::make_unique<ContextLoad>()
         });
         SILKRPC_DEBUG << "ContextPool::ContextPool context[" << i << "] " << contexts_[i] << "\n";
         work_.push_back(asio::require(io_context->get_executor(), asio::execution::outstanding_work.tracked));
     }
+
+    metrics_collector_id_ = Metrics::add_collector([this](std::vector<MetricSample>& samples) { collect_metrics(samples); });
+}
+
+ContextPool::~ContextPool() {
+    Metrics::remove_collector(metrics_collector_id_);
 }
 
 void ContextPool::run() {
-    // Create a pool of threads to run all of the contexts (each one having 1+1 threads)
+    // Create a pool of threads to run all of the contexts (each one having 1+1 threads or just 1 in single-thread mode)
     asio::detail::thread_group workers{};
     for (std::size_t i{0}; i < contexts_.size(); ++i) {
         auto& context = contexts_[i];
-        workers.create_thread([&]() { context.grpc_runner->run(); });
+        // Both threads of the context share its CPUs, so the completion handoff stays within the same caches
+        const auto cpus = partition_cpus(cpus_, contexts_.size(), i);
+        if (single_thread_) {
+            workers.create_thread([&, cpus]() { pin_current_thread(cpus); context.grpc_runner->run_with_io_context(); });
+            SILKRPC_DEBUG << "ContextPool::run context[" << i << "] started: " << &*context.io_context << "\n";
+            continue;
+        }
+        workers.create_thread([&, cpus]() { pin_current_thread(cpus); context.grpc_runner->run(); });
         SILKRPC_DEBUG << "ContextPool::run context[" << i << "].grpc_runner started: " << &*context.grpc_runner << "\n";
-        workers.create_thread([&]() { context.io_context->run(); });
+        workers.create_thread([&, cpus]() { pin_current_thread(cpus); context.io_context->run(); });
         SILKRPC_DEBUG << "ContextPool::run context[" << i << "].io_context started: " << &*context.io_context << "\n";
     }
 
@@ -102,11 +161,82 @@ void ContextPool::stop() {
     SILKRPC_DEBUG << "ContextPool::stop completed\n";
 }
 
+void ContextPool::collect_metrics(std::vector<MetricSample>& samples) const {
+    const auto pool_label = "pool=\"" + name_ + "\"";
+
+    // Caches are shared by all the contexts, so the first one is enough
+    const auto& context = contexts_.front();
+    const auto block_cache_hits = static_cast<double>(context.block_cache->num_hits());
+    const auto block_cache_misses = static_cast<double>(context.block_cache->num_misses());
+    const auto reply_cache_hits = static_cast<double>(context.reply_cache->num_hits());
+    const auto reply_cache_misses = static_cast<double>(context.reply_cache->num_misses());
+    samples.push_back({"silkrpc_cache_hits_total", "counter", "Number of cache lookups finding the entry", pool_label + ",cache=\"block\"", block_cache_hits});
+    samples.push_back({"silkrpc_cache_misses_total", "counter", "Number of cache lookups missing the entry", pool_label + ",cache=\"block\"", block_cache_misses});
+    samples.push_back({"silkrpc_cache_hits_total", "counter", "Number of cache lookups finding the entry", pool_label + ",cache=\"reply\"", reply_cache_hits});
+    samples.push_back({"silkrpc_cache_misses_total", "counter", "Number of cache lookups missing the entry", pool_label + ",cache=\"reply\"", reply_cache_misses});
+
+    // The delay of the timer wheel ticks tells how long ready handlers wait to run, since asio does not expose the queue depth
+    for (std::size_t i{0}; i < contexts_.size(); ++i) {
+        const auto lag = std::chrono::duration<double>(contexts_[i].timer_wheel->lag()).count();
+        const auto& load = *contexts_[i].load;
+        const auto labels = pool_label + ",context=\"" + std::to_string(i) + "\"";
+        samples.push_back({"silkrpc_io_context_lag_seconds", "gauge", "Delay of the last or overdue timer tick on each io_context", labels, lag});
+        samples.push_back({"silkrpc_context_connections", "gauge", "Number of connections served by each context", labels,
+                           static_cast<double>(load.connections.load(std::memory_order_relaxed))});
+        samples.push_back({"silkrpc_context_requests", "gauge", "Number of requests in flight on each context", labels,
+                           static_cast<double>(load.requests.load(std::memory_order_relaxed))});
+    }
+}
+
+std::size_t ContextPool::load(const Context& context) {
+    const auto lag = std::chrono::duration_cast<std::chrono::milliseconds>(context.timer_wheel->lag()).count();
+    return context.load->connections.load(std::memory_order_relaxed) + context.load->requests.load(std::memory_order_relaxed)
+        + static_cast<std::size_t>(std::max<int64_t>(lag, 0));
+}
+
 Context& ContextPool::get_context() {
-    // Use a round-robin scheme to choose the next context to use
-    auto& context = contexts_[next_index_];
-    next_index_ = ++next_index_ % contexts_.size();
-    return context;
+    switch (selection_) {
+        case ContextSelection::kLeastLoaded:
+            return get_least_loaded_context();
+        case ContextSelection::kPowerOfTwoChoices:
+            return get_power_of_two_context();
+        default:
+            // Use a round-robin scheme to choose the next context to use
+            return contexts_[next_index_.fetch_add(1, std::memory_order_relaxed) % contexts_.size()];
+    }
+}
+
+Context& ContextPool::get_least_loaded_context() {
+    // Loads are just sampled, so concurrent choices may pick the same context: good enough to avoid piling up
+    const auto start_index = next_index_.fetch_add(1, std::memory_order_relaxed);
+    auto* least_loaded = &contexts_[start_index % contexts_.size()];
+    auto least_load = load(*least_loaded);
+    for (std::size_t i{1}; i < contexts_.size() && least_load > 0; ++i) {
+        auto& context = contexts_[(start_index + i) % contexts_.size()];
+        const auto context_load = load(context);
+        if (context_load < least_load) {
+            least_loaded = &context;
+            least_load = context_load;
+        }
+    }
+    return *least_loaded;
+}
+
+Context& ContextPool::get_power_of_two_context() {
+    // Comparing two random contexts is almost as good as scanning them all, without herding on the least loaded one
+    if (contexts_.size() == 1) {
+        return contexts_.front();
+    }
+    thread_local std::minstd_rand random_engine{std::random_device{}()};
+    std::uniform_int_distribution<std::size_t> distribution{0, contexts_.size() - 1};
+    const auto first_index = distribution(random_engine);
+    auto second_index = distribution(random_engine);
+    if (second_index == first_index) {
+        second_index = (first_index + 1) % contexts_.size();
+    }
+    auto& first = contexts_[first_index];
+    auto& second = contexts_[second_index];
+    return load(second) < load(first) ? second : first;
 }
 
 asio::io_context& ContextPool::get_io_context() {
@@ -17,11 +17,15 @@
 #ifndef SILKRPC_CONTEXT_POOL_HPP_
 #define SILKRPC_CONTEXT_POOL_HPP_
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <asio/io_context.hpp>
@@ -29,52 +33,124 @@
 
 #include <silkrpc/txpool/transaction_pool.hpp>
 #include <silkrpc/common/block_cache.hpp>
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/metrics.hpp>
+#include <silkrpc/common/reply_cache.hpp>
+#include <silkrpc/common/timer_wheel.hpp>
 #include <silkrpc/ethbackend/backend.hpp>
 #include <silkrpc/ethdb/database.hpp>
 #include <silkrpc/grpc/completion_runner.hpp>
+#include <silkrpc/http/compression.hpp>
+#include <silkrpc/http/request_coalescer.hpp>
+#include <silkrpc/subscriptions/subscription_manager.hpp>
 #include <silkrpc/txpool/miner.hpp>
 
 namespace silkrpc {
 
+// Load of a context, updated by its own thread and read by any thread choosing the context for new work
+struct ContextLoad {
+    std::atomic<std::size_t> connections{0};
+    std::atomic<std::size_t> requests{0};
+};
+
 struct Context {
     std::shared_ptr<asio::io_context> io_context;
     std::unique_ptr<grpc::CompletionQueue> grpc_queue;
     std::unique_ptr<CompletionRunner> grpc_runner;
+    std::unique_ptr<TimerWheel> timer_wheel; // declared before its users, so that it is destroyed after their timers
     std::unique_ptr<ethdb::Database> database;
     std::unique_ptr<ethbackend::BackEnd> backend;
     std::unique_ptr<txpool::Miner> miner;
     std::unique_ptr<txpool::TransactionPool> tx_pool;
     std::shared_ptr<BlockCache> block_cache;
+    std::shared_ptr<ReplyCache> reply_cache;
+    std::unique_ptr<subscriptions::SubscriptionManager> subscription_manager;
+    std::unique_ptr<http::CompressorPool> compressor_pool;
+    std::unique_ptr<http::RequestCoalescer> request_coalescer;
+    std::unique_ptr<ContextLoad> load;
 };
 
 std::ostream& operator<<(std::ostream& out, const Context& c);
 
 using ChannelFactory = std::function<std::shared_ptr<grpc::Channel>()>;
 
+// The policy used to choose the context serving new connections
+enum class ContextSelection {
+    kRoundRobin,
+    kLeastLoaded,
+    kPowerOfTwoChoices
+};
+
+// Parse the policy name (round_robin, least_loaded or power_of_two), throw std::invalid_argument if unknown
+ContextSelection parse_context_selection(const std::string& name);
+
 class ContextPool {
 public:
-    explicit ContextPool(std::size_t pool_size, ChannelFactory create_channel);
+    // If single_thread is true, each context runs its io_context and polls its gRPC completion queue on the same thread,
+    // otherwise the completion queue has its own thread posting the completions to the io_context.
+    // Each context database keeps up to max_pooled_transactions KV transactions open for reuse, renewed at each new block.
+    explicit ContextPool(std::size_t pool_size, ChannelFactory create_channel, std::chrono::milliseconds request_timeout = kDefaultTimeout,
+        ContextSelection selection = ContextSelection::kRoundRobin, bool single_thread = false, std::size_t max_pooled_transactions = 0);
+    ~ContextPool();
 
     ContextPool(const ContextPool&) = delete;
     ContextPool& operator=(const ContextPool&) = delete;
 
+    // Pin the threads of each context to its own group of the given CPUs, from the next run on
+    void set_cpu_affinity(std::vector<std::size_t> cpus) { cpus_ = std::move(cpus); }
+
+    // Name the pool in the labels of its metrics, so that pools serving different servers can be told apart
+    void set_name(std::string name) { name_ = std::move(name); }
+
+    const std::string& name() const { return name_; }
+
     void run();
 
     void stop();
 
+    // Choose a context according to the selection policy, it can be called from any thread
     Context& get_context();
 
+    Context& get_context(std::size_t index) { return contexts_[index]; }
+
+    std::size_t num_contexts() const { return contexts_.size(); }
+
     asio::io_context& get_io_context();
 
+    // The load of the context: connections plus requests in flight, where each millisecond of event loop lag counts as one more request
+    static std::size_t load(const Context& context);
+
 private:
+    Context& get_least_loaded_context();
+
+    Context& get_power_of_two_context();
+
+    // Add the samples of cache effectiveness and io_context responsiveness
+    void collect_metrics(std::vector<MetricSample>& samples) const;
+
     // The pool of contexts
     std::vector<Context> contexts_;
 
     // The work-tracking executors that keep the io_contexts running
     std::list<asio::execution::any_executor<>> work_;
 
-    // The next index to use for a context
-    std::size_t next_index_;
+    // The policy used to choose the context
+    ContextSelection selection_;
+
+    // Flag indicating if each context runs on just one thread
+    bool single_thread_;
+
+    // The name labelling the metrics of the pool
+    std::string name_{"default"};
+
+    // The CPUs shared out among the contexts, no affinity if empty
+    std::vector<std::size_t> cpus_;
+
+    // The next index to use for a context in round-robin, also the starting point of the least-loaded scan to spread ties
+    std::atomic<std::size_t> next_index_;
+
+    // The identifier of the metrics collector registered by this pool
+    std::size_t metrics_collector_id_;
 };
 
 } // namespace silkrpc
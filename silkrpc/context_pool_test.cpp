@@ -17,6 +17,7 @@
 #include "context_pool.hpp"
 
 #include <stdexcept>
+#include <string>
 #include <thread>
 
 #include <catch2/catch.hpp>
@@ -73,6 +74,54 @@ TEST_CASE("create context pool", "[silkrpc][context_pool]") {
     }
 }
 
+TEST_CASE("parse context selection", "[silkrpc][context_pool]") {
+    CHECK(parse_context_selection("round_robin") == ContextSelection::kRoundRobin);
+    CHECK(parse_context_selection("least_loaded") == ContextSelection::kLeastLoaded);
+    CHECK(parse_context_selection("power_of_two") == ContextSelection::kPowerOfTwoChoices);
+    CHECK_THROWS_AS(parse_context_selection("random"), std::invalid_argument);
+}
+
+TEST_CASE("select context by load", "[silkrpc][context_pool]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    SECTION("least loaded") {
+        ContextPool cp{3, create_channel, kDefaultTimeout, ContextSelection::kLeastLoaded};
+        cp.get_context(0).load->connections = 2;
+        cp.get_context(1).load->requests = 1;
+        cp.get_context(2).load->connections = 1;
+        cp.get_context(2).load->requests = 1;
+        CHECK(ContextPool::load(cp.get_context(2)) == 2);
+        for (int i{0}; i < 3; ++i) {
+            CHECK(&cp.get_context() == &cp.get_context(1));
+        }
+    }
+
+    SECTION("least loaded spreads ties") {
+        ContextPool cp{3, create_channel, kDefaultTimeout, ContextSelection::kLeastLoaded};
+        CHECK(&cp.get_context() == &cp.get_context(0));
+        CHECK(&cp.get_context() == &cp.get_context(1));
+        CHECK(&cp.get_context() == &cp.get_context(2));
+    }
+
+    SECTION("power of two choices") {
+        ContextPool cp{2, create_channel, kDefaultTimeout, ContextSelection::kPowerOfTwoChoices};
+        cp.get_context(0).load->requests = 10;
+        for (int i{0}; i < 10; ++i) {
+            CHECK(&cp.get_context() == &cp.get_context(1));
+        }
+    }
+}
+
+TEST_CASE("name context pool", "[silkrpc][context_pool]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    ContextPool cp{1, create_channel};
+    CHECK(cp.name() == "default");
+    cp.set_name("engine");
+    CHECK(cp.name() == "engine");
+    CHECK(Metrics::scrape().find(R"(silkrpc_context_requests{pool="engine",context="0"} 0)") != std::string::npos);
+}
+
 TEST_CASE("start context pool", "[silkrpc][context_pool]") {
     SILKRPC_LOG_VERBOSITY(LogLevel::None);
 
@@ -90,6 +139,21 @@ TEST_CASE("start context pool", "[silkrpc][context_pool]") {
         CHECK_NOTHROW(context_pool_thread.join());
     }
 
+    SECTION("running single-thread contexts") {
+        ContextPool cp{3, create_channel, kDefaultTimeout, ContextSelection::kRoundRobin, /*single_thread=*/true};
+        auto context_pool_thread = std::thread([&]() { cp.run(); });
+        cp.stop();
+        CHECK_NOTHROW(context_pool_thread.join());
+    }
+
+    SECTION("running pinned contexts") {
+        ContextPool cp{3, create_channel};
+        cp.set_cpu_affinity({0});
+        auto context_pool_thread = std::thread([&]() { cp.run(); });
+        cp.stop();
+        CHECK_NOTHROW(context_pool_thread.join());
+    }
+
     SECTION("with multiple runners") {
         ContextPool cp{3, create_channel};
         auto context_pool_thread1 = std::thread([&]() { cp.run(); });
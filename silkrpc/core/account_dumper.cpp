@@ -16,6 +16,7 @@
 
 #include "account_dumper.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <utility>
 
@@ -39,6 +40,18 @@
 namespace silkrpc {
 
 asio::awaitable<DumpAccounts> AccountDumper::dump_accounts(const BlockNumberOrHash& bnoh, const evmc::address& start_address, int16_t max_result, bool exclude_code, bool exclude_storage) {
+    AccountsMap accounts;
+    const AccountsConsumer collect = [&](AccountsMap& batch) -> asio::awaitable<void> {
+        accounts.merge(batch);
+        co_return;
+    };
+    auto dump = co_await dump_accounts(bnoh, start_address, max_result, exclude_code, exclude_storage, collect);
+    dump.accounts = std::move(accounts);
+    co_return dump;
+}
+
+asio::awaitable<DumpAccounts> AccountDumper::dump_accounts(const BlockNumberOrHash& bnoh, const evmc::address& start_address, int16_t max_result, bool exclude_code, bool exclude_storage,
+    const AccountsConsumer& consumer) {
     DumpAccounts dump_accounts;
     ethdb::TransactionDatabase tx_database{transaction_};
 
@@ -69,16 +82,23 @@ asio::awaitable<DumpAccounts> AccountDumper::dump_accounts(const BlockNumberOrHa
     AccountWalker walker{transaction_};
     co_await walker.walk_of_accounts(block_number + 1, start_address, collector);
 
-    co_await load_accounts(tx_database, collected_data, dump_accounts, exclude_code);
-    if (!exclude_storage) {
-        co_await load_storage(block_number, dump_accounts);
+    // Code and storage are loaded just for the batch being consumed, so they are never all in memory at once
+    for (std::size_t first{0}; first < collected_data.size(); first += kAccountDumpBatchSize) {
+        const auto last{std::min(first + kAccountDumpBatchSize, collected_data.size())};
+        const std::vector<silkrpc::KeyValue> batch_data(collected_data.begin() + first, collected_data.begin() + last);
+        AccountsMap batch;
+        co_await load_accounts(tx_database, batch_data, batch, exclude_code);
+        if (!exclude_storage) {
+            co_await load_storage(block_number, batch);
+        }
+        co_await consumer(batch);
     }
 
     co_return dump_accounts;
 }
 
 asio::awaitable<void> AccountDumper::load_accounts(ethdb::TransactionDatabase& tx_database,
-    const std::vector<silkrpc::KeyValue>& collected_data, DumpAccounts& dump_accounts, bool exclude_code) {
+    const std::vector<silkrpc::KeyValue>& collected_data, AccountsMap& accounts, bool exclude_code) {
 
     StateReader state_reader{tx_database};
     for (auto kv : collected_data) {
@@ -104,16 +124,16 @@ asio::awaitable<void> AccountDumper::load_accounts(ethdb::TransactionDatabase& t
             auto code = co_await state_reader.read_code(account.code_hash);
             dump_account.code.swap(code);
         }
-        dump_accounts.accounts.insert(std::pair<evmc::address, DumpAccount>(address, dump_account));
+        accounts.insert(std::pair<evmc::address, DumpAccount>(address, dump_account));
     }
 
     co_return;
 }
 
-asio::awaitable<void> AccountDumper::load_storage(uint64_t block_number, DumpAccounts& dump_accounts) {
+asio::awaitable<void> AccountDumper::load_storage(uint64_t block_number, AccountsMap& accounts) {
     StorageWalker storage_walker{transaction_};
     evmc::bytes32 start_location{};
-    for (AccountsMap::iterator itr = dump_accounts.accounts.begin(); itr != dump_accounts.accounts.end(); itr++) {
+    for (AccountsMap::iterator itr = accounts.begin(); itr != accounts.end(); itr++) {
         auto& address = itr->first;
         auto& account = itr->second;
 
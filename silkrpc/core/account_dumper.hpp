@@ -17,6 +17,7 @@
 #ifndef SILKRPC_CORE_ACCOUNT_DUMPER_HPP_
 #define SILKRPC_CORE_ACCOUNT_DUMPER_HPP_
 
+#include <functional>
 #include <optional>
 #include <map>
 #include <vector>
@@ -39,8 +40,14 @@
 
 namespace silkrpc {
 
+// Max number of accounts loaded together, including their code and storage, when dumping them batch by batch
+constexpr const std::size_t kAccountDumpBatchSize{16};
+
 class AccountDumper {
 public:
+    // Consumer of each batch of dumped accounts, in address order
+    using AccountsConsumer = std::function<asio::awaitable<void>(AccountsMap&)>;
+
     explicit AccountDumper(silkrpc::ethdb::Transaction& transaction) : transaction_(transaction) {}
 
     AccountDumper(const AccountDumper&) = delete;
@@ -48,9 +55,13 @@ public:
 
     asio::awaitable<DumpAccounts> dump_accounts(const BlockNumberOrHash& bnoh, const evmc::address& start_address, int16_t max_result, bool exclude_code, bool exclude_storage);
 
+    // Hand the accounts over to the consumer batch by batch instead of collecting them: the returned dump has no accounts
+    asio::awaitable<DumpAccounts> dump_accounts(const BlockNumberOrHash& bnoh, const evmc::address& start_address, int16_t max_result, bool exclude_code, bool exclude_storage,
+        const AccountsConsumer& consumer);
+
 private:
-    asio::awaitable<void> load_accounts(ethdb::TransactionDatabase& tx_database, const std::vector<silkrpc::KeyValue>& collected_data, DumpAccounts& dump_accounts, bool exclude_code);
-    asio::awaitable<void> load_storage(uint64_t block_number, DumpAccounts& dump_accounts);
+    asio::awaitable<void> load_accounts(ethdb::TransactionDatabase& tx_database, const std::vector<silkrpc::KeyValue>& collected_data, AccountsMap& accounts, bool exclude_code);
+    asio::awaitable<void> load_storage(uint64_t block_number, AccountsMap& accounts);
 
     silkrpc::ethdb::Transaction& transaction_;
 };
@@ -568,6 +568,28 @@ TEST_CASE("account dumper") {
         CHECK(storage[0x0178b166a1bcfd299a6ce6918f016c8d0c52788988d89f65f5727c2fa97be6e9_bytes32] == *silkworm::from_hex("1e80355e00"));
         CHECK(storage[0xb797965b738ad51ddbf643b315d0421c26972862ca2e64304783dc8930a2b6e8_bytes32] == *silkworm::from_hex("ee6b2800"));
     }
+
+    SECTION("3 result, consumed by batch") {
+        int16_t max_result = 3;
+        bool exclude_code = false;
+        bool exclude_storage = false;
+        std::vector<evmc::address> consumed_addresses;
+        std::size_t num_batches{0};
+        const AccountDumper::AccountsConsumer consumer = [&](AccountsMap& accounts) -> asio::awaitable<void> {
+            for (const auto& [address, account] : accounts) {
+                consumed_addresses.push_back(address);
+            }
+            ++num_batches;
+            co_return;
+        };
+        auto result = asio::co_spawn(pool, ad.dump_accounts(bnoh, start_address, max_result, exclude_code, exclude_storage, consumer), asio::use_future);
+        const DumpAccounts &da = result.get();
+
+        CHECK(da.root == root);
+        CHECK(da.accounts.empty());
+        CHECK(num_batches == 1);
+        CHECK(consumed_addresses == std::vector<evmc::address>{address_1, address_2, address_3});
+    }
 }
 
 }  // namespace silkrpc
@@ -49,4 +49,9 @@ asio::awaitable<uint64_t> get_latest_block_number(const core::rawdb::DatabaseRea
     co_return latest_block_number;
 }
 
+asio::awaitable<bool> is_block_finalized(uint64_t block_number, const core::rawdb::DatabaseReader& reader) {
+    const auto latest_block_number = co_await get_latest_block_number(reader);
+    co_return latest_block_number >= kFinalityDepth && block_number <= latest_block_number - kFinalityDepth;
+}
+
 } // namespace silkrpc::core
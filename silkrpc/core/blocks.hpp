@@ -33,6 +33,9 @@ constexpr const char* kPendingBlockId{"pending"};
 
 constexpr uint64_t kEarliestBlockNumber{0ul};
 
+// Number of confirmations after which a block is considered safe from reorganizations
+constexpr uint64_t kFinalityDepth{64ul};
+
 asio::awaitable<uint64_t> get_block_number(const std::string& block_id, const core::rawdb::DatabaseReader& reader);
 
 asio::awaitable<uint64_t> get_current_block_number(const core::rawdb::DatabaseReader& reader);
@@ -41,6 +44,8 @@ asio::awaitable<uint64_t> get_highest_block_number(const core::rawdb::DatabaseRe
 
 asio::awaitable<uint64_t> get_latest_block_number(const core::rawdb::DatabaseReader& reader);
 
+asio::awaitable<bool> is_block_finalized(uint64_t block_number, const core::rawdb::DatabaseReader& reader);
+
 } // namespace silkrpc::core
 
 #endif  // SILKRPC_CORE_BLOCKS_HPP_
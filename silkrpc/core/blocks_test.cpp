@@ -123,5 +123,35 @@ TEST_CASE("get_latest_block_number", "[silkrpc][core][blocks]") {
     CHECK(result.get() == 0x0000ddff12345678);
 }
 
+TEST_CASE("is_block_finalized", "[silkrpc][core][blocks]") {
+    const silkworm::ByteView kExecutionStage{stages::kExecution};
+    MockDatabaseReader db_reader;
+    asio::thread_pool pool{1};
+
+    SECTION("chain shorter than finality depth") {
+        EXPECT_CALL(db_reader, get(db::table::kSyncStageProgress, kExecutionStage)).WillOnce(InvokeWithoutArgs(
+            []() -> asio::awaitable<KeyValue> { co_return KeyValue{silkworm::Bytes{}, *silkworm::from_hex("000000000000000a")}; }
+        ));
+        auto result = asio::co_spawn(pool, is_block_finalized(0, db_reader), asio::use_future);
+        CHECK(!result.get());
+    }
+
+    SECTION("block deep enough") {
+        EXPECT_CALL(db_reader, get(db::table::kSyncStageProgress, kExecutionStage)).WillOnce(InvokeWithoutArgs(
+            []() -> asio::awaitable<KeyValue> { co_return KeyValue{silkworm::Bytes{}, *silkworm::from_hex("0000000000001000")}; }
+        ));
+        auto result = asio::co_spawn(pool, is_block_finalized(0x1000 - kFinalityDepth, db_reader), asio::use_future);
+        CHECK(result.get());
+    }
+
+    SECTION("block near the head") {
+        EXPECT_CALL(db_reader, get(db::table::kSyncStageProgress, kExecutionStage)).WillOnce(InvokeWithoutArgs(
+            []() -> asio::awaitable<KeyValue> { co_return KeyValue{silkworm::Bytes{}, *silkworm::from_hex("0000000000001000")}; }
+        ));
+        auto result = asio::co_spawn(pool, is_block_finalized(0x1000 - kFinalityDepth + 1, db_reader), asio::use_future);
+        CHECK(!result.get());
+    }
+}
+
 } // namespace silkrpc::core
 
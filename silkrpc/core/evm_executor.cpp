@@ -31,6 +31,7 @@
 #include <silkworm/common/util.hpp>
 
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/metrics.hpp>
 #include <silkrpc/common/util.hpp>
 
 namespace silkrpc {
@@ -189,7 +190,8 @@ asio::awaitable<ExecutionResult> EVMExecutor<WorldState, VM>::call(const silkwor
     const auto exec_result = co_await asio::async_compose<decltype(asio::use_awaitable), void(ExecutionResult)>(
         [this, &block, &txn](auto&& self) {
             SILKRPC_TRACE << "EVMExecutor::call post block: " << block.header.number << " txn: " << &txn << "\n";
-            asio::post(workers_, [this, &block, &txn, self = std::move(self)]() mutable {
+            workers_.post([this, &block, &txn, self = std::move(self)]() mutable {
+                WorkerTaskTimer task_timer;
                 WorldState state{buffer_};
                 VM evm{block, state, config_};
 
@@ -22,13 +22,13 @@
 #include <silkrpc/config.hpp> // NOLINT(build/include_order)
 
 #include <asio/awaitable.hpp>
-#include <asio/thread_pool.hpp>
 #include <silkworm/execution/evm.hpp>
 #include <silkworm/chain/config.hpp>
 #include <silkworm/common/util.hpp>
 #include <silkworm/types/block.hpp>
 #include <silkworm/types/transaction.hpp>
 
+#include <silkrpc/common/worker_pool.hpp>
 #include <silkrpc/context_pool.hpp>
 #include <silkrpc/core/remote_buffer.hpp>
 #include <silkrpc/core/rawdb/accessors.hpp>
@@ -47,7 +47,7 @@ class EVMExecutor {
 public:
     static std::string get_error_message(int64_t error_code, const silkworm::Bytes& error_data);
 
-    explicit EVMExecutor(const Context& context, const core::rawdb::DatabaseReader& db_reader, const silkworm::ChainConfig& config, asio::thread_pool& workers, uint64_t block_number)
+    explicit EVMExecutor(const Context& context, const core::rawdb::DatabaseReader& db_reader, const silkworm::ChainConfig& config, WorkerPool& workers, uint64_t block_number)
     : context_(context), db_reader_(db_reader), config_(config), workers_{workers}, buffer_{*context.io_context, db_reader, block_number} {}
     virtual ~EVMExecutor() {}
 
@@ -62,7 +62,7 @@ private:
     const Context& context_;
     const core::rawdb::DatabaseReader& db_reader_;
     const silkworm::ChainConfig& config_;
-    asio::thread_pool& workers_;
+    WorkerPool& workers_;
     state::RemoteBuffer buffer_;
 };
 
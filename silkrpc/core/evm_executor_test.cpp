@@ -21,7 +21,6 @@
 #include <vector>
 
 #include <asio/co_spawn.hpp>
-#include <asio/thread_pool.hpp>
 #include <asio/use_future.hpp>
 #include <catch2/catch.hpp>
 #include <evmc/evmc.hpp>
@@ -58,7 +57,7 @@ TEST_CASE("EVMexecutor") {
 
         ChannelFactory my_channel = []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); };
         ContextPool my_pool{1, my_channel};
-        asio::thread_pool workers{1};
+        WorkerPool workers{"test", 1, 0};
         auto pool_thread = std::thread([&]() { my_pool.run(); });
 
         const auto block_number = 10000;
@@ -83,7 +82,7 @@ TEST_CASE("EVMexecutor") {
 
         ChannelFactory my_channel = []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); };
         ContextPool my_pool{1, my_channel};
-        asio::thread_pool workers{1};
+        WorkerPool workers{"test", 1, 0};
         auto pool_thread = std::thread([&]() { my_pool.run(); });
 
         const auto block_number = 6000000;
@@ -110,7 +109,7 @@ TEST_CASE("EVMexecutor") {
 
         ChannelFactory my_channel = []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); };
         ContextPool my_pool{1, my_channel};
-        asio::thread_pool workers{1};
+        WorkerPool workers{"test", 1, 0};
         auto pool_thread = std::thread([&]() { my_pool.run(); });
 
         const auto block_number = 6000000;
@@ -138,7 +137,7 @@ TEST_CASE("EVMexecutor") {
 
         ChannelFactory my_channel = []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); };
         ContextPool my_pool{1, my_channel};
-        asio::thread_pool workers{1};
+        WorkerPool workers{"test", 1, 0};
         auto pool_thread = std::thread([&]() { my_pool.run(); });
 
         const auto block_number = 6000000;
@@ -166,7 +165,7 @@ TEST_CASE("EVMexecutor") {
 
         ChannelFactory my_channel = []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); };
         ContextPool my_pool{1, my_channel};
-        asio::thread_pool workers{1};
+        WorkerPool workers{"test", 1, 0};
         auto pool_thread = std::thread([&]() { my_pool.run(); });
 
         const auto block_number = 6000000;
@@ -0,0 +1,74 @@
+/*
+   Copyright 2020 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "logs.hpp"
+
+#include <algorithm>
+
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
+
+namespace silkrpc::core {
+
+std::vector<Log> filter_logs(const std::vector<Log>& logs, const Filter& filter) {
+    std::vector<Log> filtered_logs;
+
+    auto addresses = filter.addresses;
+    auto topics = filter.topics;
+    SILKRPC_DEBUG << "filter.addresses: " << filter.addresses << "\n";
+    for (auto log : logs) {
+        SILKRPC_DEBUG << "log: " << log << "\n";
+        if (addresses.has_value() && std::find(addresses.value().begin(), addresses.value().end(), log.address) == addresses.value().end()) {
+            SILKRPC_DEBUG << "skipped log for address: 0x" << silkworm::to_hex(log.address) << "\n";
+            continue;
+        }
+        auto matches = true;
+        if (topics.has_value()) {
+            if (topics.value().size() > log.topics.size()) {
+                SILKRPC_DEBUG << "#topics: " << topics.value().size() << " #log.topics: " << log.topics.size() << "\n";
+                continue;
+            }
+            for (size_t i{0}; i < topics.value().size(); i++) {
+                SILKRPC_DEBUG << "log.topics[i]: " << log.topics[i] << "\n";
+                auto subtopics = topics.value()[i];
+                auto matches_subtopics = subtopics.empty(); // empty rule set == wildcard
+                SILKRPC_TRACE << "matches_subtopics: " << std::boolalpha << matches_subtopics << "\n";
+                for (auto topic : subtopics) {
+                    SILKRPC_DEBUG << "topic: " << topic << "\n";
+                    if (log.topics[i] == topic) {
+                        matches_subtopics = true;
+                        SILKRPC_TRACE << "matches_subtopics: " << matches_subtopics << "\n";
+                        break;
+                    }
+                }
+                if (!matches_subtopics) {
+                    SILKRPC_TRACE << "No subtopic matches\n";
+                    matches = false;
+                    break;
+                }
+            }
+        }
+        SILKRPC_DEBUG << "matches: " << matches << "\n";
+        if (matches) {
+            filtered_logs.push_back(log);
+        }
+    }
+    return filtered_logs;
+}
+
+} // namespace silkrpc::core
@@ -0,0 +1,31 @@
+/*
+   Copyright 2020 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef SILKRPC_CORE_LOGS_HPP_
+#define SILKRPC_CORE_LOGS_HPP_
+
+#include <vector>
+
+#include <silkrpc/types/filter.hpp>
+#include <silkrpc/types/log.hpp>
+
+namespace silkrpc::core {
+
+std::vector<Log> filter_logs(const std::vector<Log>& logs, const Filter& filter);
+
+} // namespace silkrpc::core
+
+#endif  // SILKRPC_CORE_LOGS_HPP_
@@ -0,0 +1,77 @@
+/*
+   Copyright 2020 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "logs.hpp"
+
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::core {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+
+TEST_CASE("filter logs", "[silkrpc][core][logs]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    const auto address1{0x00000000000000000000000000000000000000aa_address};
+    const auto address2{0x00000000000000000000000000000000000000bb_address};
+    const auto topic1{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32};
+    const auto topic2{0x0000000000000000000000000000000000000000000000000000000000000002_bytes32};
+    const std::vector<Log> logs{
+        Log{address1, {topic1}},
+        Log{address2, {topic1, topic2}},
+        Log{address2, {topic2}},
+    };
+
+    SECTION("empty filter matches all logs") {
+        CHECK(filter_logs(logs, Filter{}).size() == 3);
+    }
+
+    SECTION("filter by address") {
+        Filter filter{};
+        filter.addresses = FilterAddresses{address1};
+        const auto filtered_logs = filter_logs(logs, filter);
+        CHECK(filtered_logs.size() == 1);
+        CHECK(filtered_logs[0].address == address1);
+    }
+
+    SECTION("filter by topics") {
+        Filter filter{};
+        filter.topics = FilterTopics{{topic1}};
+        CHECK(filter_logs(logs, filter).size() == 2);
+    }
+
+    SECTION("filter by wildcard topic") {
+        Filter filter{};
+        filter.topics = FilterTopics{{}, {topic2}};
+        const auto filtered_logs = filter_logs(logs, filter);
+        CHECK(filtered_logs.size() == 1);
+        CHECK(filtered_logs[0].topics.size() == 2);
+    }
+
+    SECTION("filter by address and topics") {
+        Filter filter{};
+        filter.addresses = FilterAddresses{address2};
+        filter.topics = FilterTopics{{topic2}};
+        const auto filtered_logs = filter_logs(logs, filter);
+        CHECK(filtered_logs.size() == 1);
+        CHECK(filtered_logs[0].topics == std::vector<evmc::bytes32>{topic2});
+    }
+}
+
+} // namespace silkrpc::core
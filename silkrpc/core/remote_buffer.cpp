@@ -25,6 +25,7 @@
 #include <silkworm/common/util.hpp>
 
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/worker_pool.hpp>
 #include <silkrpc/core/blocks.hpp>
 #include <silkrpc/core/rawdb/chain.hpp>
 
@@ -83,6 +84,7 @@ std::optional<silkworm::Account> RemoteBuffer::read_account(const evmc::address&
     SILKRPC_DEBUG << "RemoteBuffer::read_account address=" << address << " start\n";
     try {
         std::future<std::optional<silkworm::Account>> result{asio::co_spawn(io_context_, async_buffer_.read_account(address), asio::use_future)};
+        BlockedWorker blocked_worker;
         const auto optional_account{result.get()};
         SILKRPC_DEBUG << "RemoteBuffer::read_account account.nonce=" << (optional_account ? optional_account->nonce : 0) << " end\n";
         return optional_account;
@@ -96,6 +98,7 @@ silkworm::ByteView RemoteBuffer::read_code(const evmc::bytes32& code_hash) const
     SILKRPC_DEBUG << "RemoteBuffer::read_code code_hash=" << code_hash << " start\n";
     try {
         std::future<silkworm::ByteView> result{asio::co_spawn(io_context_, async_buffer_.read_code(code_hash), asio::use_future)};
+        BlockedWorker blocked_worker;
         const auto code{result.get()};
         return code;
     } catch (const std::exception& e) {
@@ -108,6 +111,7 @@ evmc::bytes32 RemoteBuffer::read_storage(const evmc::address& address, uint64_t
     SILKRPC_DEBUG << "RemoteBuffer::read_storage address=" << address << " incarnation=" << incarnation << " location=" << location << " start\n";
     try {
         std::future<evmc::bytes32> result{asio::co_spawn(io_context_, async_buffer_.read_storage(address, incarnation, location), asio::use_future)};
+        BlockedWorker blocked_worker;
         const auto storage_value{result.get()};
         SILKRPC_DEBUG << "RemoteBuffer::read_storage storage_value=" << storage_value << " end\n";
         return storage_value;
@@ -126,6 +130,7 @@ std::optional<silkworm::BlockHeader> RemoteBuffer::read_header(uint64_t block_nu
     SILKRPC_DEBUG << "RemoteBuffer::read_header block_number=" << block_number << " block_hash=" << block_hash << "\n";
     try {
         std::future<std::optional<silkworm::BlockHeader>> result{asio::co_spawn(io_context_, async_buffer_.read_header(block_number, block_hash), asio::use_future)};
+        BlockedWorker blocked_worker;
         const auto optional_header{result.get()};
         SILKRPC_DEBUG << "RemoteBuffer::read_header block_number=" << block_number << " block_hash=" << block_hash << "\n";
         return optional_header;
@@ -139,6 +144,7 @@ std::optional<silkworm::BlockBody> RemoteBuffer::read_body(uint64_t block_number
     SILKRPC_DEBUG << "RemoteBuffer::read_body block_number=" << block_number << " block_hash=" << block_hash << "\n";
     try {
         std::future<std::optional<silkworm::BlockBody>> result{asio::co_spawn(io_context_, async_buffer_.read_body(block_number, block_hash), asio::use_future)};
+        BlockedWorker blocked_worker;
         const auto optional_body{result.get()};
         SILKRPC_DEBUG << "RemoteBuffer::read_body block_number=" << block_number << " block_hash=" << block_hash << "\n";
         return optional_body;
@@ -152,6 +158,7 @@ std::optional<intx::uint256> RemoteBuffer::total_difficulty(uint64_t block_numbe
     SILKRPC_DEBUG << "RemoteBuffer::total_difficulty block_number=" << block_number << " block_hash=" << block_hash << "\n";
     try {
         std::future<std::optional<intx::uint256>> result{asio::co_spawn(io_context_, async_buffer_.total_difficulty(block_number, block_hash), asio::use_future)};
+        BlockedWorker blocked_worker;
         const auto optional_total_difficulty{result.get()};
         SILKRPC_DEBUG << "RemoteBuffer::total_difficulty block_number=" << block_number << " block_hash=" << block_hash << "\n";
         return optional_total_difficulty;
@@ -23,6 +23,7 @@
 
 #include <asio/awaitable.hpp>
 #include <asio/io_context.hpp>
+#include <evmc/evmc.hpp>
 
 #include <silkrpc/ethdb/transaction.hpp>
 
@@ -37,6 +38,12 @@ public:
     Database& operator=(const Database&) = delete;
 
     virtual asio::awaitable<std::unique_ptr<Transaction>> begin() = 0;
+
+    // Begin a transaction possibly reused across requests: its snapshot may lag a bit behind the latest block
+    virtual asio::awaitable<std::unique_ptr<Transaction>> begin_pooled() { co_return co_await begin(); }
+
+    // Stop reusing the transactions begun before the given block became the chain head
+    virtual void rotate(const evmc::bytes32& /*head_hash*/) {}
 };
 
 } // namespace silkrpc::ethdb
@@ -24,6 +24,7 @@
 #include <system_error>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <asio/async_result.hpp>
 #include <asio/detail/non_const_lvalue.hpp>
@@ -51,6 +52,9 @@ using async_open_cursor = async_reply_operation<Handler, IoExecutor, uint32_t>;
 template <typename Handler, typename IoExecutor>
 using async_next = async_reply_operation<Handler, IoExecutor, const remote::Pair&>;
 
+template <typename Handler, typename IoExecutor>
+using async_next_batch = async_reply_operation<Handler, IoExecutor, std::vector<remote::Pair>>;
+
 template <typename Handler, typename IoExecutor>
 using async_seek = async_reply_operation<Handler, IoExecutor, const remote::Pair&>;
 
@@ -288,6 +292,73 @@ private:
     void* wrapper_;
 };
 
+// Pipeline a batch of NEXT requests on the Tx stream: all the NEXT messages are written back-to-back and then all
+// the replies are read in order, so a batch costs one round-trip instead of one per pair.
+template<typename Executor>
+class initiate_async_next_batch {
+public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_next_batch(KvAsioAwaitable<Executor>* self, uint32_t cursor_id, std::size_t count)
+    : self_(self), cursor_id_(cursor_id), count_(count) {}
+
+    executor_type get_executor() const noexcept { return self_->get_executor(); }
+
+    template <typename WaitHandler>
+    void operator()(WaitHandler&& handler) {
+        asio::detail::non_const_lvalue<WaitHandler> handler2(handler);
+        using op = async_next_batch<WaitHandler, Executor>;
+        typename op::ptr p = {asio::detail::addressof(handler2.value), op::ptr::allocate(handler2.value), 0};
+        wrapper_ = new op(handler2.value, self_->context_.get_executor());
+
+        next_message_.set_op(remote::Op::NEXT);
+        next_message_.set_cursor(cursor_id_);
+        pairs_.reserve(count_);
+        write_next<op>(count_);
+    }
+
+private:
+    template <typename Op>
+    void write_next(std::size_t remaining) {
+        if (remaining == 0) {
+            read_next<Op>();
+            return;
+        }
+        self_->client_.write_start(next_message_, [this, remaining](const grpc::Status& status) {
+            if (!status.ok()) {
+                auto next_batch_op = static_cast<Op*>(wrapper_);
+                next_batch_op->complete(this, make_error_code(status.error_code(), status.error_message()), {});
+                return;
+            }
+            write_next<Op>(remaining - 1);
+        });
+    }
+
+    template <typename Op>
+    void read_next() {
+        self_->client_.read_start([this](const grpc::Status& status, const remote::Pair& next_pair) {
+            auto next_batch_op = static_cast<Op*>(wrapper_);
+            if (!status.ok()) {
+                next_batch_op->complete(this, make_error_code(status.error_code(), status.error_message()), {});
+                return;
+            }
+            pairs_.push_back(next_pair);
+            if (pairs_.size() < count_) {
+                read_next<Op>();
+            } else {
+                next_batch_op->complete(this, {}, std::move(pairs_));
+            }
+        });
+    }
+
+    KvAsioAwaitable<Executor>* self_;
+    uint32_t cursor_id_;
+    std::size_t count_;
+    remote::Cursor next_message_;
+    std::vector<remote::Pair> pairs_;
+    void* wrapper_;
+};
+
 template<typename Executor>
 class initiate_async_close_cursor {
 public:
@@ -407,6 +478,11 @@ struct KvAsioAwaitable {
         return asio::async_initiate<WaitHandler, void(asio::error_code, const remote::Pair&)>(initiate_async_next{this, cursor_id}, handler);
     }
 
+    template<typename WaitHandler>
+    auto async_next_batch(uint32_t cursor_id, std::size_t count, WaitHandler&& handler) {
+        return asio::async_initiate<WaitHandler, void(asio::error_code, std::vector<remote::Pair>)>(initiate_async_next_batch{this, cursor_id, count}, handler);
+    }
+
     template<typename WaitHandler>
     auto async_close_cursor(uint32_t cursor_id, WaitHandler&& handler) {
         return asio::async_initiate<WaitHandler, void(asio::error_code, uint32_t)>(initiate_async_close_cursor{this, cursor_id}, handler);
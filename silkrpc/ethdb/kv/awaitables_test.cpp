@@ -64,6 +64,10 @@ public:
       remote::Pair seek_pair = co_await kv_awaitable_.async_next(cursor_id, asio::use_awaitable);
       co_return seek_pair;
    }
+   asio::awaitable<std::vector<remote::Pair>> async_next_batch(uint32_t cursor_id, std::size_t count) {
+      auto next_pairs = co_await kv_awaitable_.async_next_batch(cursor_id, count, asio::use_awaitable);
+      co_return next_pairs;
+   }
    asio::awaitable<uint32_t> async_close_cursor(uint32_t cursor_id) {
       uint32_t ret_cursor_id = co_await kv_awaitable_.async_close_cursor(cursor_id, asio::use_awaitable);
       co_return ret_cursor_id;
@@ -965,6 +969,103 @@ TEST_CASE("async_seek_next") {
    }
 }
 
+TEST_CASE("async_next_batch") {
+    SECTION("success with sync call") {
+       class MockStreamingClient : public AsyncTxStreamingClient {
+          void start_call(std::function<void(const grpc::Status&)> start_completed) override {}
+          void end_call(std::function<void(const grpc::Status&)> end_completed) override {}
+          void write_start(const ::remote::Cursor& cursor, std::function<void(const grpc::Status&)> write_completed) override {
+               ++pending_writes_;
+               write_completed(::grpc::Status::OK);
+          }
+          void read_start(std::function<void(const grpc::Status&, const ::remote::Pair&)> read_completed) override {
+               // All the NEXT requests must be written before the first reply is read
+               CHECK(pending_writes_ == 3);
+               ::remote::Pair next_pair;
+               next_pair.set_k(std::to_string(++reads_));
+               read_completed(::grpc::Status::OK, next_pair);
+          }
+          void completed(bool ok) override { }
+
+        private:
+          int pending_writes_{0};
+          int reads_{0};
+      };
+
+      ContextPool cp{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
+      auto context_pool_thread = std::thread([&]() { cp.run(); });
+      std::vector<remote::Pair> next_pairs;
+      try {
+        MockStreamingClient sct;
+        AwaitableWrap test{*(cp.get_context().io_context), sct };
+        auto result{asio::co_spawn(cp.get_io_context(), test.async_next_batch(1, 3), asio::use_future)};
+        next_pairs = result.get();
+       } catch (...) {
+           CHECK(false);
+       }
+       CHECK(next_pairs.size() == 3);
+       CHECK(next_pairs[0].k() == "1");
+       CHECK(next_pairs[2].k() == "3");
+       cp.stop();
+       context_pool_thread.join();
+    }
+
+    SECTION("read_start fails ") {
+       class MockStreamingClient : public AsyncTxStreamingClient {
+          void start_call(std::function<void(const grpc::Status&)> start_completed) override {}
+          void end_call(std::function<void(const grpc::Status&)> end_completed) override {}
+          void write_start(const ::remote::Cursor& cursor, std::function<void(const grpc::Status&)> write_completed) override {
+             write_completed(::grpc::Status::OK);
+          }
+          void read_start(std::function<void(const grpc::Status&, const ::remote::Pair&)> read_completed) override {
+               ::remote::Pair next_pair;
+               read_completed(::grpc::Status::CANCELLED, next_pair);
+          }
+          void completed(bool ok) override { }
+      };
+
+      ContextPool cp{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
+      auto context_pool_thread = std::thread([&]() { cp.run(); });
+      try {
+        MockStreamingClient sct;
+        AwaitableWrap test{*(cp.get_context().io_context), sct };
+        auto result{asio::co_spawn(cp.get_io_context(), test.async_next_batch(1, 3), asio::use_future)};
+        result.get();
+        CHECK(false);
+       } catch (const std::system_error& e) {
+             CHECK(e.code().value() == 1);
+       }
+       cp.stop();
+       context_pool_thread.join();
+    }
+
+    SECTION("write_start fails ") {
+       class MockStreamingClient : public AsyncTxStreamingClient {
+          void start_call(std::function<void(const grpc::Status&)> start_completed) override {}
+          void end_call(std::function<void(const grpc::Status&)> end_completed) override {}
+          void read_start(std::function<void(const grpc::Status&, const ::remote::Pair&)> read_completed) override {}
+          void write_start(const ::remote::Cursor& cursor, std::function<void(const grpc::Status&)> write_completed) override {
+             write_completed(::grpc::Status::CANCELLED);
+          }
+          void completed(bool ok) override { }
+      };
+
+      ContextPool cp{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
+      auto context_pool_thread = std::thread([&]() { cp.run(); });
+      try {
+        MockStreamingClient sct;
+        AwaitableWrap test{*(cp.get_context().io_context), sct };
+        auto result{asio::co_spawn(cp.get_io_context(), test.async_next_batch(1, 3), asio::use_future)};
+        result.get();
+        CHECK(false);
+       } catch (const std::system_error& e) {
+             CHECK(e.code().value() == 1);
+       }
+       cp.stop();
+       context_pool_thread.join();
+   }
+}
+
 TEST_CASE("async_close_cursor") {
     SECTION("success with sync call") {
        class MockStreamingClient : public AsyncTxStreamingClient {
@@ -16,13 +16,17 @@
 
 #include "remote_cursor.hpp"
 
+#include <algorithm>
+
 #include <silkrpc/common/clock_time.hpp>
+#include <silkrpc/common/metrics.hpp>
 
 namespace silkrpc::ethdb::kv {
 
 asio::awaitable<void> RemoteCursor::open_cursor(const std::string& table_name) {
     const auto start_time = clock_time::now();
     if (cursor_id_ == 0) {
+        table_name_ = table_name;
         SILKRPC_DEBUG << "RemoteCursor::open_cursor opening new cursor for table: " << table_name << "\n";
         cursor_id_ = co_await kv_awaitable_.async_open_cursor(table_name, asio::use_awaitable);
         SILKRPC_DEBUG << "RemoteCursor::open_cursor cursor: " << cursor_id_ << " for table: " << table_name << "\n";
@@ -33,8 +37,10 @@ asio::awaitable<void> RemoteCursor::open_cursor(const std::string& table_name) {
 
 asio::awaitable<KeyValue> RemoteCursor::seek(silkworm::ByteView key) {
     const auto start_time = clock_time::now();
+    reset_read_ahead();
     SILKRPC_DEBUG << "RemoteCursor::seek cursor: " << cursor_id_ << " key: " << key << "\n";
     auto seek_pair = co_await kv_awaitable_.async_seek(cursor_id_, key, asio::use_awaitable);
+    Metrics::local().record_kv_operation(table_name_, clock_time::since(start_time));
     const auto k = silkworm::bytes_of_string(seek_pair.k());
     const auto v = silkworm::bytes_of_string(seek_pair.v());
     SILKRPC_DEBUG << "RemoteCursor::seek k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
@@ -43,8 +49,10 @@ asio::awaitable<KeyValue> RemoteCursor::seek(silkworm::ByteView key) {
 
 asio::awaitable<KeyValue> RemoteCursor::seek_exact(silkworm::ByteView key) {
     const auto start_time = clock_time::now();
+    reset_read_ahead();
     SILKRPC_DEBUG << "RemoteCursor::seek_exact cursor: " << cursor_id_ << " key: " << key << "\n";
     auto seek_pair = co_await kv_awaitable_.async_seek_exact(cursor_id_, key, asio::use_awaitable);
+    Metrics::local().record_kv_operation(table_name_, clock_time::since(start_time));
     const auto k = silkworm::bytes_of_string(seek_pair.k());
     const auto v = silkworm::bytes_of_string(seek_pair.v());
     SILKRPC_DEBUG << "RemoteCursor::seek_exact k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
@@ -53,7 +61,20 @@ asio::awaitable<KeyValue> RemoteCursor::seek_exact(silkworm::ByteView key) {
 
 asio::awaitable<KeyValue> RemoteCursor::next() {
     const auto start_time = clock_time::now();
-    auto next_pair = co_await kv_awaitable_.async_next(cursor_id_, asio::use_awaitable);
+    if (read_ahead_index_ == read_ahead_pairs_.size()) {
+        read_ahead_pairs_.clear();
+        read_ahead_index_ = 0;
+        if (read_ahead_ == 1) {
+            read_ahead_pairs_.push_back(co_await kv_awaitable_.async_next(cursor_id_, asio::use_awaitable));
+        } else {
+            read_ahead_pairs_ = co_await kv_awaitable_.async_next_batch(cursor_id_, read_ahead_, asio::use_awaitable);
+        }
+        SILKRPC_DEBUG << "RemoteCursor::next read ahead: " << read_ahead_ << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
+        read_ahead_ = std::min(read_ahead_ * 2, max_read_ahead_);
+    }
+    // One sample per served pair, even if already read ahead, so that the count of KV operations is independent of batching
+    Metrics::local().record_kv_operation(table_name_, clock_time::since(start_time));
+    const auto& next_pair = read_ahead_pairs_[read_ahead_index_++];
     const auto k = silkworm::bytes_of_string(next_pair.k());
     const auto v = silkworm::bytes_of_string(next_pair.v());
     SILKRPC_DEBUG << "RemoteCursor::next k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
@@ -62,8 +83,10 @@ asio::awaitable<KeyValue> RemoteCursor::next() {
 
 asio::awaitable<silkworm::Bytes> RemoteCursor::seek_both(silkworm::ByteView key, silkworm::ByteView value) {
     const auto start_time = clock_time::now();
+    reset_read_ahead();
     SILKRPC_DEBUG << "RemoteCursor::seek_both cursor: " << cursor_id_ << " key: " << key << " subkey: " << value << "\n";
     auto seek_pair = co_await kv_awaitable_.async_seek_both(cursor_id_, key, value, asio::use_awaitable);
+    Metrics::local().record_kv_operation(table_name_, clock_time::since(start_time));
     const auto k = silkworm::bytes_of_string(seek_pair.k());
     const auto v = silkworm::bytes_of_string(seek_pair.v());
     SILKRPC_DEBUG << "RemoteCursor::seek_both k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
@@ -72,8 +95,10 @@ asio::awaitable<silkworm::Bytes> RemoteCursor::seek_both(silkworm::ByteView key,
 
 asio::awaitable<KeyValue> RemoteCursor::seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) {
     const auto start_time = clock_time::now();
+    reset_read_ahead();
     SILKRPC_DEBUG << "RemoteCursor::seek_both_exact cursor: " << cursor_id_ << " key: " << key << " subkey: " << value << "\n";
     auto seek_pair = co_await kv_awaitable_.async_seek_both_exact(cursor_id_, key, value, asio::use_awaitable);
+    Metrics::local().record_kv_operation(table_name_, clock_time::since(start_time));
     const auto k = silkworm::bytes_of_string(seek_pair.k());
     const auto v = silkworm::bytes_of_string(seek_pair.v());
     SILKRPC_DEBUG << "RemoteCursor::seek_both_exact k: " << k << " v: " << v << " c=" << cursor_id_ << " t=" << clock_time::since(start_time) << "\n";
@@ -82,6 +107,7 @@ asio::awaitable<KeyValue> RemoteCursor::seek_both_exact(silkworm::ByteView key,
 
 asio::awaitable<void> RemoteCursor::close_cursor() {
     const auto start_time = clock_time::now();
+    reset_read_ahead();
     const auto cursor_id = cursor_id_;
     if (cursor_id_ != 0) {
         SILKRPC_DEBUG << "RemoteCursor::close_cursor closing cursor: " << cursor_id_ << "\n";
@@ -93,4 +119,10 @@ asio::awaitable<void> RemoteCursor::close_cursor() {
     co_return;
 }
 
+void RemoteCursor::reset_read_ahead() {
+    read_ahead_ = 1;
+    read_ahead_pairs_.clear();
+    read_ahead_index_ = 0;
+}
+
 } // namespace silkrpc::ethdb::kv
@@ -21,12 +21,14 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <asio/awaitable.hpp>
 #include <asio/io_context.hpp>
 #include <asio/use_awaitable.hpp>
 
 #include <silkworm/common/util.hpp>
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
 #include <silkrpc/ethdb/kv/awaitables.hpp>
@@ -34,10 +36,12 @@
 
 namespace silkrpc::ethdb::kv {
 
+// Consecutive calls to next() read ahead: the NEXT batch size doubles at each refill up to max_read_ahead, so that
+// sequential walks pay one round-trip per batch. Any seek discards the pairs read ahead and restarts from one.
 class RemoteCursor : public CursorDupSort {
 public:
-    explicit RemoteCursor(KvAsioAwaitable<asio::io_context::executor_type>& kv_awaitable)
-    : kv_awaitable_(kv_awaitable), cursor_id_{0} {}
+    explicit RemoteCursor(KvAsioAwaitable<asio::io_context::executor_type>& kv_awaitable, std::size_t max_read_ahead = kMaxCursorReadAhead)
+    : kv_awaitable_(kv_awaitable), cursor_id_{0}, max_read_ahead_{max_read_ahead > 0 ? max_read_ahead : 1} {}
 
     RemoteCursor(const RemoteCursor&) = delete;
     RemoteCursor& operator=(const RemoteCursor&) = delete;
@@ -59,8 +63,15 @@ public:
     asio::awaitable<KeyValue> seek_both_exact(silkworm::ByteView key, silkworm::ByteView value) override;
 
 private:
+    void reset_read_ahead();
+
     KvAsioAwaitable<asio::io_context::executor_type>& kv_awaitable_;
     uint32_t cursor_id_;
+    std::string table_name_;
+    std::size_t max_read_ahead_;
+    std::size_t read_ahead_{1};
+    std::vector<remote::Pair> read_ahead_pairs_;
+    std::size_t read_ahead_index_{0};
 };
 
 } // namespace silkrpc::ethdb::kv
@@ -16,7 +16,10 @@
 
 #include "remote_cursor.hpp"
 
+#include <algorithm>
+#include <deque>
 #include <future>
+#include <string>
 
 #include <asio/co_spawn.hpp>
 #include <asio/use_future.hpp>
@@ -24,6 +27,8 @@
 #include <catch2/catch.hpp>
 #include <silkworm/common/util.hpp>
 
+#include <silkrpc/common/metrics.hpp>
+
 namespace silkrpc::ethdb::kv {
 
 using Catch::Matchers::Message;
@@ -489,6 +494,113 @@ TEST_CASE("RemoteCursor::next", "[silkrpc][ethdb][kv][remote_cursor]") {
     }
 }
 
+TEST_CASE("RemoteCursor::next with read ahead", "[silkrpc][ethdb][kv][remote_cursor]") {
+    // Serve a table with keys "a".."z" and keep track of the requests written but not yet replied
+    class MockStreamingClient13 : public MockBaseStreamingClient {
+    public:
+        void read_start(std::function<void(const grpc::Status&, const remote::Pair&)> read_completed) override {
+            const auto op = pending_ops_.front();
+            pending_ops_.pop_front();
+            if (op == remote::Op::SEEK) {
+                position_ = 0;
+            } else if (op == remote::Op::NEXT) {
+                ++position_;
+            }
+            remote::Pair pair;
+            pair.set_cursorid(3);
+            if ((op == remote::Op::SEEK || op == remote::Op::NEXT) && position_ < 26) {
+                pair.set_k(std::string(1, static_cast<char>('a' + position_)));
+            }
+            read_completed(grpc::Status::OK, pair);
+        }
+        void write_start(const remote::Cursor& cursor, std::function<void(const grpc::Status&)> write_completed) override {
+            pending_ops_.push_back(cursor.op());
+            max_pending_ops_ = std::max(max_pending_ops_, pending_ops_.size());
+            if (cursor.op() == remote::Op::NEXT) {
+                ++next_ops_;
+            }
+            write_completed(grpc::Status::OK);
+        }
+
+        std::deque<remote::Op> pending_ops_;
+        std::size_t max_pending_ops_{0};
+        std::size_t next_ops_{0};
+        int position_{0};
+    };
+    asio::io_context io_context;
+    MockStreamingClient13 client;
+    KvAsioAwaitable<asio::io_context::executor_type> kv_awaitable{io_context, client};
+
+    const auto run = [&](auto awaitable) {
+        auto result{asio::co_spawn(io_context, std::move(awaitable), asio::use_future)};
+        io_context.reset();
+        io_context.run();
+        return result.get();
+    };
+
+    SECTION("batch size doubles at each refill") {
+        RemoteCursor remote_cursor{kv_awaitable, 4};
+        run(remote_cursor.open_cursor("table1"));
+        CHECK(run(remote_cursor.seek(silkworm::Bytes{})).key == silkworm::bytes_of_string("a"));
+        for (char c = 'b'; c <= 'k'; ++c) {
+            CHECK(run(remote_cursor.next()).key == silkworm::bytes_of_string(std::string(1, c)));
+        }
+        // batches of 1, 2, 4, 4
+        CHECK(client.next_ops_ == 11);
+        CHECK(client.max_pending_ops_ == 4);
+        run(remote_cursor.close_cursor());
+    }
+
+    SECTION("seek discards pairs read ahead") {
+        RemoteCursor remote_cursor{kv_awaitable};
+        run(remote_cursor.open_cursor("table1"));
+        run(remote_cursor.seek(silkworm::Bytes{}));
+        for (char c = 'b'; c <= 'g'; ++c) {
+            CHECK(run(remote_cursor.next()).key == silkworm::bytes_of_string(std::string(1, c)));
+        }
+        CHECK(client.next_ops_ == 7);
+        CHECK(run(remote_cursor.seek(silkworm::Bytes{})).key == silkworm::bytes_of_string("a"));
+        CHECK(run(remote_cursor.next()).key == silkworm::bytes_of_string("b"));
+        CHECK(client.next_ops_ == 8);
+        run(remote_cursor.close_cursor());
+    }
+
+    SECTION("end of table") {
+        RemoteCursor remote_cursor{kv_awaitable};
+        run(remote_cursor.open_cursor("table1"));
+        run(remote_cursor.seek(silkworm::Bytes{}));
+        for (char c = 'b'; c <= 'z'; ++c) {
+            CHECK(run(remote_cursor.next()).key == silkworm::bytes_of_string(std::string(1, c)));
+        }
+        CHECK(run(remote_cursor.next()).key.empty());
+        run(remote_cursor.close_cursor());
+    }
+
+    SECTION("one kv operation recorded per next") {
+        RemoteCursor remote_cursor{kv_awaitable, 4};
+        run(remote_cursor.open_cursor("ReadAheadTable"));
+        run(remote_cursor.seek(silkworm::Bytes{}));
+        for (char c = 'b'; c <= 'k'; ++c) {
+            run(remote_cursor.next());
+        }
+        const auto text = Metrics::scrape();
+        CHECK(text.find("silkrpc_kv_operation_duration_seconds_count{table=\"ReadAheadTable\"} 11\n") != std::string::npos);
+        run(remote_cursor.close_cursor());
+    }
+
+    SECTION("read ahead disabled") {
+        RemoteCursor remote_cursor{kv_awaitable, 1};
+        run(remote_cursor.open_cursor("table1"));
+        run(remote_cursor.seek(silkworm::Bytes{}));
+        for (char c = 'b'; c <= 'k'; ++c) {
+            CHECK(run(remote_cursor.next()).key == silkworm::bytes_of_string(std::string(1, c)));
+        }
+        CHECK(client.next_ops_ == 10);
+        CHECK(client.max_pending_ops_ == 1);
+        run(remote_cursor.close_cursor());
+    }
+}
+
 TEST_CASE("RemoteCursor::seek_both", "[silkrpc][ethdb][kv][remote_cursor]") {
     SECTION("success w/ sync read - sync write") {
         class MockStreamingClient13 : public MockBaseStreamingClient {
@@ -17,25 +17,69 @@
 #ifndef SILKRPC_ETHDB_KV_REMOTE_DATABASE_HPP_
 #define SILKRPC_ETHDB_KV_REMOTE_DATABASE_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <vector>
 #include <utility>
 
+#include <asio/co_spawn.hpp>
+#include <asio/detached.hpp>
 #include <asio/io_context.hpp>
+#include <evmc/evmc.hpp>
 
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/timer_wheel.hpp>
 #include <silkrpc/ethdb/database.hpp>
 #include <silkrpc/ethdb/kv/remote_transaction.hpp>
 #include <silkrpc/ethdb/kv/tx_streaming_client.hpp>
 
 namespace silkrpc::ethdb::kv {
 
+// The chain head generation shared by the databases of all the I/O contexts: as soon as any context observes a new
+// block, the transactions pooled by every context before it are no longer handed out
+class HeadGeneration {
+public:
+    // Move to the next generation, unless the head is already known (e.g. because observed by another context)
+    void advance(const evmc::bytes32& head_hash) {
+        std::scoped_lock lock{mutex_};
+        if (head_hash != head_hash_) {
+            head_hash_ = head_hash;
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    uint64_t current() const { return generation_.load(std::memory_order_acquire); }
+
+private:
+    std::mutex mutex_;
+    evmc::bytes32 head_hash_;
+    std::atomic<uint64_t> generation_{0};
+};
+
+// Up to max_pooled_transactions idle transactions are kept open together with their cursors, so that begin_pooled
+// can skip the stream setup. They are dropped when a new block is observed (see rotate) or when too old, checking the
+// age on the timer wheel (if any) so that idle transactions do not keep their remote snapshot open without traffic.
+// All the methods must be called within the io_context thread, so no synchronization is needed apart from the
+// head generation, which may be shared with the databases of the other contexts.
 template<typename Client = TxStreamingClient>
 class RemoteDatabase: public Database {
 public:
-    RemoteDatabase(asio::io_context& io_context, std::shared_ptr<grpc::Channel> channel, grpc::CompletionQueue* queue)
-    : io_context_(io_context), stub_{remote::KV::NewStub(channel)}, queue_(queue) {
+    RemoteDatabase(asio::io_context& io_context, std::shared_ptr<grpc::Channel> channel, grpc::CompletionQueue* queue,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::zero(), std::size_t max_pooled_transactions = 0,
+        std::shared_ptr<HeadGeneration> head_generation = std::make_shared<HeadGeneration>(), TimerWheel* timer_wheel = nullptr)
+    : io_context_(io_context), stub_{remote::KV::NewStub(channel)}, queue_(queue), timeout_{timeout}, max_pooled_transactions_{max_pooled_transactions},
+      head_generation_{std::move(head_generation)} {
+        if (timer_wheel != nullptr) {
+            expiry_timer_.emplace(*timer_wheel, [this]() { expire(); });
+        }
         SILKRPC_TRACE << "RemoteDatabase::ctor " << this << "\n";
     }
 
@@ -48,16 +92,143 @@ public:
 
     asio::awaitable<std::unique_ptr<Transaction>> begin() override {
         SILKRPC_TRACE << "RemoteDatabase::begin " << this << " start\n";
-        auto txn = std::make_unique<RemoteTransaction<Client>>(io_context_, stub_, queue_);
+        auto txn = std::make_unique<RemoteTransaction<Client>>(io_context_, stub_, queue_, timeout_);
         co_await txn->open();
         SILKRPC_TRACE << "RemoteDatabase::begin " << this << " txn: " << txn.get() << " end\n";
         co_return txn;
     }
 
+    asio::awaitable<std::unique_ptr<Transaction>> begin_pooled() override {
+        if (max_pooled_transactions_ == 0) {
+            co_return co_await begin();
+        }
+        while (!idle_transactions_.empty()) {
+            auto pooled = std::move(idle_transactions_.back());
+            idle_transactions_.pop_back();
+            if (is_fresh(pooled)) {
+                SILKRPC_TRACE << "RemoteDatabase::begin_pooled " << this << " reusing txn: " << pooled.txn.get() << "\n";
+                pooled.txn->start_deadline();
+                co_return std::make_unique<PooledTransaction>(*this, std::move(pooled));
+            }
+            discard(std::move(pooled.txn));
+        }
+        // The generation is read before opening: a block observed meanwhile may already be in the snapshot or not
+        const auto generation = head_generation_->current();
+        auto txn = std::make_unique<RemoteTransaction<Client>>(io_context_, stub_, queue_, timeout_);
+        co_await txn->open();
+        SILKRPC_TRACE << "RemoteDatabase::begin_pooled " << this << " txn: " << txn.get() << " opened\n";
+        co_return std::make_unique<PooledTransaction>(*this, Pooled{std::move(txn), generation, std::chrono::steady_clock::now()});
+    }
+
+    // Drop the idle transactions opened before the given block has been observed, those in use are closed when released
+    void rotate(const evmc::bytes32& head_hash) override {
+        head_generation_->advance(head_hash);
+        drop_stale();
+    }
+
+    std::size_t num_idle_transactions() const { return idle_transactions_.size(); }
+
 private:
+    struct Pooled {
+        std::unique_ptr<RemoteTransaction<Client>> txn;
+        uint64_t generation;
+        std::chrono::steady_clock::time_point open_time;
+    };
+
+    // Close the idle transactions which cannot be handed out anymore
+    void drop_stale() {
+        std::vector<Pooled> fresh_transactions;
+        for (auto& pooled : idle_transactions_) {
+            if (is_fresh(pooled)) {
+                fresh_transactions.push_back(std::move(pooled));
+            } else {
+                discard(std::move(pooled.txn));
+            }
+        }
+        idle_transactions_ = std::move(fresh_transactions);
+    }
+
+    // Schedule the check of the oldest idle transaction age, unless already scheduled
+    void schedule_expiry() {
+        if (!expiry_timer_ || expiry_timer_->pending() || idle_transactions_.empty()) {
+            return;
+        }
+        const auto oldest = std::min_element(idle_transactions_.begin(), idle_transactions_.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.open_time < rhs.open_time;
+        });
+        const auto expiry_time = oldest->open_time + kMaxPooledTransactionAge;
+        const auto now = std::chrono::steady_clock::now();
+        const auto timeout = expiry_time > now ? std::chrono::ceil<std::chrono::milliseconds>(expiry_time - now) : std::chrono::milliseconds::zero();
+        expiry_timer_->expires_after(timeout);
+    }
+
+    void expire() {
+        drop_stale();
+        schedule_expiry();
+    }
+
+    // The transaction lent by begin_pooled: closing it gives the remote transaction back to the pool
+    class PooledTransaction : public Transaction {
+    public:
+        PooledTransaction(RemoteDatabase& database, Pooled pooled) : database_(database), pooled_{std::move(pooled)} {}
+
+        uint64_t tx_id() const override { return pooled_.txn->tx_id(); }
+
+        asio::awaitable<void> open() override { co_return; }
+
+        asio::awaitable<std::shared_ptr<Cursor>> cursor(const std::string& table) override {
+            co_return co_await pooled_.txn->cursor(table);
+        }
+
+        asio::awaitable<std::shared_ptr<CursorDupSort>> cursor_dup_sort(const std::string& table) override {
+            co_return co_await pooled_.txn->cursor_dup_sort(table);
+        }
+
+        asio::awaitable<void> close() override {
+            co_await database_.release(std::move(pooled_));
+        }
+
+    private:
+        RemoteDatabase& database_;
+        Pooled pooled_;
+    };
+
+    bool is_fresh(const Pooled& pooled) const {
+        return pooled.generation == head_generation_->current() && pooled.txn->is_reusable() &&
+            std::chrono::steady_clock::now() - pooled.open_time < kMaxPooledTransactionAge;
+    }
+
+    asio::awaitable<void> release(Pooled pooled) {
+        pooled.txn->cancel_deadline();
+        if (is_fresh(pooled) && idle_transactions_.size() < max_pooled_transactions_) {
+            idle_transactions_.push_back(std::move(pooled));
+            schedule_expiry();
+            co_return;
+        }
+        co_await pooled.txn->close();
+    }
+
+    // Close the transaction in the background, nobody is waiting for it
+    void discard(std::unique_ptr<RemoteTransaction<Client>> txn) {
+        asio::co_spawn(io_context_, close_transaction(std::move(txn)), asio::detached);
+    }
+
+    static asio::awaitable<void> close_transaction(std::unique_ptr<RemoteTransaction<Client>> txn) {
+        try {
+            co_await txn->close();
+        } catch (const std::exception& e) {
+            SILKRPC_WARN << "RemoteDatabase::close_transaction txn: " << txn.get() << " exception: " << e.what() << "\n";
+        }
+    }
+
     asio::io_context& io_context_;
     std::unique_ptr<remote::KV::StubInterface> stub_;
     grpc::CompletionQueue* queue_;
+    std::chrono::milliseconds timeout_;
+    std::size_t max_pooled_transactions_;
+    std::shared_ptr<HeadGeneration> head_generation_;
+    std::vector<Pooled> idle_transactions_;
+    std::optional<TimerWheel::Timer> expiry_timer_;
 };
 
 } // namespace silkrpc::ethdb::kv
@@ -16,19 +16,24 @@
 
 #include "remote_database.hpp"
 
+#include <chrono>
 #include <future>
 #include <system_error>
+#include <thread>
 
 #include <asio/co_spawn.hpp>
 #include <asio/use_future.hpp>
 #include <asio/io_context.hpp>
 #include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
 
+#include <silkrpc/common/timer_wheel.hpp>
 #include <silkrpc/ethdb/kv/tx_streaming_client.hpp>
 
 namespace silkrpc::ethdb::kv {
 
 using Catch::Matchers::Message;
+using evmc::literals::operator""_bytes32;
 
 TEST_CASE("RemoteDatabase::begin", "[silkrpc][ethdb][kv][remote_database]") {
     SECTION("success") {
@@ -135,4 +140,124 @@ TEST_CASE("RemoteDatabase::begin", "[silkrpc][ethdb][kv][remote_database]") {
     }
 }
 
+TEST_CASE("RemoteDatabase::begin_pooled", "[silkrpc][ethdb][kv][remote_database]") {
+    // Each new stream gets the next txid, so that reused transactions can be told apart
+    static uint64_t num_started;
+    static uint64_t num_ended;
+    static bool finished;
+    class MockStreamingClient : public AsyncTxStreamingClient {
+    public:
+        MockStreamingClient(std::unique_ptr<remote::KV::StubInterface>& /*stub*/, grpc::CompletionQueue* /*queue*/) {}
+        void start_call(std::function<void(const grpc::Status&)> start_completed) override {
+            start_completed(::grpc::Status::OK);
+        }
+        void end_call(std::function<void(const grpc::Status&)> end_completed) override {
+            ++num_ended;
+            end_completed(::grpc::Status::OK);
+        }
+        void read_start(std::function<void(const grpc::Status&, const remote::Pair&)> read_completed) override {
+            remote::Pair pair;
+            pair.set_txid(++num_started);
+            read_completed(::grpc::Status::OK, pair);
+        }
+        void write_start(const remote::Cursor& cursor, std::function<void(const grpc::Status&)> write_completed) override {}
+        void completed(bool ok) override {}
+        bool is_finished() const override { return finished; }
+    };
+    num_started = 0;
+    num_ended = 0;
+    finished = false;
+
+    asio::io_context io_context;
+    auto channel = grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials());
+    grpc::CompletionQueue queue;
+
+    const auto begin_and_close = [&](auto& remote_db) {
+        auto future_tx_id{asio::co_spawn(io_context, [&]() -> asio::awaitable<uint64_t> {
+            auto tx = co_await remote_db.begin_pooled();
+            const auto tx_id = tx->tx_id();
+            co_await tx->close();
+            co_return tx_id;
+        }, asio::use_future)};
+        io_context.restart();
+        io_context.run();
+        return future_tx_id.get();
+    };
+
+    SECTION("pooling disabled") {
+        RemoteDatabase<MockStreamingClient> remote_db(io_context, channel, &queue);
+        CHECK(begin_and_close(remote_db) == 1);
+        CHECK(begin_and_close(remote_db) == 2);
+        CHECK(num_ended == 2);
+        CHECK(remote_db.num_idle_transactions() == 0);
+    }
+
+    SECTION("transaction reused") {
+        RemoteDatabase<MockStreamingClient> remote_db(io_context, channel, &queue, std::chrono::milliseconds::zero(), 2);
+        CHECK(begin_and_close(remote_db) == 1);
+        CHECK(remote_db.num_idle_transactions() == 1);
+        CHECK(begin_and_close(remote_db) == 1);
+        CHECK(num_started == 1);
+        CHECK(num_ended == 0);
+    }
+
+    SECTION("transactions rotated on new block") {
+        RemoteDatabase<MockStreamingClient> remote_db(io_context, channel, &queue, std::chrono::milliseconds::zero(), 2);
+        CHECK(begin_and_close(remote_db) == 1);
+        remote_db.rotate(0x0000000000000000000000000000000000000000000000000000000000000001_bytes32);
+        io_context.restart();
+        io_context.run();
+        CHECK(remote_db.num_idle_transactions() == 0);
+        CHECK(num_ended == 1);
+        CHECK(begin_and_close(remote_db) == 2);
+    }
+
+    SECTION("transactions rotated on new block observed by another database") {
+        auto head_generation = std::make_shared<HeadGeneration>();
+        RemoteDatabase<MockStreamingClient> remote_db1(io_context, channel, &queue, std::chrono::milliseconds::zero(), 2, head_generation);
+        RemoteDatabase<MockStreamingClient> remote_db2(io_context, channel, &queue, std::chrono::milliseconds::zero(), 2, head_generation);
+        CHECK(begin_and_close(remote_db1) == 1);
+        remote_db2.rotate(0x0000000000000000000000000000000000000000000000000000000000000001_bytes32);
+        CHECK(remote_db1.num_idle_transactions() == 1);
+        CHECK(begin_and_close(remote_db1) == 2);
+        CHECK(num_ended == 1);
+
+        // The same head seen later by the first database does not drop the transactions opened in the meantime
+        remote_db1.rotate(0x0000000000000000000000000000000000000000000000000000000000000001_bytes32);
+        io_context.restart();
+        io_context.run();
+        CHECK(begin_and_close(remote_db1) == 2);
+    }
+
+    SECTION("idle transaction closed when too old") {
+        // The wheel is not started, it is moved forward explicitly
+        TimerWheel timer_wheel{io_context, std::chrono::milliseconds{100}, 8};
+        RemoteDatabase<MockStreamingClient> remote_db(io_context, channel, &queue, std::chrono::milliseconds::zero(), 2,
+            std::make_shared<HeadGeneration>(), &timer_wheel);
+        CHECK(begin_and_close(remote_db) == 1);
+        CHECK(remote_db.num_idle_transactions() == 1);
+        CHECK(timer_wheel.size() == 1);
+
+        // No further begin_pooled nor rotate, just time passing
+        std::this_thread::sleep_for(kMaxPooledTransactionAge);
+        for (auto i{0}; i <= kMaxPooledTransactionAge / timer_wheel.tick(); ++i) {
+            timer_wheel.advance();
+        }
+        io_context.restart();
+        io_context.run();
+        CHECK(remote_db.num_idle_transactions() == 0);
+        CHECK(num_ended == 1);
+        CHECK(timer_wheel.size() == 0);
+    }
+
+    SECTION("terminated transaction not reused") {
+        RemoteDatabase<MockStreamingClient> remote_db(io_context, channel, &queue, std::chrono::milliseconds::zero(), 2);
+        finished = true;
+        CHECK(begin_and_close(remote_db) == 1);
+        CHECK(remote_db.num_idle_transactions() == 0);
+        CHECK(num_ended == 1);
+        CHECK(begin_and_close(remote_db) == 2);
+    }
+}
+
 } // namespace silkrpc::ethdb::kv
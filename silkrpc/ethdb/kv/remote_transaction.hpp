@@ -17,6 +17,7 @@
 #ifndef SILKRPC_ETHDB_KV_REMOTE_TRANSACTION_HPP_
 #define SILKRPC_ETHDB_KV_REMOTE_TRANSACTION_HPP_
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -24,6 +25,7 @@
 
 #include <silkrpc/config.hpp>
 
+#include <asio/steady_timer.hpp>
 #include <asio/use_awaitable.hpp>
 #include <grpcpp/grpcpp.h>
 
@@ -43,8 +45,11 @@ class RemoteTransaction : public Transaction {
     static_assert(std::is_base_of<AsyncTxStreamingClient, Client>::value && !std::is_same<AsyncTxStreamingClient, Client>::value);
 
 public:
-    explicit RemoteTransaction(asio::io_context& context, std::unique_ptr<remote::KV::StubInterface>& stub, grpc::CompletionQueue* queue)
-    : context_(context), client_{stub, queue}, kv_awaitable_{context_, client_} {
+    // A non-zero timeout is the deadline for the whole transaction: when expired, the KV stream gets cancelled
+    // and any outstanding or later operation on the transaction and its cursors fails.
+    explicit RemoteTransaction(asio::io_context& context, std::unique_ptr<remote::KV::StubInterface>& stub, grpc::CompletionQueue* queue,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds::zero())
+    : context_(context), client_{stub, queue}, kv_awaitable_{context_, client_}, timeout_{timeout}, deadline_timer_{context} {
         SILKRPC_TRACE << "RemoteTransaction::ctor " << this << " start\n";
         SILKRPC_TRACE << "RemoteTransaction::ctor " << this << " end\n";
     }
@@ -57,6 +62,7 @@ public:
     uint64_t tx_id() const override { return tx_id_; }
 
     asio::awaitable<void> open() override {
+        start_deadline();
         tx_id_ = co_await kv_awaitable_.async_start(asio::use_awaitable);
         co_return;
     }
@@ -71,10 +77,36 @@ public:
 
     asio::awaitable<void> close() override {
         cursors_.clear();
+        cancel_deadline();
         co_await kv_awaitable_.async_end(asio::use_awaitable);
         co_return;
     }
 
+    // Start the deadline of the transaction, again at each reuse when pooled
+    void start_deadline() {
+        if (timeout_ == std::chrono::milliseconds::zero()) {
+            return;
+        }
+        deadline_timer_.expires_after(timeout_);
+        deadline_timer_.async_wait([this, deadline_id = deadline_id_](const asio::error_code& ec) {
+            // A deadline expired just before being cancelled must not hit the next user of a pooled transaction
+            if (ec == asio::error::operation_aborted || deadline_id != deadline_id_) {
+                return;
+            }
+            SILKRPC_WARN << "RemoteTransaction " << this << " tx_id: " << tx_id_ << " deadline expired after " << timeout_.count() << "ms\n";
+            expired_ = true;
+            client_.cancel();
+        });
+    }
+
+    void cancel_deadline() {
+        ++deadline_id_;
+        deadline_timer_.cancel();
+    }
+
+    // The transaction can serve another request unless its stream has been cancelled or terminated
+    bool is_reusable() const { return !expired_ && !client_.is_finished(); }
+
 private:
     asio::awaitable<std::shared_ptr<CursorDupSort>> get_cursor(const std::string& table) {
         auto cursor_it = cursors_.find(table);
@@ -90,8 +122,12 @@ private:
     asio::io_context& context_;
     Client client_;
     KvAsioAwaitable<asio::io_context::executor_type> kv_awaitable_;
+    std::chrono::milliseconds timeout_;
+    asio::steady_timer deadline_timer_;
     std::map<std::string, std::shared_ptr<CursorDupSort>> cursors_;
-    uint64_t tx_id_;
+    uint64_t tx_id_{0};
+    uint64_t deadline_id_{0};
+    bool expired_{false};
 };
 
 } // namespace silkrpc::ethdb::kv
@@ -16,6 +16,7 @@
 
 #include "remote_transaction.hpp"
 
+#include <chrono>
 #include <future>
 #include <system_error>
 
@@ -68,6 +69,47 @@ TEST_CASE("RemoteTransaction::open", "[silkrpc][ethdb][kv][remote_transaction]")
         }
     }
 
+    SECTION("deadline expired") {
+        class MockStreamingClient : public AsyncTxStreamingClient {
+        public:
+            MockStreamingClient(std::unique_ptr<remote::KV::StubInterface>& /*stub*/, grpc::CompletionQueue* /*queue*/) {}
+            void start_call(std::function<void(const grpc::Status&)> start_completed) override {
+                start_completed(::grpc::Status::OK);
+            }
+            void end_call(std::function<void(const grpc::Status&)> end_completed) override {}
+            void read_start(std::function<void(const grpc::Status&, const ::remote::Pair&)> read_completed) override {
+                ::remote::Pair pair;
+                pair.set_txid(4);
+                read_completed(cancelled_ ? ::grpc::Status::CANCELLED : ::grpc::Status::OK, pair);
+            }
+            void write_start(const ::remote::Cursor& cursor, std::function<void(const grpc::Status&)> write_completed) override {
+                write_completed(cancelled_ ? ::grpc::Status::CANCELLED : ::grpc::Status::OK);
+            }
+            void cancel() override { cancelled_ = true; }
+            void completed(bool ok) override {}
+        private:
+            bool cancelled_{false};
+        };
+        asio::io_context io_context;
+        auto channel = grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials());
+        std::unique_ptr<remote::KV::StubInterface> stub{remote::KV::NewStub(channel)};
+        grpc::CompletionQueue queue;
+        RemoteTransaction<MockStreamingClient> remote_tx(io_context, stub, &queue, std::chrono::milliseconds{1});
+        auto open_result{asio::co_spawn(io_context, remote_tx.open(), asio::use_future)};
+        io_context.run();
+        CHECK_NOTHROW(open_result.get());
+        CHECK(remote_tx.tx_id() == 4);
+        io_context.restart();
+        auto cursor_result{asio::co_spawn(io_context, remote_tx.cursor("table1"), asio::use_future)};
+        io_context.run();
+        try {
+            cursor_result.get();
+            CHECK(false);
+        } catch (const std::system_error& e) {
+            CHECK(e.code().value() == grpc::StatusCode::CANCELLED);
+        }
+    }
+
     SECTION("fail start_call") {
         class MockStreamingClient : public AsyncTxStreamingClient {
         public:
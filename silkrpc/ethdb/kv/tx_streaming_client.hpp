@@ -78,6 +78,13 @@ public:
         SILKRPC_TRACE << "TxStreamingClient::write_start " << this << " status: " << status_ << " end\n";
     }
 
+    void cancel() override {
+        SILKRPC_TRACE << "TxStreamingClient::cancel " << this << " status: " << status_ << "\n";
+        context_.TryCancel();
+    }
+
+    bool is_finished() const override { return finishing_; }
+
     void completed(bool ok) override {
         SILKRPC_TRACE << "TxStreamingClient::completed " << this << " status: " << status_ << " ok: " << ok << " start\n";
         if (!ok && !finishing_) {
@@ -0,0 +1,120 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_GRPC_ASYNC_SERVER_STREAMING_CLIENT_HPP_
+#define SILKRPC_GRPC_ASYNC_SERVER_STREAMING_CLIENT_HPP_
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+#include <grpcpp/grpcpp.h>
+#include <magic_enum.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/grpc/async_completion_handler.hpp>
+
+namespace silkrpc {
+
+template<
+    typename StubInterface,
+    typename Request,
+    typename Reply,
+    std::unique_ptr<grpc::ClientAsyncReaderInterface<Reply>>(StubInterface::*PrepareAsync)(grpc::ClientContext*, const Request&, grpc::CompletionQueue*)
+>
+class AsyncServerStreamingClient final : public AsyncCompletionHandler {
+    using AsyncReaderPtr = std::unique_ptr<grpc::ClientAsyncReaderInterface<Reply>>;
+
+    enum CallStatus { CALL_IDLE, CALL_STARTED, READ_STARTED, FINISH_STARTED, CALL_ENDED };
+
+public:
+    explicit AsyncServerStreamingClient(std::unique_ptr<StubInterface>& stub, grpc::CompletionQueue* queue)
+    : stub_(stub), queue_(queue) {
+        SILKRPC_TRACE << "AsyncServerStreamingClient::ctor " << this << " state: " << magic_enum::enum_name(state_) << "\n";
+    }
+
+    ~AsyncServerStreamingClient() {
+        SILKRPC_TRACE << "AsyncServerStreamingClient::dtor " << this << " state: " << magic_enum::enum_name(state_) << "\n";
+    }
+
+    /// Start the call: read_completed is invoked for each streamed reply, call_completed just once when the stream ends.
+    void async_call(const Request& request, std::function<void(const Reply&)> read_completed, std::function<void(const grpc::Status&)> call_completed) {
+        SILKRPC_TRACE << "AsyncServerStreamingClient::async_call " << this << " state: " << magic_enum::enum_name(state_) << " start\n";
+        read_completed_ = read_completed;
+        call_completed_ = call_completed;
+        reader_ = (stub_.get()->*PrepareAsync)(&context_, request, queue_);
+        state_ = CALL_STARTED;
+        reader_->StartCall(AsyncCompletionHandler::tag(this));
+        SILKRPC_TRACE << "AsyncServerStreamingClient::async_call " << this << " state: " << magic_enum::enum_name(state_) << " end\n";
+    }
+
+    /// Ask the server to terminate the stream: call_completed will be invoked with CANCELLED status.
+    void cancel() {
+        SILKRPC_TRACE << "AsyncServerStreamingClient::cancel " << this << " state: " << magic_enum::enum_name(state_) << "\n";
+        context_.TryCancel();
+    }
+
+    bool is_active() const { return state_ != CALL_IDLE && state_ != CALL_ENDED; }
+
+    void completed(bool ok) override {
+        SILKRPC_TRACE << "AsyncServerStreamingClient::completed " << this << " state: " << magic_enum::enum_name(state_) << " ok: " << ok << " start\n";
+        switch (state_) {
+            case CALL_STARTED:
+            case READ_STARTED:
+                if (state_ == READ_STARTED && ok) {
+                    read_completed_(reply_);
+                }
+                if (ok) {
+                    state_ = READ_STARTED;
+                    reader_->Read(&reply_, AsyncCompletionHandler::tag(this));
+                } else {
+                    state_ = FINISH_STARTED;
+                    reader_->Finish(&result_, AsyncCompletionHandler::tag(this));
+                }
+            break;
+            case FINISH_STARTED: {
+                if (!result_.ok()) {
+                    SILKRPC_ERROR << "AsyncServerStreamingClient::completed error_code: " << result_.error_code() << "\n";
+                    SILKRPC_ERROR << "AsyncServerStreamingClient::completed error_message: " << result_.error_message() << "\n";
+                }
+                state_ = CALL_ENDED;
+                // The completion callback is allowed to destroy this client, so do not touch any member after it
+                const auto result{result_};
+                const auto call_completed{std::move(call_completed_)};
+                call_completed(result);
+                return;
+            }
+            default:
+                throw std::runtime_error("AsyncServerStreamingClient::completed unexpected state");
+        }
+        SILKRPC_TRACE << "AsyncServerStreamingClient::completed " << this << " state: " << magic_enum::enum_name(state_) << " end\n";
+    }
+
+private:
+    std::unique_ptr<StubInterface>& stub_;
+    grpc::CompletionQueue* queue_;
+    grpc::ClientContext context_;
+    AsyncReaderPtr reader_;
+    Reply reply_;
+    grpc::Status result_;
+    CallStatus state_{CALL_IDLE};
+    std::function<void(const Reply&)> read_completed_;
+    std::function<void(const grpc::Status&)> call_completed_;
+};
+
+} // namespace silkrpc
+
+#endif // SILKRPC_GRPC_ASYNC_SERVER_STREAMING_CLIENT_HPP_
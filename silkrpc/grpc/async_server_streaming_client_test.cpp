@@ -0,0 +1,110 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "async_server_streaming_client.hpp"
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <gmock/gmock.h>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/interfaces/remote/ethbackend.grpc.pb.h>
+#include <silkrpc/interfaces/remote/ethbackend_mock.grpc.pb.h>
+
+namespace silkrpc {
+
+using testing::MockFunction;
+using testing::Return;
+using testing::_;
+
+using SubscribeClient = AsyncServerStreamingClient<
+    ::remote::ETHBACKEND::StubInterface,
+    ::remote::SubscribeRequest,
+    ::remote::SubscribeReply,
+    &::remote::ETHBACKEND::StubInterface::PrepareAsyncSubscribe
+>;
+
+class MockClientAsyncSubscribeReader : public grpc::ClientAsyncReaderInterface<::remote::SubscribeReply> {
+public:
+    explicit MockClientAsyncSubscribeReader(int num_replies, grpc::Status status) : num_replies_(num_replies), status_(status) {}
+
+    void StartCall(void* tag) override {}
+    void ReadInitialMetadata(void* tag) override {}
+    void Read(::remote::SubscribeReply* msg, void* tag) override {
+        msg->set_type(::remote::Event::HEADER);
+        msg->set_data(std::to_string(num_replies_--));
+    }
+    void Finish(grpc::Status* status, void* tag) override { *status = status_; }
+
+    int num_replies() const { return num_replies_; }
+
+private:
+    int num_replies_;
+    grpc::Status status_;
+};
+
+TEST_CASE("create async server streaming client", "[silkrpc][grpc][async_server_streaming_client]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    std::unique_ptr<::remote::ETHBACKEND::StubInterface> stub{std::make_unique<::remote::MockETHBACKENDStub>()};
+    grpc::CompletionQueue queue;
+
+    SECTION("stream replies until server closes the stream") {
+        SubscribeClient client{stub, &queue};
+        auto mock_reader = new MockClientAsyncSubscribeReader{2, grpc::Status::OK};
+        EXPECT_CALL(*dynamic_cast<::remote::MockETHBACKENDStub*>(stub.get()), PrepareAsyncSubscribeRaw(_, _, _)).WillOnce(Return(mock_reader));
+
+        std::vector<std::string> replies;
+        bool call_completed{false};
+        client.async_call(::remote::SubscribeRequest{}, [&](const auto& reply) { replies.push_back(reply.data()); }, [&](const auto& status) {
+            CHECK(status.ok());
+            call_completed = true;
+        });
+        CHECK(client.is_active());
+        client.completed(true);  // StartCall
+        client.completed(true);  // 1st Read
+        client.completed(true);  // 2nd Read
+        client.completed(false); // stream closed
+        CHECK(!call_completed);
+        client.completed(true);  // Finish
+        CHECK(call_completed);
+        CHECK(!client.is_active());
+        CHECK(replies == std::vector<std::string>{"2", "1"});
+    }
+
+    SECTION("stream fails at start") {
+        SubscribeClient client{stub, &queue};
+        auto mock_reader = new MockClientAsyncSubscribeReader{0, grpc::Status{grpc::StatusCode::UNAVAILABLE, "unavailable"}};
+        EXPECT_CALL(*dynamic_cast<::remote::MockETHBACKENDStub*>(stub.get()), PrepareAsyncSubscribeRaw(_, _, _)).WillOnce(Return(mock_reader));
+
+        MockFunction<void(const ::remote::SubscribeReply&)> read_callback;
+        EXPECT_CALL(read_callback, Call(_)).Times(0);
+        grpc::StatusCode status_code{grpc::StatusCode::OK};
+        client.async_call(::remote::SubscribeRequest{}, read_callback.AsStdFunction(), [&](const auto& status) { status_code = status.error_code(); });
+        client.completed(false); // StartCall
+        client.completed(true);  // Finish
+        CHECK(status_code == grpc::StatusCode::UNAVAILABLE);
+    }
+
+    SECTION("unexpected completion") {
+        SubscribeClient client{stub, &queue};
+        CHECK_THROWS_AS(client.completed(true), std::runtime_error);
+    }
+}
+
+} // namespace silkrpc
@@ -35,6 +35,12 @@ public:
     virtual void read_start(std::function<void(const grpc::Status&, const Response &)> read_completed) = 0;
 
     virtual void write_start(const Request& request, std::function<void(const grpc::Status&)> write_completed) = 0;
+
+    /// Ask the server to terminate the stream: any outstanding operation will complete with CANCELLED status.
+    virtual void cancel() {}
+
+    /// Tell if the stream is terminated, so that no further operation can succeed on it.
+    virtual bool is_finished() const { return false; }
 };
 
 } // namespace silkrpc
@@ -18,6 +18,10 @@
 
 #include "async_completion_handler.hpp"
 
+#include <algorithm>
+
+#include <silkrpc/common/constants.hpp>
+
 namespace silkrpc {
 
 void CompletionRunner::stop() {
@@ -45,4 +49,61 @@ void CompletionRunner::run() {
     SILKRPC_INFO << "CompletionRunner::run end\n";
 }
 
+void CompletionRunner::run_with_io_context() {
+    SILKRPC_INFO << "CompletionRunner::run_with_io_context start\n";
+    bool shutdown{false};
+    std::size_t idle_rounds{0};
+    auto idle_wait = kCompletionPollMinWait;
+    while (!io_context_.stopped()) {
+        auto work_done = shutdown ? 0 : poll_queue(std::chrono::system_clock::now(), shutdown);
+        work_done += io_context_.poll();
+        if (work_done > 0) {
+            idle_rounds = 0;
+            idle_wait = kCompletionPollMinWait;
+            continue;
+        }
+
+        // Spin for a while to catch the next completion with minimum latency, then wait longer and longer while idle
+        if (++idle_rounds < kCompletionPollSpins) {
+            continue;
+        }
+        if (shutdown) {
+            io_context_.run_one_for(kCompletionPollMaxWait);
+        } else {
+            poll_queue(std::chrono::system_clock::now() + idle_wait, shutdown);
+            idle_wait = std::min(idle_wait * 2, kCompletionPollMaxWait);
+        }
+    }
+
+    // Like completions posted to a stopped io_context, those arriving from now on are never handled
+    void* got_tag;
+    bool ok;
+    while (queue_.Next(&got_tag, &ok)) {
+    }
+    SILKRPC_INFO << "CompletionRunner::run_with_io_context end\n";
+}
+
+std::size_t CompletionRunner::poll_queue(std::chrono::system_clock::time_point deadline, bool& shutdown) {
+    std::size_t num_completions{0};
+    void* got_tag;
+    bool ok;
+    while (true) {
+        // Only the first completion is waited for, the following ones are just drained
+        const auto status = queue_.AsyncNext(&got_tag, &ok, num_completions == 0 ? deadline : std::chrono::system_clock::time_point{});
+        if (status == grpc::CompletionQueue::SHUTDOWN) {
+            SILKRPC_DEBUG << "CompletionRunner::poll_queue shutdown\n";
+            shutdown = true;
+            break;
+        }
+        if (status == grpc::CompletionQueue::TIMEOUT) {
+            break;
+        }
+        auto operation = AsyncCompletionHandler::detag(got_tag);
+        SILKRPC_TRACE << "CompletionRunner::poll_queue complete operation: " << operation << "\n";
+        operation->completed(ok);
+        ++num_completions;
+    }
+    return num_completions;
+}
+
 } // namespace silkrpc
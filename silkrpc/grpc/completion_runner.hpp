@@ -17,6 +17,8 @@
 #ifndef SILKRPC_GRPC_COMPLETION_RUNNER_HPP_
 #define SILKRPC_GRPC_COMPLETION_RUNNER_HPP_
 
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <stdexcept>
@@ -39,11 +41,19 @@ public:
     CompletionRunner(const CompletionRunner&) = delete;
     CompletionRunner& operator=(const CompletionRunner&) = delete;
 
+    // Wait for completions on the completion queue and post them to the io_context, running on a dedicated thread
     void run();
 
+    // Run both the io_context and the completion queue on the calling thread, so that completions are handled without
+    // any thread hop. Return once the io_context is stopped and the completion queue is shut down
+    void run_with_io_context();
+
     void stop();
 
 private:
+    // Handle inline the completions available before the deadline, return how many or none if the queue is shut down
+    std::size_t poll_queue(std::chrono::system_clock::time_point deadline, bool& shutdown);
+
     grpc::CompletionQueue& queue_;
     asio::io_context& io_context_;
 };
@@ -20,6 +20,7 @@
 #include <thread>
 
 #include <asio/io_context.hpp>
+#include <asio/post.hpp>
 #include <catch2/catch.hpp>
 #include <grpcpp/alarm.h>
 #include <grpcpp/support/time.h>
@@ -167,6 +168,34 @@ TEST_CASE("start completion runner", "[silkrpc][grpc][completion_runner]") {
         CHECK_NOTHROW(completion_runner_thread.join());
     }
 
+    SECTION("handling completion on I/O execution context thread") {
+        grpc::CompletionQueue queue;
+        asio::io_context io_context;
+        asio::io_context::work work{io_context};
+        CompletionRunner completion_runner{queue, io_context};
+        auto runner_thread = std::thread([&]() { completion_runner.run_with_io_context(); });
+        std::promise<std::thread::id> p;
+        std::future<std::thread::id> f = p.get_future();
+        class ACH : public AsyncCompletionHandler {
+        public:
+            explicit ACH(std::promise<std::thread::id>& p) : p_(p) {}
+            void completed(bool ok) override { p_.set_value(std::this_thread::get_id()); };
+        private:
+            std::promise<std::thread::id>& p_;
+        };
+        ACH handler{p};
+        AsyncCompletionHandler* handler_ptr = &handler;
+        grpc::Alarm alarm;
+        alarm.Set(&queue, grpc_timeout_milliseconds_to_deadline(10), AsyncCompletionHandler::tag(handler_ptr));
+        CHECK(f.get() == runner_thread.get_id());
+        std::promise<std::thread::id> q;
+        asio::post(io_context, [&]() { q.set_value(std::this_thread::get_id()); });
+        CHECK(q.get_future().get() == runner_thread.get_id());
+        io_context.stop();
+        completion_runner.stop();
+        CHECK_NOTHROW(runner_thread.join());
+    }
+
     SECTION("exiting on completion queue already shutdown") {
         grpc::CompletionQueue queue;
         asio::io_context io_context;
@@ -0,0 +1,177 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "compression.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/http/header.hpp>
+
+namespace silkrpc::http {
+
+namespace {
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.front()))) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && std::isspace(static_cast<unsigned char>(value.back()))) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+// Parse the quality value in the parameters following a coding, 1 if not present
+double parse_quality(std::string_view parameters) {
+    while (!parameters.empty()) {
+        const auto semicolon = parameters.find(';');
+        const auto parameter = trim(parameters.substr(0, semicolon));
+        if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+            const std::string q{parameter.substr(2)};
+            return std::strtod(q.c_str(), nullptr);
+        }
+        if (semicolon == std::string_view::npos) {
+            break;
+        }
+        parameters.remove_prefix(semicolon + 1);
+    }
+    return 1.0;
+}
+
+} // namespace
+
+ContentEncoding negotiate_content_encoding(std::string_view accept_encoding) {
+    // Negative quality values mean not mentioned by the client
+    double gzip_q{-1}, deflate_q{-1}, any_q{-1};
+    while (!accept_encoding.empty()) {
+        const auto comma = accept_encoding.find(',');
+        const auto item = accept_encoding.substr(0, comma);
+        const auto semicolon = item.find(';');
+        const auto coding = trim(item.substr(0, semicolon));
+        const auto q = semicolon == std::string_view::npos ? 1.0 : parse_quality(item.substr(semicolon + 1));
+        if (iequals(coding, "gzip") || iequals(coding, "x-gzip")) {
+            gzip_q = q;
+        } else if (iequals(coding, "deflate")) {
+            deflate_q = q;
+        } else if (coding == "*") {
+            any_q = q;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        accept_encoding.remove_prefix(comma + 1);
+    }
+    if (gzip_q < 0) {
+        gzip_q = std::max(any_q, 0.0);
+    }
+    if (deflate_q < 0) {
+        deflate_q = std::max(any_q, 0.0);
+    }
+
+    if (gzip_q > 0 && gzip_q >= deflate_q) {
+        return ContentEncoding::kGzip;
+    }
+    if (deflate_q > 0) {
+        return ContentEncoding::kDeflate;
+    }
+    return ContentEncoding::kIdentity;
+}
+
+std::string_view to_string(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::kGzip:
+            return "gzip";
+        case ContentEncoding::kDeflate:
+            return "deflate";
+        default:
+            return "identity";
+    }
+}
+
+Compressor::Compressor(ContentEncoding encoding) : encoding_(encoding) {
+    if (encoding == ContentEncoding::kIdentity) {
+        throw std::invalid_argument{"Compressor: identity encoding"};
+    }
+    // Window bits in 9..15 produce zlib format, adding 16 produces gzip format
+    const int window_bits = encoding == ContentEncoding::kGzip ? MAX_WBITS + 16 : MAX_WBITS;
+    if (deflateInit2(&stream_, kCompressionLevel, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error{"Compressor: deflateInit2 failed"};
+    }
+}
+
+Compressor::~Compressor() {
+    deflateEnd(&stream_);
+}
+
+void Compressor::compress(const ChainedBuffer& input, ChainedBuffer& output) {
+    if (deflateReset(&stream_) != Z_OK) {
+        throw std::runtime_error{"Compressor: deflateReset failed"};
+    }
+
+    std::vector<asio::const_buffer> chunks;
+    chunks.reserve(input.num_chunks());
+    input.to_buffers(chunks);
+    for (const auto& chunk : chunks) {
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<void*>(chunk.data()));
+        stream_.avail_in = static_cast<uInt>(chunk.size());
+        deflate(Z_NO_FLUSH, output);
+    }
+    deflate(Z_FINISH, output);
+}
+
+void Compressor::deflate(int flush, ChainedBuffer& output) {
+    int result{Z_OK};
+    do {
+        stream_.next_out = reinterpret_cast<Bytef*>(buffer_.data());
+        stream_.avail_out = static_cast<uInt>(buffer_.size());
+        result = ::deflate(&stream_, flush);
+        if (result == Z_STREAM_ERROR) {
+            throw std::runtime_error{"Compressor: deflate failed"};
+        }
+        const auto produced = buffer_.size() - stream_.avail_out;
+        if (produced > 0) {
+            output.append(std::string_view{buffer_.data(), produced});
+        }
+    } while (stream_.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+}
+
+std::unique_ptr<Compressor> CompressorPool::acquire(ContentEncoding encoding) {
+    auto& compressors = encoding == ContentEncoding::kGzip ? gzip_compressors_ : deflate_compressors_;
+    if (compressors.empty()) {
+        SILKRPC_DEBUG << "CompressorPool::acquire new compressor for encoding: " << to_string(encoding) << "\n";
+        return std::make_unique<Compressor>(encoding);
+    }
+    auto compressor = std::move(compressors.back());
+    compressors.pop_back();
+    return compressor;
+}
+
+void CompressorPool::release(std::unique_ptr<Compressor> compressor) {
+    auto& compressors = compressor->encoding() == ContentEncoding::kGzip ? gzip_compressors_ : deflate_compressors_;
+    if (compressors.size() >= max_idle_compressors_) {
+        return;
+    }
+    compressors.push_back(std::move(compressor));
+}
+
+} // namespace silkrpc::http
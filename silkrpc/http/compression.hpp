@@ -0,0 +1,102 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#ifndef SILKRPC_HTTP_COMPRESSION_HPP_
+#define SILKRPC_HTTP_COMPRESSION_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <zlib.h>
+
+#include <silkrpc/common/chained_buffer.hpp>
+#include <silkrpc/common/constants.hpp>
+
+namespace silkrpc::http {
+
+/// The content encodings supported for replies.
+enum class ContentEncoding : uint8_t {
+    kIdentity,
+    kGzip,
+    kDeflate
+};
+
+/// Choose the reply content encoding preferred by the client among the supported ones, given the value of
+/// the Accept-Encoding request header (RFC 7231, section 5.3.4). Ties are broken in favour of gzip.
+ContentEncoding negotiate_content_encoding(std::string_view accept_encoding);
+
+/// The Content-Encoding header value for the given encoding.
+std::string_view to_string(ContentEncoding encoding);
+
+/// Reusable compression stream, either gzip or deflate (i.e. zlib format, RFC 7230 section 4.2.2).
+class Compressor {
+public:
+    explicit Compressor(ContentEncoding encoding);
+    ~Compressor();
+
+    Compressor(const Compressor&) = delete;
+    Compressor& operator=(const Compressor&) = delete;
+
+    ContentEncoding encoding() const { return encoding_; }
+
+    /// Compress the whole input into output. Throw std::runtime_error on failure.
+    void compress(const ChainedBuffer& input, ChainedBuffer& output);
+
+private:
+    /// Append to output the compressed data produced so far, running deflate with the given flush mode.
+    void deflate(int flush, ChainedBuffer& output);
+
+    ContentEncoding encoding_;
+
+    /// The zlib stream state, reset between replies instead of reallocated.
+    z_stream stream_{};
+
+    /// Buffer for the compressed data before moving it to the output.
+    std::array<char, kCompressionBufferSize> buffer_;
+};
+
+/// Pool of compressors used by the connections of a single io_context. Not thread-safe: acquire and release
+/// must happen on the io_context thread, whilst the compression itself can run on any thread.
+/// At most max_idle_compressors per encoding are kept, the ones exceeding it after a burst of replies are destroyed.
+class CompressorPool {
+public:
+    explicit CompressorPool(std::size_t max_idle_compressors = kMaxIdleCompressors) : max_idle_compressors_{max_idle_compressors} {}
+
+    CompressorPool(const CompressorPool&) = delete;
+    CompressorPool& operator=(const CompressorPool&) = delete;
+
+    std::unique_ptr<Compressor> acquire(ContentEncoding encoding);
+
+    void release(std::unique_ptr<Compressor> compressor);
+
+    std::size_t num_idle_compressors(ContentEncoding encoding) const {
+        return encoding == ContentEncoding::kGzip ? gzip_compressors_.size() : deflate_compressors_.size();
+    }
+
+private:
+    std::size_t max_idle_compressors_;
+    std::vector<std::unique_ptr<Compressor>> gzip_compressors_;
+    std::vector<std::unique_ptr<Compressor>> deflate_compressors_;
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_COMPRESSION_HPP_
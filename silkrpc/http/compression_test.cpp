@@ -0,0 +1,137 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "compression.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <zlib.h>
+
+namespace silkrpc::http {
+
+// Decompress either gzip or zlib format, detected from the header
+std::string inflate_all(const std::string& compressed) {
+    z_stream stream{};
+    REQUIRE(inflateInit2(&stream, MAX_WBITS + 32) == Z_OK);
+    std::string output;
+    char buffer[1024];
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+    stream.avail_in = static_cast<uInt>(compressed.size());
+    int result{Z_OK};
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        result = inflate(&stream, Z_NO_FLUSH);
+        REQUIRE((result == Z_OK || result == Z_STREAM_END));
+        output.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (result != Z_STREAM_END);
+    inflateEnd(&stream);
+    return output;
+}
+
+TEST_CASE("negotiate content encoding", "[silkrpc][http][compression]") {
+    CHECK(negotiate_content_encoding("") == ContentEncoding::kIdentity);
+    CHECK(negotiate_content_encoding("identity") == ContentEncoding::kIdentity);
+    CHECK(negotiate_content_encoding("br") == ContentEncoding::kIdentity);
+    CHECK(negotiate_content_encoding("gzip") == ContentEncoding::kGzip);
+    CHECK(negotiate_content_encoding("GZIP") == ContentEncoding::kGzip);
+    CHECK(negotiate_content_encoding("deflate") == ContentEncoding::kDeflate);
+    CHECK(negotiate_content_encoding("gzip, deflate, br") == ContentEncoding::kGzip);
+    CHECK(negotiate_content_encoding("deflate, gzip") == ContentEncoding::kGzip);
+    CHECK(negotiate_content_encoding("gzip;q=0.5, deflate") == ContentEncoding::kDeflate);
+    CHECK(negotiate_content_encoding("gzip; q=0, deflate;q=0.1") == ContentEncoding::kDeflate);
+    CHECK(negotiate_content_encoding("gzip;q=0") == ContentEncoding::kIdentity);
+    CHECK(negotiate_content_encoding("*") == ContentEncoding::kGzip);
+    CHECK(negotiate_content_encoding("gzip;q=0, *") == ContentEncoding::kDeflate);
+    CHECK(negotiate_content_encoding("*;q=0, identity") == ContentEncoding::kIdentity);
+}
+
+TEST_CASE("compress content", "[silkrpc][http][compression]") {
+    std::string content{"{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":["};
+    for (int i{0}; i < 2000; ++i) {
+        content += "\"0x000000000000000000000000000000000000000000000000000000000000000" + std::to_string(i % 10) + "\",";
+    }
+    content += "null]}";
+    ChainedBuffer input;
+    input.append(content);
+    REQUIRE(input.num_chunks() > 1);
+
+    SECTION("gzip") {
+        Compressor compressor{ContentEncoding::kGzip};
+        ChainedBuffer output;
+        compressor.compress(input, output);
+        const auto compressed = output.to_string();
+        CHECK(compressed.size() < content.size() / 10);
+        CHECK(static_cast<uint8_t>(compressed[0]) == 0x1f);
+        CHECK(static_cast<uint8_t>(compressed[1]) == 0x8b);
+        CHECK(inflate_all(compressed) == content);
+    }
+
+    SECTION("deflate") {
+        Compressor compressor{ContentEncoding::kDeflate};
+        ChainedBuffer output;
+        compressor.compress(input, output);
+        CHECK(inflate_all(output.to_string()) == content);
+    }
+
+    SECTION("compressor reuse") {
+        Compressor compressor{ContentEncoding::kGzip};
+        ChainedBuffer output1, output2;
+        compressor.compress(input, output1);
+        compressor.compress(input, output2);
+        CHECK(output1.to_string() == output2.to_string());
+    }
+
+    SECTION("empty content") {
+        Compressor compressor{ContentEncoding::kDeflate};
+        ChainedBuffer empty, output;
+        compressor.compress(empty, output);
+        CHECK(inflate_all(output.to_string()).empty());
+    }
+}
+
+TEST_CASE("compressor pool", "[silkrpc][http][compression]") {
+    CompressorPool pool;
+    auto gzip_compressor = pool.acquire(ContentEncoding::kGzip);
+    CHECK(gzip_compressor->encoding() == ContentEncoding::kGzip);
+    const auto gzip_compressor_ptr = gzip_compressor.get();
+    pool.release(std::move(gzip_compressor));
+
+    CHECK(pool.acquire(ContentEncoding::kDeflate)->encoding() == ContentEncoding::kDeflate);
+    CHECK(pool.acquire(ContentEncoding::kGzip).get() == gzip_compressor_ptr);
+    CHECK_THROWS_AS(pool.acquire(ContentEncoding::kIdentity), std::invalid_argument);
+}
+
+TEST_CASE("compressor pool bounded", "[silkrpc][http][compression]") {
+    CompressorPool pool{2};
+    std::vector<std::unique_ptr<Compressor>> compressors;
+    for (int i{0}; i < 5; ++i) {
+        compressors.push_back(pool.acquire(ContentEncoding::kGzip));
+    }
+    compressors.push_back(pool.acquire(ContentEncoding::kDeflate));
+    for (auto& compressor : compressors) {
+        pool.release(std::move(compressor));
+    }
+    // The compressors exceeding the bound after the burst are destroyed, not kept forever
+    CHECK(pool.num_idle_compressors(ContentEncoding::kGzip) == 2);
+    CHECK(pool.num_idle_compressors(ContentEncoding::kDeflate) == 1);
+}
+
+} // namespace silkrpc::http
@@ -28,17 +28,22 @@
 #include <utility>
 #include <vector>
 
+#include <asio/co_spawn.hpp>
 #include <asio/write.hpp>
 #include <asio/use_awaitable.hpp>
 
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/common/util.hpp>
 #include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/http/websocket.hpp>
+#include <silkrpc/http/websocket_session.hpp>
 
 namespace silkrpc::http {
 
-Connection::Connection(Context& context, asio::thread_pool& workers, commands::RpcApiTable& handler_table)
-: socket_{*context.io_context}, request_handler_{context, workers, handler_table} {
+Connection::Connection(Context& context, commands::RpcApi& rpc_api, commands::WorkerPools& workers, commands::RpcApiTable& handler_table,
+    commands::AdmissionControl& admission_control, const ConnectionLimits& limits)
+: socket_{*context.io_context}, request_handler_{context, rpc_api, workers, handler_table, admission_control}, subscription_manager_{*context.subscription_manager},
+  timer_wheel_{*context.timer_wheel}, pending_write_{context.io_context->get_executor()}, timeouts_{socket_, *context.timer_wheel, limits} {
     request_.content.reserve(kRequestContentInitialCapacity);
     request_.headers.reserve(kRequestHeadersInitialCapacity);
     request_.method.reserve(kRequestMethodInitialCapacity);
@@ -52,34 +57,100 @@ Connection::~Connection() {
 }
 
 asio::awaitable<void> Connection::start() {
-    co_await do_read();
+    std::exception_ptr read_error;
+    try {
+        co_await do_read();
+    } catch (...) {
+        read_error = std::current_exception();
+    }
+
+    if (read_error) {
+        // The connection is failing, so abort any write in progress
+        asio::error_code ec;
+        socket_.cancel(ec);
+    }
+
+    // Keep the connection alive until the last pipelined reply has been written: its completion handler refers to it
+    co_await pending_write_.wait();
+
+    if (read_error) {
+        std::rethrow_exception(read_error);
+    }
+}
+
+std::size_t Connection::retained_memory() const {
+    const auto reply_memory = [](const Reply& reply) {
+        return reply.headers.capacity() * sizeof(Header) + reply.content.capacity() + reply.chunk_size.capacity();
+    };
+    return request_.method.capacity() + request_.uri.capacity() + request_.headers.capacity() * sizeof(Header) +
+        request_.content.capacity() + reply_memory(reply_) + reply_memory(pending_reply_);
 }
 
 asio::awaitable<void> Connection::do_read() {
+    // Requests are served iteratively, so the coroutine frames do not pile up with the requests on a keep-alive connection
     try {
-        SILKRPC_DEBUG << "Connection::do_read going to read...\n" << std::flush;
-        std::size_t bytes_read = co_await socket_.async_read_some(asio::buffer(buffer_), asio::use_awaitable);
-        SILKRPC_DEBUG << "Connection::do_read bytes_read: " << bytes_read << "\n";
-        SILKRPC_TRACE << "Connection::do_read buffer: " << std::string_view{static_cast<const char*>(buffer_.data()), bytes_read} << "\n";
-
-        RequestParser::ResultType result = request_parser_.parse(request_, buffer_.data(), buffer_.data() + bytes_read);
-
-        if (result == RequestParser::good) {
-            co_await request_handler_.handle_request(request_, reply_);
-            co_await do_write();
-            clean();
-        } else if (result == RequestParser::bad) {
-            reply_ = Reply::stock_reply(Reply::bad_request);
-            co_await do_write();
-            clean();
-        } else if (result == RequestParser::processing_continue) {
-            reply_ = Reply::stock_reply(Reply::processing_continue);
-            co_await do_write();
-            reply_.reset();
+        // Waiting for the next data of a partial request is bounded by the read timeout, waiting for a new request by the idle one
+        bool partial_request{false};
+        while (true) {
+            SILKRPC_DEBUG << "Connection::do_read going to read...\n" << std::flush;
+            timeouts_.start_read(partial_request);
+            std::size_t bytes_read = co_await socket_.async_read_some(asio::buffer(buffer_), asio::use_awaitable);
+            timeouts_.stop_read();
+            SILKRPC_DEBUG << "Connection::do_read bytes_read: " << bytes_read << "\n";
+            SILKRPC_TRACE << "Connection::do_read buffer: " << std::string_view{static_cast<const char*>(buffer_.data()), bytes_read} << "\n";
+
+            // Parse all the (possibly pipelined) requests available in the buffer, the last one can be incomplete
+            const char* buffer_begin = buffer_.data();
+            const char* buffer_end = buffer_.data() + bytes_read;
+            partial_request = false;
+            while (buffer_begin != buffer_end) {
+                const auto [result, consumed_end] = request_parser_.parse(request_, buffer_begin, buffer_end);
+                buffer_begin = consumed_end;
+                partial_request = result == RequestParser::indeterminate;
+
+                if (result == RequestParser::good && websocket::is_upgrade_request(request_)) {
+                    co_await pending_write_.wait();
+                    reply_ = websocket::make_upgrade_reply(request_);
+                    co_await do_write(reply_);
+                    if (reply_.status == Reply::switching_protocols) {
+                        // The connection speaks WebSocket from now on, any data following the upgrade request belongs to the session
+                        WebSocketSession session{socket_, request_handler_, subscription_manager_, timer_wheel_, timeouts_.limits()};
+                        co_await session.run({buffer_begin, static_cast<std::size_t>(buffer_end - buffer_begin)});
+                        co_return;
+                    }
+                    clean();
+                } else if (result == RequestParser::good) {
+                    // Handling of this request overlaps with writing of the previous reply, replies are kept in order
+                    try {
+                        co_await request_handler_.handle_request(request_, reply_, [this]() { return write_chunk(); });
+                    } catch (...) {
+                        // A partially sent reply cannot be completed: closing without the last chunk tells the client it is truncated
+                        if (reply_.chunked) {
+                            SILKRPC_WARN << "Connection::do_read chunked reply aborted socket " << &socket_ << "\n";
+                            asio::error_code ec;
+                            socket_.close(ec);
+                        }
+                        throw;
+                    }
+                    co_await write_reply();
+                    request_.reset();
+                    request_parser_.reset();
+                } else if (result == RequestParser::bad) {
+                    // Unable to find the next request boundary, so discard any remaining data
+                    co_await pending_write_.wait();
+                    reply_ = Reply::stock_reply(Reply::bad_request);
+                    co_await do_write(reply_);
+                    clean();
+                    break;
+                } else if (result == RequestParser::processing_continue) {
+                    co_await pending_write_.wait();
+                    reply_ = Reply::stock_reply(Reply::processing_continue);
+                    co_await do_write(reply_);
+                    reply_.reset();
+                }
+            }
+            // Read next chunck (result == RequestParser::indeterminate) or next request
         }
-
-        // Read next chunck (result == RequestParser::indeterminate) or next request
-        co_await do_read();
     } catch (const std::system_error& se) {
         if (se.code() == asio::error::eof || se.code() == asio::error::connection_reset || se.code() == asio::error::broken_pipe) {
             SILKRPC_DEBUG << "Connection::do_read close from client with code: " << se.code() << "\n" << std::flush;
@@ -95,10 +166,39 @@ asio::awaitable<void> Connection::do_read() {
     }
 }
 
-asio::awaitable<void> Connection::do_write() {
+asio::awaitable<void> Connection::write_reply() {
+    co_await pending_write_.wait();
+    if (write_error_) {
+        std::rethrow_exception(std::exchange(write_error_, nullptr));
+    }
+
+    std::swap(reply_, pending_reply_);
+    reply_.reset();
+
+    pending_write_.start();
+    asio::co_spawn(socket_.get_executor(), do_write(pending_reply_), [this](std::exception_ptr eptr) {
+        write_error_ = eptr;
+        pending_write_.complete();
+    });
+}
+
+asio::awaitable<void> Connection::write_chunk() {
+    // The first chunk carries status line and headers, so it must follow the previous reply
+    co_await pending_write_.wait();
+    if (write_error_) {
+        std::rethrow_exception(std::exchange(write_error_, nullptr));
+    }
+
+    co_await do_write(reply_, /*last_chunk=*/false);
+    reply_.content.clear();
+}
+
+asio::awaitable<void> Connection::do_write(Reply& reply, bool last_chunk) {
     try {
-        SILKRPC_DEBUG << "Connection::do_write reply: " << reply_.content << "\n" << std::flush;
-        const auto bytes_transferred = co_await asio::async_write(socket_, reply_.to_buffers(), asio::use_awaitable);
+        SILKRPC_DEBUG << "Connection::do_write reply: " << reply.content << "\n" << std::flush;
+        timeouts_.start_write();
+        const auto bytes_transferred = co_await asio::async_write(socket_, reply.to_buffers(last_chunk), asio::use_awaitable);
+        timeouts_.stop_write();
         SILKRPC_TRACE << "Connection::do_write bytes_transferred: " << bytes_transferred << "\n" << std::flush;
     } catch (const std::system_error& se) {
         std::rethrow_exception(std::make_exception_ptr(se));
@@ -24,20 +24,25 @@
 #define SILKRPC_HTTP_CONNECTION_HPP_
 
 #include <array>
+#include <cstddef>
+#include <exception>
 
 #include <silkrpc/config.hpp>
 
 #include <asio/awaitable.hpp>
 #include <asio/ip/tcp.hpp>
-#include <asio/thread_pool.hpp>
 
 #include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
 #include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/timer_wheel.hpp>
 #include <silkrpc/context_pool.hpp>
+#include <silkrpc/http/connection_io.hpp>
 #include <silkrpc/http/reply.hpp>
 #include <silkrpc/http/request.hpp>
 #include <silkrpc/http/request_handler.hpp>
 #include <silkrpc/http/request_parser.hpp>
+#include <silkrpc/subscriptions/subscription_manager.hpp>
 
 namespace silkrpc::http {
 
@@ -48,7 +53,8 @@ public:
     Connection& operator=(const Connection&) = delete;
 
     /// Construct a connection running within the given execution context.
-    Connection(Context& context, asio::thread_pool& workers, commands::RpcApiTable& handler_table);
+    Connection(Context& context, commands::RpcApi& rpc_api, commands::WorkerPools& workers, commands::RpcApiTable& handler_table,
+        commands::AdmissionControl& admission_control, const ConnectionLimits& limits);
 
     ~Connection();
 
@@ -57,15 +63,25 @@ public:
     /// Start the first asynchronous operation for the connection.
     asio::awaitable<void> start();
 
+    /// The memory allocated by the connection buffers besides sizeof(Connection), which must not grow with the requests served.
+    std::size_t retained_memory() const;
+
 private:
     // reset connection data
     void clean();
 
-    /// Perform an asynchronous read operation.
+    /// Read and serve the incoming requests until the connection gets closed.
     asio::awaitable<void> do_read();
 
+    /// Start writing the prepared reply as soon as the previous one has been written, without waiting for completion.
+    asio::awaitable<void> write_reply();
+
+    /// Write the content of the reply being prepared as next chunk, preceded by the status line and the headers the
+    /// first time.
+    asio::awaitable<void> write_chunk();
+
     /// Perform an asynchronous write operation.
-    asio::awaitable<void> do_write();
+    asio::awaitable<void> do_write(Reply& reply, bool last_chunk = true);
 
     /// Socket for the connection.
     asio::ip::tcp::socket socket_;
@@ -73,6 +89,12 @@ private:
     /// The handler used to process the incoming request.
     RequestHandler request_handler_;
 
+    /// The manager of the subscriptions opened by WebSocket clients.
+    subscriptions::SubscriptionManager& subscription_manager_;
+
+    /// The timer wheel of the execution context, enforcing the timeouts also after a WebSocket upgrade.
+    TimerWheel& timer_wheel_;
+
     /// Buffer for incoming data.
     std::array<char, kHttpIncomingBufferSize> buffer_;
 
@@ -84,6 +106,18 @@ private:
 
     /// The reply to be sent back to the client.
     Reply reply_;
+
+    /// The previous reply currently being written back to the client (HTTP/1.1 pipelining).
+    Reply pending_reply_;
+
+    /// The write of the pending reply.
+    PendingWrite pending_write_;
+
+    /// The error raised by the last pending reply write, if any.
+    std::exception_ptr write_error_;
+
+    /// The idle, read and write timeouts.
+    ConnectionTimeouts<asio::ip::tcp::socket> timeouts_;
 };
 
 } // namespace silkrpc::http
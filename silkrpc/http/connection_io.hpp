@@ -0,0 +1,140 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_CONNECTION_IO_HPP_
+#define SILKRPC_HTTP_CONNECTION_IO_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <system_error>
+
+#include <silkrpc/config.hpp>
+
+#include <asio/any_io_executor.hpp>
+#include <asio/awaitable.hpp>
+#include <asio/redirect_error.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/use_awaitable.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/timer_wheel.hpp>
+
+namespace silkrpc::http {
+
+/// The limits applied to client connections, zero meaning no limit.
+struct ConnectionLimits {
+    /// The maximum number of connections open at the same time, further ones are closed as soon as accepted.
+    std::size_t max_connections{kDefaultMaxConnections};
+
+    /// The maximum time to wait for the next request on an idle connection.
+    std::chrono::milliseconds idle_timeout{kDefaultIdleTimeout};
+
+    /// The maximum time to wait for the next data of a partially received request.
+    std::chrono::milliseconds read_timeout{kDefaultReadTimeout};
+
+    /// The maximum time to write a reply.
+    std::chrono::milliseconds write_timeout{kDefaultWriteTimeout};
+};
+
+/// The idle, read and write timeouts of a client socket, enforced in the same way by all the transports: when one
+/// expires, the operations in progress on the socket are cancelled.
+template <typename Socket>
+class ConnectionTimeouts {
+public:
+    ConnectionTimeouts(Socket& socket, TimerWheel& timer_wheel, const ConnectionLimits& limits)
+    : socket_(socket), limits_{limits}, read_timer_{timer_wheel, [this]() { abort(); }}, write_timer_{timer_wheel, [this]() { abort(); }} {}
+
+    ConnectionTimeouts(const ConnectionTimeouts&) = delete;
+    ConnectionTimeouts& operator=(const ConnectionTimeouts&) = delete;
+
+    const ConnectionLimits& limits() const { return limits_; }
+
+    /// Bound the next read by the read timeout if a request is partially received, by the idle timeout otherwise.
+    void start_read(bool partial_request) { arm(read_timer_, partial_request ? limits_.read_timeout : limits_.idle_timeout); }
+    void stop_read() { read_timer_.cancel(); }
+
+    /// Bound the next write by the write timeout.
+    void start_write() { arm(write_timer_, limits_.write_timeout); }
+    void stop_write() { write_timer_.cancel(); }
+
+private:
+    /// Schedule the expiry of the given timer, unless the timeout is zero.
+    static void arm(TimerWheel::Timer& timer, std::chrono::milliseconds timeout) {
+        if (timeout.count() > 0) {
+            timer.expires_after(timeout);
+        }
+    }
+
+    /// Abort any asynchronous operation in progress, called when a timeout expires.
+    void abort() {
+        SILKRPC_DEBUG << "ConnectionTimeouts::abort socket " << &socket_ << " timeout expired\n";
+        asio::error_code ec;
+        socket_.cancel(ec);
+    }
+
+    /// Socket for the connection.
+    Socket& socket_;
+
+    /// The idle, read and write timeouts.
+    ConnectionLimits limits_;
+
+    /// Timer enforcing the idle or read timeout while waiting for incoming data.
+    TimerWheel::Timer read_timer_;
+
+    /// Timer enforcing the write timeout while writing.
+    TimerWheel::Timer write_timer_;
+};
+
+/// The state of a write running in background, which must complete before the next one starts or the connection goes.
+class PendingWrite {
+public:
+    explicit PendingWrite(const asio::any_io_executor& executor) : completed_{executor} {}
+
+    PendingWrite(const PendingWrite&) = delete;
+    PendingWrite& operator=(const PendingWrite&) = delete;
+
+    bool in_progress() const { return in_progress_; }
+
+    void start() { in_progress_ = true; }
+
+    /// Signal the completion, resuming the waiters.
+    void complete() {
+        in_progress_ = false;
+        completed_.cancel();
+    }
+
+    /// Wait for the write in progress to complete, if any.
+    asio::awaitable<void> wait() {
+        // The timer never expires, it is just cancelled as a condition variable
+        while (in_progress_) {
+            completed_.expires_at(asio::steady_timer::time_point::max());
+            asio::error_code ec;
+            co_await completed_.async_wait(asio::redirect_error(asio::use_awaitable, ec));
+        }
+    }
+
+private:
+    /// Timer used to signal the completion of the write.
+    asio::steady_timer completed_;
+
+    /// Flag indicating if the write is in progress.
+    bool in_progress_{false};
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_CONNECTION_IO_HPP_
@@ -16,11 +16,21 @@
 
 #include "connection.hpp"
 
+#include <string>
+#include <thread>
+
+#include <asio/co_spawn.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/post.hpp>
+#include <asio/read.hpp>
+#include <asio/read_until.hpp>
 #include <asio/thread_pool.hpp>
+#include <asio/use_future.hpp>
+#include <asio/write.hpp>
 #include <catch2/catch.hpp>
 #include <grpcpp/grpcpp.h>
 
-#include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/http/connection_test_fixture.hpp>
 
 namespace silkrpc::http {
 
@@ -46,4 +56,126 @@ TEST_CASE("connection creation", "[silkrpc][http][connection]") {
     }
 }
 
+TEST_CASE("connection memory footprint", "[silkrpc][http][connection]") {
+    // The state of each connection is fixed in size: serving more requests must not make it grow, nor should new members
+    // make it grow unnoticed because it is multiplied by the number of open connections
+    INFO("sizeof(Connection): " << sizeof(Connection));
+    CHECK(sizeof(Connection) <= kHttpIncomingBufferSize + 4 * 1024);
+}
+
+TEST_CASE_METHOD(ConnectionTestFixture, "connection memory with pipelined requests", "[silkrpc][http][connection]") {
+    Connection connection{context_pool.get_context(), rpc_api, workers, rpc_api_table, admission_control, ConnectionLimits{}};
+
+    // The client talks synchronously to the connection served on the context thread
+    auto& io_context = context_pool.get_io_context();
+    asio::ip::tcp::acceptor acceptor{io_context, asio::ip::tcp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    asio::ip::tcp::socket client{io_context};
+    client.connect(acceptor.local_endpoint());
+    acceptor.accept(connection.socket());
+    auto served{asio::co_spawn(io_context, connection.start(), asio::use_future)};
+
+    const auto make_request = [](const std::string& input) {
+        const std::string content{R"({"jsonrpc":"2.0","id":1,"method":"web3_sha3","params":["0x)" + input + R"("]})"};
+        return "POST / HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/json\r\nContent-Length: " +
+            std::to_string(content.size()) + "\r\n\r\n" + content;
+    };
+    std::string incoming;
+    const auto receive_replies = [&](std::size_t num_replies) {
+        for (std::size_t i{0}; i < num_replies; ++i) {
+            const auto headers_size = asio::read_until(client, asio::dynamic_buffer(incoming), "\r\n\r\n");
+            const auto headers = incoming.substr(0, headers_size);
+            REQUIRE(headers.starts_with("HTTP/1.1 200 OK\r\n"));
+            const auto length_begin = headers.find("Content-Length: ") + 16;
+            const auto content_length = std::stoul(headers.substr(length_begin, headers.find("\r\n", length_begin) - length_begin));
+            if (incoming.size() < headers_size + content_length) {
+                asio::read(client, asio::dynamic_buffer(incoming), asio::transfer_exactly(headers_size + content_length - incoming.size()));
+            }
+            incoming.erase(0, headers_size + content_length);
+        }
+    };
+    const auto send_pipelined = [&](const std::string& request, std::size_t num_requests) {
+        std::string requests;
+        for (std::size_t i{0}; i < num_requests; ++i) {
+            requests += request;
+        }
+        asio::write(client, asio::buffer(requests));
+        receive_replies(num_requests);
+    };
+    const auto retained_memory = [&]() {
+        return asio::post(io_context, asio::use_future([&]() { return connection.retained_memory(); })).get();
+    };
+
+    // The buffers settle after the first requests, then serving more of them must not grow the connection state
+    const auto request = make_request("abcdef");
+    send_pipelined(request, 16);
+    const auto initial_memory = retained_memory();
+    for (int i{0}; i < 10; ++i) {
+        send_pipelined(request, 100);
+    }
+    CHECK(retained_memory() <= initial_memory);
+
+    // Nor must the connection keep the peak size of the requests
+    send_pipelined(make_request(std::string(2 * kRequestContentMaxRetainedCapacity, 'a')), 1);
+    send_pipelined(request, 16);
+    CHECK(retained_memory() <= initial_memory);
+
+    client.close();
+    CHECK_NOTHROW(served.get());
+    stop();
+}
+
+TEST_CASE_METHOD(ConnectionTestFixture, "connection requests without content", "[silkrpc][http][connection]") {
+    Connection connection{context_pool.get_context(), rpc_api, workers, rpc_api_table, admission_control, ConnectionLimits{}};
+
+    // The client talks synchronously to the connection served on the context thread
+    auto& io_context = context_pool.get_io_context();
+    asio::ip::tcp::acceptor acceptor{io_context, asio::ip::tcp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    asio::ip::tcp::socket client{io_context};
+    client.connect(acceptor.local_endpoint());
+    acceptor.accept(connection.socket());
+    auto served{asio::co_spawn(io_context, connection.start(), asio::use_future)};
+
+    std::string incoming;
+    const auto receive_headers = [&]() {
+        const auto headers_size = asio::read_until(client, asio::dynamic_buffer(incoming), "\r\n\r\n");
+        const auto headers = incoming.substr(0, headers_size);
+        incoming.erase(0, headers_size);
+        return headers;
+    };
+
+    SECTION("websocket handshake") {
+        // Opening handshake from RFC 6455, section 1.2: a GET request without Content-Length
+        asio::write(client, asio::buffer(std::string{
+            "GET /chat HTTP/1.1\r\n"
+            "Host: server.example.com\r\n"
+            "Upgrade: websocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+            "Origin: http://example.com\r\n"
+            "Sec-WebSocket-Version: 13\r\n"
+            "\r\n"}));
+        const auto headers = receive_headers();
+        CHECK(headers.starts_with("HTTP/1.1 101 Switching Protocols\r\n"));
+        CHECK(headers.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n") != std::string::npos);
+    }
+
+    SECTION("metrics scrape") {
+        // As sent by curl or the Prometheus scraper: a GET request without Content-Length
+        asio::write(client, asio::buffer(std::string{"GET /metrics HTTP/1.1\r\nHost: localhost:8545\r\nAccept: */*\r\n\r\n"}));
+        const auto headers = receive_headers();
+        CHECK(headers.starts_with("HTTP/1.1 200 OK\r\n"));
+        CHECK(headers.find("Content-Type: text/plain; version=0.0.4\r\n") != std::string::npos);
+        const auto length_begin = headers.find("Content-Length: ") + 16;
+        const auto content_length = std::stoul(headers.substr(length_begin, headers.find("\r\n", length_begin) - length_begin));
+        if (incoming.size() < content_length) {
+            asio::read(client, asio::dynamic_buffer(incoming), asio::transfer_exactly(content_length - incoming.size()));
+        }
+        CHECK(incoming.find("# TYPE silkrpc_requests_total counter\n") != std::string::npos);
+    }
+
+    client.close();
+    CHECK_NOTHROW(served.get());
+    stop();
+}
+
 } // namespace silkrpc::http
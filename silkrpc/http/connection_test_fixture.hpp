@@ -0,0 +1,67 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_CONNECTION_TEST_FIXTURE_HPP_
+#define SILKRPC_HTTP_CONNECTION_TEST_FIXTURE_HPP_
+
+#include <thread>
+
+#include <grpcpp/grpcpp.h>
+
+#include <silkrpc/commands/admission_control.hpp>
+#include <silkrpc/commands/rpc_api.hpp>
+#include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/context_pool.hpp>
+
+namespace silkrpc::http {
+
+// Everything needed to serve requests over real sockets in tests: a single context running on its own thread, so that
+// test clients can talk synchronously to the connections served there, and the RPC API with the default namespaces.
+class ConnectionTestFixture {
+public:
+    ConnectionTestFixture()
+    : context_pool{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }},
+      context_pool_thread{[this]() { context_pool.run(); }}, rpc_api{context_pool.get_context(), workers} {
+        SILKRPC_LOG_VERBOSITY(LogLevel::None);
+    }
+
+    ~ConnectionTestFixture() { stop(); }
+
+    ConnectionTestFixture(const ConnectionTestFixture&) = delete;
+    ConnectionTestFixture& operator=(const ConnectionTestFixture&) = delete;
+
+    // Stop the context thread: tests must call it before destroying the objects used on the context, e.g. connections
+    void stop() {
+        if (context_pool_thread.joinable()) {
+            context_pool.stop();
+            context_pool_thread.join();
+        }
+    }
+
+    ContextPool context_pool;
+    std::thread context_pool_thread;
+    commands::WorkerPools workers{1, 1};
+    commands::RpcApi rpc_api;
+    commands::RpcApiTable rpc_api_table{kDefaultEth1ApiSpec};
+    commands::AdmissionControl admission_control{""};
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_CONNECTION_TEST_FIXTURE_HPP_
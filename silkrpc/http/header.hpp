@@ -17,7 +17,10 @@
 #ifndef SILKRPC_HTTP_HEADER_HPP_
 #define SILKRPC_HTTP_HEADER_HPP_
 
+#include <algorithm>
+#include <cctype>
 #include <string>
+#include <string_view>
 
 namespace silkrpc::http {
 
@@ -32,6 +35,13 @@ inline bool operator==(const Header& lhs, const Header& rhs) {
     return lhs.name == rhs.name && lhs.value == rhs.value;
 }
 
+// Compare ASCII strings ignoring case, as required for header names and many header values
+inline bool iequals(std::string_view lhs, std::string_view rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](char a, char b) {
+        return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+    });
+}
+
 } // namespace silkrpc::http
 
 #endif // SILKRPC_HTTP_HEADER_HPP_
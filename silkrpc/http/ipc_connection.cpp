@@ -0,0 +1,110 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "ipc_connection.hpp"
+
+#include <exception>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <asio/buffer.hpp>
+#include <asio/use_awaitable.hpp>
+#include <asio/write.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::http {
+
+IpcConnection::IpcConnection(Context& context, commands::RpcApi& rpc_api, commands::WorkerPools& workers, commands::RpcApiTable& handler_table,
+    commands::AdmissionControl& admission_control, const ConnectionLimits& limits, std::size_t max_message_size)
+: socket_{*context.io_context}, request_handler_{context, rpc_api, workers, handler_table, admission_control},
+  max_message_size_{max_message_size}, timeouts_{socket_, *context.timer_wheel, limits} {
+    incoming_.reserve(kRequestContentInitialCapacity);
+    SILKRPC_DEBUG << "IpcConnection::IpcConnection socket " << &socket_ << " created\n";
+}
+
+IpcConnection::~IpcConnection() {
+    socket_.close();
+    SILKRPC_DEBUG << "IpcConnection::~IpcConnection socket " << &socket_ << " deleted\n";
+}
+
+asio::awaitable<void> IpcConnection::start() {
+    try {
+        co_await do_read();
+    } catch (const std::system_error& se) {
+        if (se.code() == asio::error::eof || se.code() == asio::error::connection_reset || se.code() == asio::error::broken_pipe) {
+            SILKRPC_DEBUG << "IpcConnection::start close from client with code: " << se.code() << "\n" << std::flush;
+        } else if (se.code() != asio::error::operation_aborted) {
+            SILKRPC_ERROR << "IpcConnection::start system_error: " << se.what() << "\n" << std::flush;
+            throw;
+        } else {
+            SILKRPC_DEBUG << "IpcConnection::start operation_aborted: " << se.what() << "\n" << std::flush;
+        }
+    }
+}
+
+asio::awaitable<void> IpcConnection::do_read() {
+    while (true) {
+        // Waiting for the rest of a partial message is bounded by the read timeout, waiting for a new message by the idle one
+        timeouts_.start_read(/*partial_request=*/!incoming_.empty());
+
+        // Only the newly read data can contain the end of the next message
+        std::size_t search_begin = incoming_.size();
+        const auto bytes_read = co_await socket_.async_read_some(asio::buffer(buffer_), asio::use_awaitable);
+        timeouts_.stop_read();
+        SILKRPC_TRACE << "IpcConnection::do_read bytes_read: " << bytes_read << "\n";
+        incoming_.append(buffer_.data(), bytes_read);
+
+        // Process all the complete messages available in order, the last one can be incomplete
+        std::size_t message_begin{0};
+        for (auto message_end = incoming_.find('\n', search_begin); message_end != std::string::npos; message_end = incoming_.find('\n', message_begin)) {
+            std::string_view message{incoming_.data() + message_begin, message_end - message_begin};
+            message_begin = message_end + 1;
+            if (!message.empty() && message.back() == '\r') {
+                message.remove_suffix(1);
+            }
+            if (message.empty()) {
+                continue;
+            }
+
+            ChainedBuffer reply_content;
+            co_await request_handler_.handle_request_content(message, reply_content);
+            co_await do_write(reply_content);
+        }
+        incoming_.erase(0, message_begin);
+
+        if (incoming_.size() > max_message_size_) {
+            SILKRPC_WARN << "IpcConnection::do_read socket " << &socket_ << " message too big, closing\n";
+            asio::error_code ec;
+            socket_.close(ec);
+            co_return;
+        }
+    }
+}
+
+asio::awaitable<void> IpcConnection::do_write(const ChainedBuffer& reply_content) {
+    SILKRPC_DEBUG << "IpcConnection::do_write reply: " << reply_content << "\n" << std::flush;
+    std::vector<asio::const_buffer> buffers;
+    reply_content.to_buffers(buffers);
+    timeouts_.start_write();
+    const auto bytes_transferred = co_await asio::async_write(socket_, buffers, asio::use_awaitable);
+    timeouts_.stop_write();
+    SILKRPC_TRACE << "IpcConnection::do_write bytes_transferred: " << bytes_transferred << "\n" << std::flush;
+}
+
+} // namespace silkrpc::http
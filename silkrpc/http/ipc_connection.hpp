@@ -0,0 +1,89 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#ifndef SILKRPC_HTTP_IPC_CONNECTION_HPP_
+#define SILKRPC_HTTP_IPC_CONNECTION_HPP_
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include <silkrpc/config.hpp>
+
+#include <asio/awaitable.hpp>
+#include <asio/local/stream_protocol.hpp>
+
+#include <silkrpc/commands/admission_control.hpp>
+#include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
+#include <silkrpc/common/chained_buffer.hpp>
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/timer_wheel.hpp>
+#include <silkrpc/context_pool.hpp>
+#include <silkrpc/http/connection_io.hpp>
+#include <silkrpc/http/request_handler.hpp>
+
+namespace silkrpc::http {
+
+/// Represents a single connection from a local client over a Unix domain socket. There is no HTTP framing: each
+/// request is a JSON-RPC message terminated by newline and gets a reply terminated by newline, in the same order.
+class IpcConnection {
+public:
+    IpcConnection(const IpcConnection&) = delete;
+    IpcConnection& operator=(const IpcConnection&) = delete;
+
+    /// Construct a connection running within the given execution context, closed if a message exceeds the given size
+    /// or when a timeout among the given limits expires.
+    IpcConnection(Context& context, commands::RpcApi& rpc_api, commands::WorkerPools& workers, commands::RpcApiTable& handler_table,
+        commands::AdmissionControl& admission_control, const ConnectionLimits& limits, std::size_t max_message_size = kMaxIpcMessageSize);
+
+    ~IpcConnection();
+
+    asio::local::stream_protocol::socket& socket() { return socket_; }
+
+    /// Serve the connection until the client closes it.
+    asio::awaitable<void> start();
+
+private:
+    /// Read and process the incoming messages until the connection gets closed.
+    asio::awaitable<void> do_read();
+
+    /// Perform an asynchronous write operation.
+    asio::awaitable<void> do_write(const ChainedBuffer& reply_content);
+
+    /// Socket for the connection.
+    asio::local::stream_protocol::socket socket_;
+
+    /// The handler used to process the incoming requests.
+    RequestHandler request_handler_;
+
+    /// Buffer for incoming data.
+    std::array<char, kHttpIncomingBufferSize> buffer_;
+
+    /// The incoming data not yet processed, the last message can be incomplete.
+    std::string incoming_;
+
+    /// The maximum size of an incoming message.
+    std::size_t max_message_size_;
+
+    /// The idle, read and write timeouts.
+    ConnectionTimeouts<asio::local::stream_protocol::socket> timeouts_;
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_IPC_CONNECTION_HPP_
@@ -0,0 +1,116 @@
+/*
+   Copyright 2021 The Silkrpc Authors
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "ipc_connection.hpp"
+
+#include <array>
+#include <chrono>
+#include <future>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <asio/co_spawn.hpp>
+#include <asio/local/connect_pair.hpp>
+#include <asio/read.hpp>
+#include <asio/read_until.hpp>
+#include <asio/use_future.hpp>
+#include <asio/write.hpp>
+#include <catch2/catch.hpp>
+
+#include <silkrpc/http/connection_test_fixture.hpp>
+
+namespace silkrpc::http {
+
+TEST_CASE_METHOD(ConnectionTestFixture, "ipc connection", "[silkrpc][http][ipc_connection]") {
+    ConnectionLimits limits;
+    limits.idle_timeout = std::chrono::milliseconds{500};
+    limits.read_timeout = std::chrono::milliseconds{500};
+    IpcConnection connection{context_pool.get_context(), rpc_api, workers, rpc_api_table, admission_control, limits, /*max_message_size=*/1024};
+
+    // The client talks synchronously to the connection served on the context thread
+    asio::local::stream_protocol::socket client{context_pool.get_io_context()};
+    asio::local::connect_pair(connection.socket(), client);
+    auto served{asio::co_spawn(context_pool.get_io_context(), connection.start(), asio::use_future)};
+
+    const auto send = [&](std::string_view data) { asio::write(client, asio::buffer(data)); };
+    std::string incoming;
+    const auto receive = [&]() {
+        const auto size = asio::read_until(client, asio::dynamic_buffer(incoming), '\n');
+        const auto reply = incoming.substr(0, size);
+        incoming.erase(0, size);
+        return reply;
+    };
+
+    const auto sha3_request = [](int id) {
+        return R"({"jsonrpc":"2.0","id":)" + std::to_string(id) + R"(,"method":"web3_sha3","params":["0x"]})";
+    };
+    const auto sha3_reply = [](int id) {
+        return R"({"id":)" + std::to_string(id) + R"(,"jsonrpc":"2.0","result":"0xc5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"})";
+    };
+
+    SECTION("message split across reads") {
+        const auto request = sha3_request(1);
+        send(request.substr(0, 20));
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        send(request.substr(20) + "\n");
+        CHECK(receive() == sha3_reply(1) + "\n");
+    }
+
+    SECTION("multiple messages in one read") {
+        send(sha3_request(1) + "\n" + sha3_request(2) + "\n" + sha3_request(3) + "\n");
+        CHECK(receive() == sha3_reply(1) + "\n");
+        CHECK(receive() == sha3_reply(2) + "\n");
+        CHECK(receive() == sha3_reply(3) + "\n");
+    }
+
+    SECTION("CRLF terminated messages and empty lines") {
+        send("\r\n" + sha3_request(1) + "\r\n\n" + sha3_request(2) + "\r\n");
+        CHECK(receive() == sha3_reply(1) + "\n");
+        CHECK(receive() == sha3_reply(2) + "\n");
+    }
+
+    SECTION("batch on one line") {
+        send("[" + sha3_request(1) + "," + sha3_request(2) + "]\n");
+        CHECK(receive() == "[" + sha3_reply(1) + "," + sha3_reply(2) + "]\n");
+    }
+
+    SECTION("message too big closes the connection") {
+        send(sha3_request(1) + "\n" + std::string(2 * 1024, ' '));
+        CHECK(receive() == sha3_reply(1) + "\n");
+        std::array<char, 16> buffer{};
+        asio::error_code ec;
+        asio::read(client, asio::buffer(buffer), ec);
+        CHECK(ec == asio::error::eof);
+    }
+
+    SECTION("idle connection closed") {
+        send(sha3_request(1) + "\n");
+        CHECK(receive() == sha3_reply(1) + "\n");
+        CHECK(served.wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+    }
+
+    SECTION("partial message timed out") {
+        send(sha3_request(1).substr(0, 20));
+        CHECK(served.wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+    }
+
+    client.close();
+    CHECK_NOTHROW(served.get());
+    stop();
+}
+
+} // namespace silkrpc::http
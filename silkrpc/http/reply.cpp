@@ -8,6 +8,7 @@
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 //
 
+#include <charconv>
 #include <string>
 
 #include <silkrpc/common/log.hpp>
@@ -36,6 +37,7 @@ const std::string not_implemented = "HTTP/1.1 501 Not Implemented\r\n";
 const std::string bad_gateway = "HTTP/1.1 502 Bad Gateway\r\n";                     // NOLINT(runtime/string)
 const std::string service_unavailable = "HTTP/1.1 503 Service Unavailable\r\n";     // NOLINT(runtime/string)
 const std::string processing_continue = "HTTP/1.1 100 Continue\r\n";                // NOLINT(runtime/string)
+const std::string switching_protocols = "HTTP/1.1 101 Switching Protocols\r\n";     // NOLINT(runtime/string)
 
 asio::const_buffer to_buffer(Reply::StatusType status) {
     switch (status) {
@@ -73,6 +75,8 @@ asio::const_buffer to_buffer(Reply::StatusType status) {
             return asio::buffer(service_unavailable);
         case Reply::processing_continue:
             return asio::buffer(processing_continue);
+        case Reply::switching_protocols:
+            return asio::buffer(switching_protocols);
         default:
             return asio::buffer(internal_server_error);
     }
@@ -85,22 +89,42 @@ namespace misc_strings {
 const char name_value_separator[] = { ':', ' ' };
 const char crlf[] = { '\r', '\n' };
 const char lf[] = { '\n' };
+const char last_chunk[] = { '0', '\r', '\n', '\r', '\n' };
 
 } // namespace misc_strings
 
-std::vector<asio::const_buffer> Reply::to_buffers() {
+std::vector<asio::const_buffer> Reply::to_buffers(bool last_chunk) {
     std::vector<asio::const_buffer> buffers;
-    buffers.reserve(1+headers.size()*4+2);
-    buffers.push_back(status_strings::to_buffer(status));
-    for (std::size_t i = 0; i < headers.size(); ++i) {
-        Header& h = headers[i];
-        buffers.push_back(asio::buffer(h.name));
-        buffers.push_back(asio::buffer(misc_strings::name_value_separator));
-        buffers.push_back(asio::buffer(h.value));
+    buffers.reserve(1+headers.size()*4+1+content.num_chunks()+3);
+    if (!headers_sent) {
+        buffers.push_back(status_strings::to_buffer(status));
+        for (std::size_t i = 0; i < headers.size(); ++i) {
+            Header& h = headers[i];
+            buffers.push_back(asio::buffer(h.name));
+            buffers.push_back(asio::buffer(misc_strings::name_value_separator));
+            buffers.push_back(asio::buffer(h.value));
+            buffers.push_back(asio::buffer(misc_strings::crlf));
+        }
         buffers.push_back(asio::buffer(misc_strings::crlf));
+        headers_sent = chunked;
+    }
+    if (!chunked) {
+        content.to_buffers(buffers);
+    } else {
+        // An empty chunk would be taken as the last one
+        if (!content.empty()) {
+            chunk_size.resize(2 * sizeof(std::size_t) + 2);
+            const auto [end, ec] = std::to_chars(chunk_size.data(), chunk_size.data() + chunk_size.size(), content.size(), 16);
+            chunk_size.resize(end - chunk_size.data());
+            chunk_size.append("\r\n");
+            buffers.push_back(asio::buffer(chunk_size));
+            content.to_buffers(buffers);
+            buffers.push_back(asio::buffer(misc_strings::crlf));
+        }
+        if (last_chunk) {
+            buffers.push_back(asio::buffer(misc_strings::last_chunk));
+        }
     }
-    buffers.push_back(asio::buffer(misc_strings::crlf));
-    buffers.push_back(asio::buffer(content));
     SILKRPC_TRACE << "Reply::to_buffers buffers: " << buffers << "\n";
     return buffers;
 }
@@ -231,7 +255,7 @@ std::string to_string(Reply::StatusType status) {
 Reply Reply::stock_reply(Reply::StatusType status) {
     Reply rep;
     rep.status = status;
-    rep.content = stock_replies::to_string(status);
+    rep.content.append(stock_replies::to_string(status));
 
     if (status != processing_continue) {
        rep.headers.reserve(2);
@@ -15,6 +15,8 @@
 #include <vector>
 #include <asio/buffer.hpp>
 
+#include <silkrpc/common/chained_buffer.hpp>
+
 #include "header.hpp"
 
 namespace silkrpc::http {
@@ -24,6 +26,7 @@ struct Reply {
     /// The status of the reply.
     enum StatusType {
         processing_continue = 100,
+        switching_protocols = 101,
         ok = 200,
         created = 201,
         accepted = 202,
@@ -46,12 +49,23 @@ struct Reply {
     std::vector<Header> headers;
 
     /// The content to be sent in the reply.
-    std::string content;
+    ChainedBuffer content;
+
+    /// Whether the content is sent in chunks as it is produced (RFC 7230, section 4.1).
+    bool chunked{false};
+
+    /// Whether the status line and the headers have already been sent along with the first chunk.
+    bool headers_sent{false};
+
+    /// The size line of the chunk being sent.
+    std::string chunk_size;
 
     /// Convert the reply into a vector of buffers. The buffers do not own the
     /// underlying memory blocks, therefore the reply object must remain valid and
-    /// not be changed until the write operation has completed.
-    std::vector<asio::const_buffer> to_buffers();
+    /// not be changed until the write operation has completed. A chunked reply is
+    /// converted into the status line and headers, if not sent yet, followed by
+    /// the content as next chunk and by the last (empty) chunk if requested.
+    std::vector<asio::const_buffer> to_buffers(bool last_chunk = true);
 
     /// Get a stock reply.
     static Reply stock_reply(StatusType status);
@@ -59,7 +73,9 @@ struct Reply {
     // reset Reply data
     void reset() {
         headers.resize(0);
-        content.resize(0);
+        content.clear();
+        chunked = false;
+        headers_sent = false;
     }
 };
 
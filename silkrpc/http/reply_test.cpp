@@ -16,6 +16,9 @@
 
 #include "reply.hpp"
 
+#include <string>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
 namespace silkrpc::http {
@@ -26,14 +29,42 @@ TEST_CASE("check reply reset method", "[silkrpc][http][reply]") {
     Reply reply{
         Reply::StatusType::ok,
         std::vector<Header>{{"Accept", "*/*"}},
-        "{\"json\": \"2.0\"}",
     };
+    reply.content.append("{\"json\": \"2.0\"}");
     CHECK(reply.status == Reply::StatusType::ok);
     CHECK(reply.headers == std::vector<Header>{{"Accept", "*/*"}});
-    CHECK(reply.content == "{\"json\": \"2.0\"}");
+    CHECK(reply.content.to_string() == "{\"json\": \"2.0\"}");
     reply.reset();
     CHECK(reply.headers == std::vector<Header>{});
-    CHECK(reply.content == "");
+    CHECK(reply.content.to_string() == "");
+}
+
+std::string to_string(const std::vector<asio::const_buffer>& buffers) {
+    std::string data;
+    for (const auto& buffer : buffers) {
+        data.append(static_cast<const char*>(buffer.data()), buffer.size());
+    }
+    return data;
+}
+
+TEST_CASE("check chunked reply buffers", "[silkrpc][http][reply]") {
+    Reply reply{Reply::StatusType::ok, std::vector<Header>{{"Transfer-Encoding", "chunked"}}};
+    reply.chunked = true;
+
+    reply.content.append("{\"id\":1,\"result\":[");
+    CHECK(to_string(reply.to_buffers(/*last_chunk=*/false)) == "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n12\r\n{\"id\":1,\"result\":[\r\n");
+    CHECK(reply.headers_sent);
+
+    reply.content.clear();
+    reply.content.append("]}\n");
+    CHECK(to_string(reply.to_buffers()) == "3\r\n]}\n\r\n0\r\n\r\n");
+
+    reply.content.clear();
+    CHECK(to_string(reply.to_buffers()) == "0\r\n\r\n");
+
+    reply.reset();
+    CHECK(!reply.chunked);
+    CHECK(!reply.headers_sent);
 }
 
 } // namespace silkrpc::http
@@ -26,6 +26,9 @@
 #include <string>
 #include <vector>
 
+#include <silkrpc/common/constants.hpp>
+
+#include "compression.hpp"
 #include "header.hpp"
 
 namespace silkrpc::http {
@@ -39,6 +42,7 @@ struct Request {
     std::vector<Header> headers;
     uint32_t content_length{0};
     std::string content;
+    ContentEncoding accept_encoding{ContentEncoding::kIdentity};
 
     void reset() {
         method.resize(0);
@@ -47,7 +51,14 @@ struct Request {
         http_version_minor = 0;
         headers.resize(0);
         content_length = 0;
-        content.resize(0);
+        // A large content is not retained, so that the connection footprint does not keep the peak request size
+        if (content.capacity() > kRequestContentMaxRetainedCapacity) {
+            std::string{}.swap(content);
+            content.reserve(kRequestContentInitialCapacity);
+        } else {
+            content.resize(0);
+        }
+        accept_encoding = ContentEncoding::kIdentity;
     }
 };
 
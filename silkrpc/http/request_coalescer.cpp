@@ -0,0 +1,132 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "request_coalescer.hpp"
+
+#include <exception>
+#include <set>
+#include <string_view>
+#include <utility>
+
+#include <asio/redirect_error.hpp>
+#include <asio/this_coro.hpp>
+#include <asio/use_awaitable.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/http/methods.hpp>
+#include <silkrpc/json/envelope.hpp>
+
+namespace silkrpc::http {
+
+bool RequestCoalescer::is_coalescible(const std::string& method) {
+    // Methods having side effects or depending on per-client state (e.g. filters) must never be shared, neither must
+    // the ones whose huge replies are sent in chunks as they are produced (e.g. eth_getLogs)
+    static const std::set<std::string, std::less<>> kCoalescibleMethods{
+        method::k_eth_blockNumber,
+        method::k_eth_chainId,
+        method::k_eth_gasPrice,
+        method::k_eth_syncing,
+        method::k_eth_getBlockByHash,
+        method::k_eth_getBlockByNumber,
+        method::k_eth_getBlockTransactionCountByHash,
+        method::k_eth_getBlockTransactionCountByNumber,
+        method::k_eth_getBlockReceipts,
+        method::k_eth_getUncleByBlockHashAndIndex,
+        method::k_eth_getUncleByBlockNumberAndIndex,
+        method::k_eth_getUncleCountByBlockHash,
+        method::k_eth_getUncleCountByBlockNumber,
+        method::k_eth_getTransactionByHash,
+        method::k_eth_getTransactionByBlockHashAndIndex,
+        method::k_eth_getTransactionByBlockNumberAndIndex,
+        method::k_eth_getTransactionReceipt,
+        method::k_eth_getBalance,
+        method::k_eth_getCode,
+        method::k_eth_getTransactionCount,
+        method::k_eth_getStorageAt,
+        method::k_eth_call,
+        method::k_eth_estimateGas,
+    };
+    return kCoalescibleMethods.find(method) != kCoalescibleMethods.end();
+}
+
+std::string RequestCoalescer::make_key(const std::string& method, const nlohmann::json& request_json) {
+    std::string key{method};
+    key.push_back(' ');
+    if (request_json.contains("params")) {
+        key.append(request_json["params"].dump());
+    }
+    return key;
+}
+
+std::string RequestCoalescer::make_key(const std::string& method, const LazyRequestJson& request) {
+    std::string key{method};
+    key.push_back(' ');
+    key.append(request.params_text());
+    return key;
+}
+
+asio::awaitable<Reply::StatusType> RequestCoalescer::coalesce(const std::string& key, uint32_t request_id, ChainedBuffer& reply_content, const Handler& handler) {
+    const auto it = flights_.find(key);
+    if (it != flights_.end()) {
+        // Keep the flight alive after the leader has removed it from the map
+        const auto flight = it->second;
+        ++flight->num_waiters;
+        asio::error_code ec;
+        co_await flight->completed.async_wait(asio::redirect_error(asio::use_awaitable, ec));
+        if (flight->shared) {
+            ++num_coalesced_;
+            reply_content.append(flight->reply_prefix);
+            reply_content.append(std::to_string(request_id));
+            reply_content.append(flight->reply_suffix);
+            co_return flight->status;
+        }
+        SILKRPC_DEBUG << "RequestCoalescer::coalesce reply not shared, running again key: " << key << "\n";
+        co_return co_await handler(reply_content);
+    }
+
+    auto executor = co_await asio::this_coro::executor;
+    const auto flight = std::make_shared<Flight>(executor);
+    flights_.emplace(key, flight);
+
+    ChainedBuffer content;
+    std::exception_ptr eptr;
+    try {
+        flight->status = co_await handler(content);
+    } catch (...) {
+        eptr = std::current_exception();
+    }
+    flights_.erase(key);
+
+    if (!eptr && flight->num_waiters > 0) {
+        const auto reply = content.to_string();
+        std::string_view raw_id;
+        if (find_reply_id(reply, raw_id)) {
+            const auto id_offset = static_cast<std::size_t>(raw_id.data() - reply.data());
+            flight->reply_prefix = reply.substr(0, id_offset);
+            flight->reply_suffix = reply.substr(id_offset + raw_id.size());
+            flight->shared = true;
+        }
+    }
+    flight->completed.cancel();
+
+    if (eptr) {
+        std::rethrow_exception(eptr);
+    }
+    reply_content.append(std::move(content));
+    co_return flight->status;
+}
+
+} // namespace silkrpc::http
@@ -0,0 +1,94 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_REQUEST_COALESCER_HPP_
+#define SILKRPC_HTTP_REQUEST_COALESCER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <asio/awaitable.hpp>
+#include <asio/steady_timer.hpp>
+#include <nlohmann/json.hpp>
+
+#include <silkrpc/common/chained_buffer.hpp>
+#include <silkrpc/http/reply.hpp>
+#include <silkrpc/json/envelope.hpp>
+
+namespace silkrpc::http {
+
+/// Coalescing of identical read-only requests in flight on the connections of a single io_context: the first one
+/// runs the handler, the ones arriving meanwhile wait for it and get a copy of its serialized reply with their own id.
+/// Not thread-safe: all the requests must be handled on the io_context thread.
+class RequestCoalescer {
+public:
+    /// Write the reply to the request into the given content.
+    using Handler = std::function<asio::awaitable<Reply::StatusType>(ChainedBuffer&)>;
+
+    RequestCoalescer() = default;
+
+    RequestCoalescer(const RequestCoalescer&) = delete;
+    RequestCoalescer& operator=(const RequestCoalescer&) = delete;
+
+    /// Check if the replies to the given method depend just on its params and the chain state, so they can be shared.
+    static bool is_coalescible(const std::string& method);
+
+    /// Build the key identifying identical requests, i.e. same method and same params once serialized with sorted keys.
+    static std::string make_key(const std::string& method, const nlohmann::json& request_json);
+
+    /// Same as above for a request whose params may not be parsed yet: their text is taken as received, so identical
+    /// requests differing just in spacing or member order are not coalesced.
+    static std::string make_key(const std::string& method, const LazyRequestJson& request);
+
+    /// Write into the reply content the reply to the request with the given key and id, running the handler unless an
+    /// identical request is already in flight. Exceptions thrown by the handler are propagated to the leader only,
+    /// the waiting requests run the handler on their own in such case.
+    asio::awaitable<Reply::StatusType> coalesce(const std::string& key, uint32_t request_id, ChainedBuffer& reply_content, const Handler& handler);
+
+    /// The number of distinct requests currently in flight.
+    std::size_t num_in_flight() const { return flights_.size(); }
+
+    /// The total number of requests served by sharing the reply of another one.
+    uint64_t num_coalesced() const { return num_coalesced_; }
+
+private:
+    /// The execution shared by identical requests.
+    struct Flight {
+        explicit Flight(const asio::any_io_executor& executor) : completed{executor, asio::steady_timer::time_point::max()} {}
+
+        /// Cancelled when the leader completes, waking up the waiting requests.
+        asio::steady_timer completed;
+
+        std::size_t num_waiters{0};
+
+        /// True if the reply is available as the text around its id.
+        bool shared{false};
+        Reply::StatusType status{Reply::ok};
+        std::string reply_prefix;
+        std::string reply_suffix;
+    };
+
+    std::map<std::string, std::shared_ptr<Flight>> flights_;
+    uint64_t num_coalesced_{0};
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_REQUEST_COALESCER_HPP_
@@ -0,0 +1,111 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "request_coalescer.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <asio/co_spawn.hpp>
+#include <asio/detached.hpp>
+#include <asio/io_context.hpp>
+#include <asio/post.hpp>
+#include <asio/use_awaitable.hpp>
+#include <catch2/catch.hpp>
+
+#include <silkrpc/common/log.hpp>
+
+namespace silkrpc::http {
+
+TEST_CASE("coalescible methods", "[silkrpc][http][request_coalescer]") {
+    CHECK(RequestCoalescer::is_coalescible("eth_getBlockByNumber"));
+    CHECK(RequestCoalescer::is_coalescible("eth_gasPrice"));
+    CHECK(!RequestCoalescer::is_coalescible("eth_sendRawTransaction"));
+    CHECK(!RequestCoalescer::is_coalescible("eth_getFilterChanges"));
+    CHECK(!RequestCoalescer::is_coalescible("engine_newPayloadV1"));
+}
+
+TEST_CASE("coalescing key", "[silkrpc][http][request_coalescer]") {
+    const auto request1 = nlohmann::json::parse(R"({"jsonrpc":"2.0","id":1,"method":"eth_call","params":[{"to":"0x1","data":"0x"},"latest"]})");
+    const auto request2 = nlohmann::json::parse(R"({"id":2,"params":[{"data":"0x","to":"0x1"},"latest"],"method":"eth_call","jsonrpc":"2.0"})");
+    const auto request3 = nlohmann::json::parse(R"({"jsonrpc":"2.0","id":3,"method":"eth_call","params":[{"to":"0x1","data":"0x"},"0x10"]})");
+    CHECK(RequestCoalescer::make_key("eth_call", request1) == RequestCoalescer::make_key("eth_call", request2));
+    CHECK(RequestCoalescer::make_key("eth_call", request1) != RequestCoalescer::make_key("eth_call", request3));
+    CHECK(RequestCoalescer::make_key("eth_call", request1) != RequestCoalescer::make_key("eth_estimateGas", request1));
+
+    // Requests scanned from the envelope are keyed by their params text as received
+    const std::string content1{R"({"jsonrpc":"2.0","id":1,"method":"eth_call","params":[{"to":"0x1","data":"0x"},"latest"]})"};
+    const std::string content2{R"({"jsonrpc":"2.0","id":2,"method":"eth_call","params":[{"data":"0x","to":"0x1"},"latest"]})"};
+    RequestEnvelope envelope1, envelope2;
+    CHECK(parse_envelope(content1, envelope1));
+    CHECK(parse_envelope(content2, envelope2));
+    CHECK(RequestCoalescer::make_key("eth_call", LazyRequestJson{envelope2}) == RequestCoalescer::make_key("eth_call", request1));
+    CHECK(RequestCoalescer::make_key("eth_call", LazyRequestJson{envelope1}) != RequestCoalescer::make_key("eth_call", LazyRequestJson{envelope2}));
+}
+
+TEST_CASE("coalesce identical requests", "[silkrpc][http][request_coalescer]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    asio::io_context io_context;
+    RequestCoalescer coalescer;
+    int num_executions{0};
+    bool fail{false};
+
+    // Yield once, so that the requests spawned together are in flight at the same time
+    const RequestCoalescer::Handler handler = [&](ChainedBuffer& content) -> asio::awaitable<Reply::StatusType> {
+        ++num_executions;
+        co_await asio::post(io_context, asio::use_awaitable);
+        if (fail) {
+            throw std::runtime_error{"unexpected"};
+        }
+        content.append(R"({"id":1,"jsonrpc":"2.0","result":"0x2a"})");
+        co_return Reply::ok;
+    };
+
+    std::vector<ChainedBuffer> replies(3);
+    std::vector<int> failures(3);
+    for (std::size_t i{0}; i < replies.size(); ++i) {
+        asio::co_spawn(io_context, [&, i]() -> asio::awaitable<void> {
+            try {
+                co_await coalescer.coalesce("eth_gasPrice []", static_cast<uint32_t>(i + 1), replies[i], handler);
+            } catch (const std::runtime_error&) {
+                ++failures[i];
+            }
+        }, asio::detached);
+    }
+
+    SECTION("share the reply") {
+        io_context.run();
+        CHECK(num_executions == 1);
+        CHECK(coalescer.num_coalesced() == 2);
+        CHECK(coalescer.num_in_flight() == 0);
+        CHECK(replies[0].to_string() == R"({"id":1,"jsonrpc":"2.0","result":"0x2a"})");
+        CHECK(replies[1].to_string() == R"({"id":2,"jsonrpc":"2.0","result":"0x2a"})");
+        CHECK(replies[2].to_string() == R"({"id":3,"jsonrpc":"2.0","result":"0x2a"})");
+    }
+
+    SECTION("leader failure") {
+        fail = true;
+        io_context.run();
+        CHECK(num_executions == 3);
+        CHECK(failures == std::vector<int>{1, 1, 1});
+        CHECK(coalescer.num_coalesced() == 0);
+        CHECK(coalescer.num_in_flight() == 0);
+    }
+}
+
+} // namespace silkrpc::http
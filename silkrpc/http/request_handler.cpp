@@ -22,80 +22,398 @@
 
 #include "request_handler.hpp"
 
+#include <exception>
 #include <iostream>
+#include <memory>
+#include <string_view>
 #include <utility>
+#include <vector>
 
+#include <asio/compose.hpp>
+#include <asio/co_spawn.hpp>
+#include <asio/post.hpp>
+#include <asio/redirect_error.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/this_coro.hpp>
+#include <asio/use_awaitable.hpp>
 #include <nlohmann/json.hpp>
 
 #include <silkrpc/common/clock_time.hpp>
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/metrics.hpp>
 #include <silkrpc/http/header.hpp>
+#include <silkrpc/json/envelope.hpp>
+#include <silkrpc/json/stream.hpp>
 
 namespace silkrpc::http {
 
-asio::awaitable<void> RequestHandler::handle_request(const http::Request& request, http::Reply& reply) {
+asio::awaitable<void> RequestHandler::handle_request(const http::Request& request, http::Reply& reply, ChunkWriter write_chunk) {
     SILKRPC_DEBUG << "handle_request content: " << request.content << "\n";
     auto start = clock_time::now();
 
+    if (request.method == "GET" && request.uri == kMetricsPath) {
+        reply.content.clear();
+        reply.content.append(Metrics::scrape());
+        reply.status = http::Reply::ok;
+        reply.headers.reserve(2);
+        reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
+        reply.headers.emplace_back(http::Header{"Content-Type", "text/plain; version=0.0.4"});
+        co_return;
+    }
+
+    if (request.content.empty()) {
+        reply.content.clear();
+        reply.status = http::Reply::no_content;
+        reply.headers.reserve(2);
+        reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
+        reply.headers.emplace_back(http::Header{"Content-Type", "application/json"});
+        SILKRPC_INFO << "handle_request t=" << clock_time::since(start) << "ns\n";
+        co_return;
+    }
+
+    // Large replies are sent in chunks as soon as they are produced, if the client supports the chunked transfer coding
+    JsonStream::Flusher flusher;
+    if (write_chunk && (request.http_version_major > 1 || (request.http_version_major == 1 && request.http_version_minor >= 1))) {
+        flusher = [&](ChainedBuffer& /*content*/) -> asio::awaitable<void> {
+            if (!reply.chunked) {
+                reply.status = http::Reply::ok;
+                reply.chunked = true;
+                reply.headers.reserve(2);
+                reply.headers.emplace_back(http::Header{"Content-Type", "application/json"});
+                reply.headers.emplace_back(http::Header{"Transfer-Encoding", "chunked"});
+            }
+            co_await write_chunk();
+        };
+    }
+
+    const auto status = co_await handle_request_content(request.content, reply.content, flusher);
+    if (reply.chunked) {
+        // Status line and headers are gone, the remaining content will be sent as last chunk
+        SILKRPC_INFO << "handle_request t=" << clock_time::since(start) << "ns\n";
+        co_return;
+    }
+    reply.status = status;
+
+    // Small replies are not worth the compression overhead
+    bool compressed{false};
+    if (request.accept_encoding != ContentEncoding::kIdentity && reply.content.size() >= kMinCompressionSize) {
+        compressed = co_await compress_content(request.accept_encoding, reply.content);
+    }
+
+    reply.headers.reserve(4);
+    reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
+    reply.headers.emplace_back(http::Header{"Content-Type", "application/json"});
+    if (compressed) {
+        reply.headers.emplace_back(http::Header{"Content-Encoding", std::string{to_string(request.accept_encoding)}});
+        reply.headers.emplace_back(http::Header{"Vary", "Accept-Encoding"});
+    }
+
+    SILKRPC_INFO << "handle_request t=" << clock_time::since(start) << "ns\n";
+    co_return;
+}
+
+asio::awaitable<http::Reply::StatusType> RequestHandler::handle_request_content(std::string_view content, ChainedBuffer& reply_content,
+    JsonStream::Flusher flusher) {
+    http::Reply::StatusType status{http::Reply::ok};
     auto request_id{0};
+
+    // Once any content has been flushed, a failure can only abort the reply: appending an error would make it invalid JSON
+    bool flushed{false};
+    if (flusher) {
+        flusher = [&flushed, flush = std::move(flusher)](ChainedBuffer& content) -> asio::awaitable<void> {
+            flushed = true;
+            return flush(content);
+        };
+    }
+
     try {
-        if (request.content.empty()) {
-            reply.content = "";
-            reply.status = http::Reply::no_content;
-            reply.headers.reserve(2);
-            reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
-            reply.headers.emplace_back(http::Header{"Content-Type", "application/json"});
-            SILKRPC_INFO << "handle_request t=" << clock_time::since(start) << "ns\n";
-            co_return;
-        }
+        // Fast path for the common single request: routing needs just id and method, so no DOM is built for them
+        RequestEnvelope envelope;
+        if (parse_envelope(content, envelope)) {
+            request_id = envelope.id;
+            status = co_await handle_request_and_create_reply(envelope, reply_content, flusher);
+        } else {
+            const auto request_json = nlohmann::json::parse(content);
 
-        const auto request_json = nlohmann::json::parse(request.content);
-        request_id = request_json["id"].get<uint32_t>();
-        if (!request_json.contains("method")) {
-            reply.content = make_json_error(request_id, -32600, "method missing").dump() + "\n";
-            reply.status = http::Reply::bad_request;
-            reply.headers.reserve(2);
-            reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
-            reply.headers.emplace_back(http::Header{"Content-Type", "application/json"});
-            SILKRPC_INFO << "handle_request t=" << clock_time::since(start) << "ns\n";
-            co_return;
+            if (request_json.is_array()) {
+                co_await handle_batch_request(request_json, reply_content);
+            } else {
+                request_id = request_json["id"].get<uint32_t>();
+                status = co_await handle_request_and_create_reply(request_json, reply_content, flusher);
+            }
         }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "exception: " << e.what() << "\n";
+        if (flushed) {
+            throw;
+        }
+        write_error(reply_content, make_json_error(request_id, 100, e.what()));
+        status = http::Reply::internal_server_error;
+    } catch (...) {
+        SILKRPC_ERROR << "unexpected exception\n";
+        if (flushed) {
+            throw;
+        }
+        write_error(reply_content, make_json_error(request_id, 100, "unexpected exception"));
+        status = http::Reply::internal_server_error;
+    }
+    // A batch made of notifications only gets no reply at all
+    if (!reply_content.empty()) {
+        reply_content.append('\n');
+    }
 
-        const auto method = request_json["method"].get<std::string>();
-        const auto handle_method_opt = rpc_api_table_.find_handler(method);
-        if (!handle_method_opt) {
-            reply.content = make_json_error(request_id, -32601, "method not existent or not implemented").dump() + "\n";
-            reply.status = http::Reply::not_implemented;
-            reply.headers.reserve(2);
-            reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
-            reply.headers.emplace_back(http::Header{"Content-Type", "application/json"});
-            SILKRPC_INFO << "handle_request t=" << clock_time::since(start) << "ns\n";
-            co_return;
+    co_return status;
+}
+
+asio::awaitable<void> RequestHandler::handle_request(const nlohmann::json& request_json, ChainedBuffer& reply_content) {
+    if (request_json.is_array()) {
+        co_await handle_batch_request(request_json, reply_content);
+    } else {
+        co_await handle_batch_entry(request_json, reply_content);
+    }
+    co_return;
+}
+
+asio::awaitable<http::Reply::StatusType> RequestHandler::handle_request_and_create_reply(const RequestEnvelope& envelope, ChainedBuffer& reply_content,
+    JsonStream::Flusher flusher) {
+    const std::string method{envelope.method};
+    const auto handle_stream_opt = rpc_api_table_.find_stream_handler(method);
+    const auto handle_method_opt = handle_stream_opt ? std::nullopt : rpc_api_table_.find_handler(method);
+    if (!handle_stream_opt && !handle_method_opt) {
+        JsonStream{reply_content}.write_json(make_json_error(envelope.id, -32601, "method not existent or not implemented"));
+        co_return http::Reply::not_implemented;
+    }
+
+    // The params are parsed just before running the handler, never if the request is rejected or coalesced
+    LazyRequestJson request{envelope};
+    co_return co_await handle_known_request(request, method, envelope.id, handle_stream_opt, handle_method_opt, reply_content, flusher);
+}
+
+asio::awaitable<http::Reply::StatusType> RequestHandler::handle_request_and_create_reply(const nlohmann::json& request_json, ChainedBuffer& reply_content,
+    JsonStream::Flusher flusher) {
+    JsonStream stream{reply_content};
+
+    const auto request_id = request_json["id"].get<uint32_t>();
+    if (!request_json.contains("method")) {
+        stream.write_json(make_json_error(request_id, -32600, "method missing"));
+        co_return http::Reply::bad_request;
+    }
+
+    const auto method = request_json["method"].get<std::string>();
+
+    const auto handle_stream_opt = rpc_api_table_.find_stream_handler(method);
+    const auto handle_method_opt = handle_stream_opt ? std::nullopt : rpc_api_table_.find_handler(method);
+    if (!handle_stream_opt && !handle_method_opt) {
+        stream.write_json(make_json_error(request_id, -32601, "method not existent or not implemented"));
+        co_return http::Reply::not_implemented;
+    }
+
+    LazyRequestJson request{request_json};
+    co_return co_await handle_known_request(request, method, request_id, handle_stream_opt, handle_method_opt, reply_content, flusher);
+}
+
+asio::awaitable<http::Reply::StatusType> RequestHandler::handle_known_request(LazyRequestJson& request, const std::string& method,
+    uint32_t request_id, std::optional<commands::RpcApiTable::HandleStream> handle_stream_opt,
+    std::optional<commands::RpcApiTable::HandleMethod> handle_method_opt, ChainedBuffer& reply_content, JsonStream::Flusher flusher) {
+    // Latency includes the time spent queued by the admission control, error replies are told by their first member
+    const auto start_time = clock_time::now();
+    ++load_.requests;
+    try {
+        const auto status = co_await dispatch_request(request, method, request_id, handle_stream_opt, handle_method_opt, reply_content, flusher);
+        --load_.requests;
+        const bool error = status != http::Reply::ok || reply_content.starts_with(R"({"error")");
+        Metrics::local().record_request(method, clock_time::since(start_time), error);
+        co_return status;
+    } catch (...) {
+        --load_.requests;
+        Metrics::local().record_request(method, clock_time::since(start_time), /*error=*/true);
+        throw;
+    }
+}
+
+asio::awaitable<http::Reply::StatusType> RequestHandler::dispatch_request(LazyRequestJson& request, const std::string& method,
+    uint32_t request_id, std::optional<commands::RpcApiTable::HandleStream> handle_stream_opt,
+    std::optional<commands::RpcApiTable::HandleMethod> handle_method_opt, ChainedBuffer& reply_content, JsonStream::Flusher flusher) {
+    // Identical read-only requests in flight share a single execution, whose reply is copied with each own id: the
+    // requests just waiting for it hold neither admission permits nor worker pool slots
+    if (RequestCoalescer::is_coalescible(method)) {
+        const auto key = RequestCoalescer::make_key(method, request);
+        co_return co_await request_coalescer_.coalesce(key, request_id, reply_content, [&](ChainedBuffer& content) {
+            return admit_and_execute_request(request, method, request_id, handle_stream_opt, handle_method_opt, content, {});
+        });
+    }
+
+    co_return co_await admit_and_execute_request(request, method, request_id, handle_stream_opt, handle_method_opt, reply_content, flusher);
+}
+
+asio::awaitable<http::Reply::StatusType> RequestHandler::admit_and_execute_request(LazyRequestJson& request, const std::string& method,
+    uint32_t request_id, std::optional<commands::RpcApiTable::HandleStream> handle_stream_opt,
+    std::optional<commands::RpcApiTable::HandleMethod> handle_method_opt, ChainedBuffer& reply_content, JsonStream::Flusher flusher) {
+    // Shed load as soon as possible when the concurrency limits for the method are exceeded
+    const auto permit = co_await admission_control_.admit(method);
+    if (!permit) {
+        JsonStream{reply_content}.write_json(make_json_error(request_id, -32005, "too many concurrent requests"));
+        co_return http::Reply::service_unavailable;
+    }
+
+    // Methods routed to a dedicated worker pool cannot queue more work than the pool is configured to take
+    const auto worker_pool = workers_.find_routed_pool(method);
+    const auto worker_slot = worker_pool ? worker_pool->try_acquire() : std::nullopt;
+    if (worker_pool && !worker_slot) {
+        SILKRPC_WARN << "RequestHandler rejected method: " << method << " worker pool: " << worker_pool->name()
+            << " pending: " << worker_pool->pending() << "\n";
+        JsonStream{reply_content}.write_json(make_json_error(request_id, -32005, "worker pool busy"));
+        co_return http::Reply::service_unavailable;
+    }
+
+    co_return co_await execute_request(request, handle_stream_opt, handle_method_opt, reply_content, flusher);
+}
+
+asio::awaitable<http::Reply::StatusType> RequestHandler::execute_request(LazyRequestJson& request,
+    std::optional<commands::RpcApiTable::HandleStream> handle_stream_opt, std::optional<commands::RpcApiTable::HandleMethod> handle_method_opt,
+    ChainedBuffer& reply_content, JsonStream::Flusher flusher) {
+    const auto& request_json = request.get();
+    JsonStream stream{reply_content, flusher};
+
+    // Methods returning large results stream them directly into the reply content
+    if (handle_stream_opt) {
+        const auto handle_stream = handle_stream_opt.value();
+        co_await (rpc_api_.*handle_stream)(request_json, stream);
+        co_return http::Reply::ok;
+    }
+
+    const auto handle_method = handle_method_opt.value();
+    nlohmann::json reply_json;
+    co_await (rpc_api_.*handle_method)(request_json, reply_json);
+    stream.write_json(reply_json);
+    co_return http::Reply::ok;
+}
+
+asio::awaitable<void> RequestHandler::handle_batch_request(const nlohmann::json& request_json, ChainedBuffer& reply_content) {
+    SILKRPC_DEBUG << "handle_batch_request #entries: " << request_json.size() << "\n";
+    if (request_json.empty()) {
+        // JSON-RPC 2.0 requires a null id when the request id cannot be determined
+        const nlohmann::json error_json{{"jsonrpc", "2.0"}, {"id", nullptr}, {"error", {{"code", -32600}, {"message", "empty batch"}}}};
+        JsonStream{reply_content}.write_json(error_json);
+        co_return;
+    }
+
+    // Run the batch entries concurrently on the connection executor, keeping at most kMaxBatchConcurrency in flight.
+    // The state is shared with the completion handlers of the entries, so it outlives this frame if destroyed first
+    struct BatchState {
+        asio::steady_timer entry_completed;
+        std::size_t entries_in_flight{0};
+        std::vector<ChainedBuffer> replies;
+    };
+    auto executor = co_await asio::this_coro::executor;
+    auto state = std::make_shared<BatchState>(BatchState{asio::steady_timer{executor}, 0, std::vector<ChainedBuffer>(request_json.size())});
+    for (std::size_t i{0}; i < request_json.size(); ++i) {
+        while (state->entries_in_flight >= kMaxBatchConcurrency) {
+            state->entry_completed.expires_at(asio::steady_timer::time_point::max());
+            asio::error_code ec;
+            co_await state->entry_completed.async_wait(asio::redirect_error(asio::use_awaitable, ec));
         }
-        const auto handle_method = handle_method_opt.value();
+        ++state->entries_in_flight;
+        asio::co_spawn(executor, handle_batch_entry(request_json[i], state->replies[i]), [state](std::exception_ptr eptr) {
+            --state->entries_in_flight;
+            state->entry_completed.cancel();
+        });
+    }
+    while (state->entries_in_flight > 0) {
+        state->entry_completed.expires_at(asio::steady_timer::time_point::max());
+        asio::error_code ec;
+        co_await state->entry_completed.async_wait(asio::redirect_error(asio::use_awaitable, ec));
+    }
 
-        nlohmann::json reply_json;
-        co_await (rpc_api_.*handle_method)(request_json, reply_json);
+    // Assemble the batch reply preserving the order of the batch request, entry contents are moved not copied.
+    // Notifications have no reply, so the reply is left empty if the batch contains nothing else
+    bool first_entry{true};
+    for (auto& entry_reply : state->replies) {
+        if (entry_reply.empty()) {
+            continue;
+        }
+        reply_content.append(first_entry ? '[' : ',');
+        reply_content.append(std::move(entry_reply));
+        first_entry = false;
+    }
+    if (!first_entry) {
+        reply_content.append(']');
+    }
+    co_return;
+}
 
-        reply.content = reply_json.dump(
-            /*indent=*/-1, /*indent_char=*/' ', /*ensure_ascii=*/false, nlohmann::json::error_handler_t::replace) + "\n";
-        reply.status = http::Reply::ok;
+asio::awaitable<void> RequestHandler::handle_batch_entry(const nlohmann::json& request_json, ChainedBuffer& reply_content) {
+    uint32_t request_id{0};
+    try {
+        if (!request_json.is_object()) {
+            // JSON-RPC 2.0 requires a null id when the request id cannot be determined
+            const nlohmann::json error_json{{"jsonrpc", "2.0"}, {"id", nullptr}, {"error", {{"code", -32600}, {"message", "invalid request"}}}};
+            JsonStream{reply_content}.write_json(error_json);
+            co_return;
+        }
+        if (!request_json.contains("id")) {
+            // JSON-RPC 2.0 notifications must not be replied, not even within a batch
+            SILKRPC_DEBUG << "handle_batch_entry notification ignored\n";
+            co_return;
+        }
+        request_id = request_json["id"].get<uint32_t>();
+        co_await handle_request_and_create_reply(request_json, reply_content, {});
     } catch (const std::exception& e) {
         SILKRPC_ERROR << "exception: " << e.what() << "\n";
-        reply.content = make_json_error(request_id, 100, e.what()).dump() + "\n";
-        reply.status = http::Reply::internal_server_error;
+        write_error(reply_content, make_json_error(request_id, 100, e.what()));
     } catch (...) {
         SILKRPC_ERROR << "unexpected exception\n";
-        reply.content = make_json_error(request_id, 100, "unexpected exception").dump() + "\n";
-        reply.status = http::Reply::internal_server_error;
+        write_error(reply_content, make_json_error(request_id, 100, "unexpected exception"));
     }
+    co_return;
+}
 
-    reply.headers.reserve(2);
-    reply.headers.emplace_back(http::Header{"Content-Length", std::to_string(reply.content.size())});
-    reply.headers.emplace_back(http::Header{"Content-Type", "application/json"});
+asio::awaitable<bool> RequestHandler::compress_content(ContentEncoding encoding, ChainedBuffer& content) {
+    const auto uncompressed_size = content.size();
+    std::unique_ptr<Compressor> compressor;
+    try {
+        compressor = compressor_pool_.acquire(encoding);
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "compress_content exception: " << e.what() << "\n";
+        co_return false;
+    }
 
-    SILKRPC_INFO << "handle_request t=" << clock_time::since(start) << "ns\n";
-    co_return;
+    // Compression is CPU-bound, so run it on the workers and get back to the io_context thread when done
+    auto executor = co_await asio::this_coro::executor;
+    ChainedBuffer compressed_content;
+    const auto success = co_await asio::async_compose<decltype(asio::use_awaitable), void(bool)>(
+        [&](auto&& self) {
+            workers_.default_pool().post([&, self = std::move(self)]() mutable {
+                bool success{true};
+                {
+                    WorkerTaskTimer task_timer;
+                    try {
+                        compressor->compress(content, compressed_content);
+                    } catch (const std::exception& e) {
+                        SILKRPC_ERROR << "compress_content exception: " << e.what() << "\n";
+                        success = false;
+                    }
+                }
+                asio::post(executor, [success, self = std::move(self)]() mutable {
+                    self.complete(success);
+                });
+            });
+        },
+        asio::use_awaitable);
+    compressor_pool_.release(std::move(compressor));
+
+    if (success) {
+        content = std::move(compressed_content);
+        SILKRPC_DEBUG << "compress_content encoding: " << to_string(encoding) << " size: " << uncompressed_size << " -> " << content.size() << "\n";
+    }
+    co_return success;
+}
+
+void RequestHandler::write_error(ChainedBuffer& reply_content, const nlohmann::json& error_json) {
+    // Discard any partial output written before the failure
+    reply_content.clear();
+    JsonStream{reply_content}.write_json(error_json);
 }
 
 } // namespace silkrpc::http
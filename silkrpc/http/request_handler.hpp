@@ -17,36 +17,108 @@
 #ifndef SILKRPC_HTTP_REQUEST_HANDLER_HPP_
 #define SILKRPC_HTTP_REQUEST_HANDLER_HPP_
 
+#include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 
 #include <silkrpc/config.hpp>
 
 #include <asio/awaitable.hpp>
-#include <asio/thread_pool.hpp>
+#include <nlohmann/json.hpp>
 
+#include <silkrpc/common/chained_buffer.hpp>
 #include <silkrpc/context_pool.hpp>
+#include <silkrpc/commands/admission_control.hpp>
 #include <silkrpc/commands/rpc_api.hpp>
 #include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
+#include <silkrpc/http/compression.hpp>
 #include <silkrpc/http/reply.hpp>
 #include <silkrpc/http/request.hpp>
+#include <silkrpc/http/request_coalescer.hpp>
+#include <silkrpc/json/envelope.hpp>
+#include <silkrpc/json/stream.hpp>
 
 namespace silkrpc::http {
 
 class RequestHandler {
 public:
-    RequestHandler(Context& context, asio::thread_pool& workers, const commands::RpcApiTable& rpc_api_table)
-        : rpc_api_{context, workers}, rpc_api_table_(rpc_api_table) {}
+    /// Send the reply produced so far: status line, headers and content as first chunk, then content as next chunks.
+    using ChunkWriter = std::function<asio::awaitable<void>()>;
+
+    /// The API handlers are stateless and shared by all the connections served by the same context.
+    RequestHandler(Context& context, commands::RpcApi& rpc_api, commands::WorkerPools& workers, const commands::RpcApiTable& rpc_api_table,
+        commands::AdmissionControl& admission_control)
+        : rpc_api_(rpc_api), rpc_api_table_(rpc_api_table), admission_control_(admission_control),
+          compressor_pool_(*context.compressor_pool),
+          request_coalescer_(*context.request_coalescer), load_(*context.load), workers_(workers) {}
 
     RequestHandler(const RequestHandler&) = delete;
     RequestHandler& operator=(const RequestHandler&) = delete;
 
-    asio::awaitable<void> handle_request(const http::Request& request, http::Reply& reply);
+    /// Handle the HTTP request writing the reply, whose content is sent in chunks using the given writer once it
+    /// grows large, if any. If the reply fails when already chunked, the error is rethrown and the reply must be aborted.
+    asio::awaitable<void> handle_request(const http::Request& request, http::Reply& reply, ChunkWriter write_chunk = {});
+
+    /// Handle a single or batch JSON-RPC request received over a message-oriented transport (e.g. WebSocket).
+    asio::awaitable<void> handle_request(const nlohmann::json& request_json, ChainedBuffer& reply_content);
+
+    /// Handle the single or batch JSON-RPC request contained in the given text, writing the newline-terminated reply.
+    /// Any error is reported as JSON-RPC error within the reply, the returned status is meaningful just for HTTP.
+    /// An error raised after the flusher has consumed part of the reply is rethrown instead, so that the reply is aborted.
+    asio::awaitable<http::Reply::StatusType> handle_request_content(std::string_view content, ChainedBuffer& reply_content,
+        JsonStream::Flusher flusher = {});
 
 private:
-    commands::RpcApi rpc_api_;
+    asio::awaitable<http::Reply::StatusType> handle_request_and_create_reply(const RequestEnvelope& envelope, ChainedBuffer& reply_content,
+        JsonStream::Flusher flusher);
+
+    asio::awaitable<http::Reply::StatusType> handle_request_and_create_reply(const nlohmann::json& request_json, ChainedBuffer& reply_content,
+        JsonStream::Flusher flusher);
+
+    /// Record the metrics of a request for a method having a handler, while dispatching it.
+    asio::awaitable<http::Reply::StatusType> handle_known_request(LazyRequestJson& request, const std::string& method,
+        uint32_t request_id, std::optional<commands::RpcApiTable::HandleStream> handle_stream_opt,
+        std::optional<commands::RpcApiTable::HandleMethod> handle_method_opt,
+        ChainedBuffer& reply_content, JsonStream::Flusher flusher);
+
+    /// Run the request directly or coalesced with identical ones: only the request actually running is admitted.
+    asio::awaitable<http::Reply::StatusType> dispatch_request(LazyRequestJson& request, const std::string& method,
+        uint32_t request_id, std::optional<commands::RpcApiTable::HandleStream> handle_stream_opt,
+        std::optional<commands::RpcApiTable::HandleMethod> handle_method_opt,
+        ChainedBuffer& reply_content, JsonStream::Flusher flusher);
+
+    /// Apply the admission control and the worker pool bound, then run the API handler of the method.
+    asio::awaitable<http::Reply::StatusType> admit_and_execute_request(LazyRequestJson& request, const std::string& method,
+        uint32_t request_id, std::optional<commands::RpcApiTable::HandleStream> handle_stream_opt,
+        std::optional<commands::RpcApiTable::HandleMethod> handle_method_opt,
+        ChainedBuffer& reply_content, JsonStream::Flusher flusher);
+
+    /// Run the API handler of the method, writing the reply into the given content that the flusher may consume.
+    asio::awaitable<http::Reply::StatusType> execute_request(LazyRequestJson& request,
+        std::optional<commands::RpcApiTable::HandleStream> handle_stream_opt,
+        std::optional<commands::RpcApiTable::HandleMethod> handle_method_opt,
+        ChainedBuffer& reply_content, JsonStream::Flusher flusher);
+
+    asio::awaitable<void> handle_batch_request(const nlohmann::json& request_json, ChainedBuffer& reply_content);
+
+    asio::awaitable<void> handle_batch_entry(const nlohmann::json& request_json, ChainedBuffer& reply_content);
+
+    static void write_error(ChainedBuffer& reply_content, const nlohmann::json& error_json);
+
+    /// Compress the reply content using the given encoding, off the io_context thread. Return false on failure.
+    asio::awaitable<bool> compress_content(ContentEncoding encoding, ChainedBuffer& content);
+
+    commands::RpcApi& rpc_api_;
     const commands::RpcApiTable& rpc_api_table_;
+    commands::AdmissionControl& admission_control_;
+    CompressorPool& compressor_pool_;
+    RequestCoalescer& request_coalescer_;
+    ContextLoad& load_;
+    commands::WorkerPools& workers_;
 };
 
 } // namespace silkrpc::http
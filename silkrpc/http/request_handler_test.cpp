@@ -16,7 +16,9 @@
 
 #include "request_handler.hpp"
 
+#include <chrono>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -24,8 +26,14 @@
 #include <asio/thread_pool.hpp>
 #include <asio/use_future.hpp>
 #include <catch2/catch.hpp>
+#include <grpcpp/grpcpp.h>
 #include <silkworm/common/util.hpp>
 
+#include <silkrpc/commands/admission_control.hpp>
+#include <silkrpc/commands/rpc_api.hpp>
+#include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
+#include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/context_pool.hpp>
 #include <silkrpc/http/request.hpp>
@@ -60,7 +68,7 @@ TEST_CASE("check handle_request  empty content ", "[silkrpc][handle_request]") {
        CHECK(false);
     }
 
-    CHECK(reply.content == "");
+    CHECK(reply.content.to_string() == "");
     CHECK(reply.status == 204);
     CHECK(reply.headers.size() == 2);
     CHECK(reply.headers[0].name == "Content-Length");
@@ -96,7 +104,7 @@ TEST_CASE("check handle_request no method", "[silkrpc][handle_request]") {
     } catch (...) {
        CHECK(false);
     }
-    CHECK(reply.content == "{\"error\":{\"code\":-32600,\"message\":\"method missing\"},\"id\":3,\"jsonrpc\":\"2.0\"}\n");
+    CHECK(reply.content.to_string() == "{\"error\":{\"code\":-32600,\"message\":\"method missing\"},\"id\":3,\"jsonrpc\":\"2.0\"}\n");
     CHECK(reply.status == 400);
     CHECK(reply.headers.size() == 2);
     CHECK(reply.headers[0].name == "Content-Length");
@@ -132,7 +140,7 @@ TEST_CASE("check handle_request invalid method", "[silkrpc][handle_request]") {
     } catch (...) {
        CHECK(false);
     }
-    CHECK(reply.content == "{\"error\":{\"code\":-32601,\"message\":\"method not existent or not implemented\"},\"id\":3,\"jsonrpc\":\"2.0\"}\n");
+    CHECK(reply.content.to_string() == "{\"error\":{\"code\":-32601,\"message\":\"method not existent or not implemented\"},\"id\":3,\"jsonrpc\":\"2.0\"}\n");
     CHECK(reply.status == 501);
     CHECK(reply.headers.size() == 2);
     CHECK(reply.headers[0].name == "Content-Length");
@@ -169,7 +177,7 @@ TEST_CASE("check handle_request method return failed", "[silkrpc][handle_request
     } catch (...) {
        CHECK(false);
     }
-    CHECK(reply.content == "{\"error\":{\"code\":100,\"message\":\"invalid getBlockByNumber params: []\"},\"id\":3,\"jsonrpc\":\"2.0\"}\n");
+    CHECK(reply.content.to_string() == "{\"error\":{\"code\":100,\"message\":\"invalid getBlockByNumber params: []\"},\"id\":3,\"jsonrpc\":\"2.0\"}\n");
     CHECK(reply.status == 200);
     CHECK(reply.headers.size() == 2);
     CHECK(reply.headers[0].name == "Content-Length");
@@ -181,5 +189,99 @@ TEST_CASE("check handle_request method return failed", "[silkrpc][handle_request
 */
 }
 
-} // namespace silkrpc::http
+TEST_CASE("check handle_request batch", "[silkrpc][handle_request]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    ContextPool cp{1, []() { return grpc::CreateChannel("localhost", grpc::InsecureChannelCredentials()); }};
+    auto context_pool_thread = std::thread([&]() { cp.run(); });
+    commands::WorkerPools workers{1, 1};
+    commands::RpcApi rpc_api{cp.get_context(), workers};
+    commands::RpcApiTable rpc_api_table{kDefaultEth1ApiSpec};
+    commands::AdmissionControl admission_control{"web3_sha3:1:64"};
+    RequestHandler handler{cp.get_context(), rpc_api, workers, rpc_api_table, admission_control};
+
+    // Keccak-256 hash of the empty input
+    const std::string empty_hash{"0xc5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"};
+    const auto sha3_request = [](std::size_t id) {
+        return R"({"jsonrpc":"2.0","id":)" + std::to_string(id) + R"(,"method":"web3_sha3","params":["0x"]})";
+    };
+    const auto sha3_reply = [&](std::size_t id) {
+        return R"({"id":)" + std::to_string(id) + R"(,"jsonrpc":"2.0","result":")" + empty_hash + R"("})";
+    };
+
+    SECTION("mixed valid and invalid entries keep their order") {
+        const std::string content{"[" + sha3_request(1) + R"(,{"jsonrpc":"2.0","id":2,"method":"eth_AAA"},{"jsonrpc":"2.0","id":3},)"
+            R"({"jsonrpc":"2.0","method":"web3_sha3","params":["0x"]},1,)" + sha3_request(5) + "]"};
+        ChainedBuffer reply_content;
+        auto result{asio::co_spawn(cp.get_io_context(), handler.handle_request_content(content, reply_content), asio::use_future)};
+        CHECK(result.get() == Reply::ok);
+        CHECK(reply_content.to_string() == "[" + sha3_reply(1) + ","
+            R"({"error":{"code":-32601,"message":"method not existent or not implemented"},"id":2,"jsonrpc":"2.0"},)"
+            R"({"error":{"code":-32600,"message":"method missing"},"id":3,"jsonrpc":"2.0"},)"
+            R"({"error":{"code":-32600,"message":"invalid request"},"id":null,"jsonrpc":"2.0"},)" + sha3_reply(5) + "]\n");
+    }
+
+    SECTION("notifications get no reply") {
+        const std::string notification{R"({"jsonrpc":"2.0","method":"web3_sha3","params":["0x"]})"};
+        const std::string content{"[" + notification + "," + sha3_request(0) + "]"};
+        ChainedBuffer reply_content;
+        auto result{asio::co_spawn(cp.get_io_context(), handler.handle_request_content(content, reply_content), asio::use_future)};
+        CHECK(result.get() == Reply::ok);
+        CHECK(reply_content.to_string() == "[" + sha3_reply(0) + "]\n");
+
+        // A batch made of notifications only gets no reply at all
+        const std::string notifications_content{"[" + notification + "," + notification + "]"};
+        ChainedBuffer notifications_reply_content;
+        result = asio::co_spawn(cp.get_io_context(), handler.handle_request_content(notifications_content, notifications_reply_content),
+            asio::use_future);
+        CHECK(result.get() == Reply::ok);
+        CHECK(notifications_reply_content.empty());
+    }
 
+    SECTION("empty batch") {
+        const std::string content{"[]"};
+        ChainedBuffer reply_content;
+        auto result{asio::co_spawn(cp.get_io_context(), handler.handle_request_content(content, reply_content), asio::use_future)};
+        CHECK(result.get() == Reply::ok);
+        CHECK(reply_content.to_string() == R"({"error":{"code":-32600,"message":"empty batch"},"id":null,"jsonrpc":"2.0"})" "\n");
+    }
+
+    SECTION("entries in flight are capped") {
+        // Holding the only running slot of the method, the entries in flight pile up in the admission control queue
+        auto permit{asio::co_spawn(cp.get_io_context(), admission_control.admit("web3_sha3"), asio::use_future).get()};
+        REQUIRE(permit);
+        const auto queued = [&]() {
+            std::size_t num_queued{0};
+            admission_control.for_each_limiter([&](const auto& /*name*/, const auto& limiter) { num_queued = limiter.queued(); });
+            return num_queued;
+        };
+
+        const std::size_t num_entries{kMaxBatchConcurrency + 8};
+        std::string content{"["};
+        std::string expected_reply{"["};
+        for (std::size_t i{0}; i < num_entries; ++i) {
+            content += (i > 0 ? "," : "") + sha3_request(i);
+            expected_reply += (i > 0 ? "," : "") + sha3_reply(i);
+        }
+        content += "]";
+        expected_reply += "]\n";
+
+        ChainedBuffer reply_content;
+        auto result{asio::co_spawn(cp.get_io_context(), handler.handle_request_content(content, reply_content), asio::use_future)};
+        while (queued() < kMaxBatchConcurrency) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        CHECK(queued() == kMaxBatchConcurrency);
+
+        permit.reset();
+        CHECK(result.get() == Reply::ok);
+        CHECK(queued() == 0);
+        CHECK(reply_content.to_string() == expected_reply);
+    }
+
+    cp.stop();
+    context_pool_thread.join();
+}
+
+} // namespace silkrpc::http
@@ -208,15 +208,21 @@ RequestParser::ResultType RequestParser::consume(Request& req, char input) {
         case expecting_newline_3:
             if (input == '\n') {
                 state_ = content_start;
-                // Look for Content-Length header to get content size
+                // Look for Accept-Encoding header to negotiate the reply content encoding
+                const auto accept_encoding = std::find_if(req.headers.begin(), req.headers.end(), [&](const Header& h){
+                    return iequals(h.name, "Accept-Encoding");
+                });
+                if (accept_encoding != req.headers.end()) {
+                    req.accept_encoding = negotiate_content_encoding(accept_encoding->value);
+                }
+                // Look for Content-Length header to get content size, requests without it (e.g. GET) have no content
                 if (req.content_length == 0) {
                     const auto it = std::find_if(req.headers.begin(), req.headers.end(), [&](const Header& h){
-                        return h.name == "Content-Length";
+                        return iequals(h.name, "Content-Length");
                     });
-                    if (it == req.headers.end()) {
-                        return bad;
+                    if (it != req.headers.end()) {
+                        req.content_length = std::atoi((*it).value.c_str());
                     }
-                    req.content_length = std::atoi((*it).value.c_str());
                 }
                 if (req.content_length == 0) {
                     return good;
@@ -46,15 +46,15 @@ public:
     /// required. The InputIterator return value indicates how much of the input
     /// has been consumed.
     template <typename InputIterator>
-    ResultType parse(Request& req, InputIterator begin, InputIterator end) {
+    std::tuple<ResultType, InputIterator> parse(Request& req, InputIterator begin, InputIterator end) {
         while (begin != end) {
             ResultType result = consume(req, *begin++);
             if (result == good || result == bad || result == processing_continue) {
-                return result;
+                return std::make_tuple(result, begin);
             }
         }
 
-        return indeterminate;
+        return std::make_tuple(indeterminate, begin);
     }
 
 private:
@@ -34,7 +34,7 @@ TEST_CASE("parse", "[silkrpc][http][request_parser]") {
             silkrpc::http::Request req;
             std::array<char, 1> buffer{c};
             std::size_t bytes_read{1};
-            const auto result{parser.parse(req, buffer.data(), buffer.data() + bytes_read)};
+            const auto [result, _]{parser.parse(req, buffer.data(), buffer.data() + bytes_read)};
             CHECK(result == RequestParser::bad);
         }
     }
@@ -46,7 +46,7 @@ TEST_CASE("parse", "[silkrpc][http][request_parser]") {
             silkrpc::http::Request req;
             std::array<char, 1> buffer{c};
             std::size_t bytes_read{1};
-            const auto result{parser.parse(req, buffer.data(), buffer.data() + bytes_read)};
+            const auto [result, _]{parser.parse(req, buffer.data(), buffer.data() + bytes_read)};
             CHECK(result == RequestParser::bad);
         }
     }
@@ -56,7 +56,7 @@ TEST_CASE("parse", "[silkrpc][http][request_parser]") {
         silkrpc::http::Request req;
         std::array<char, 0> buffer;
         std::size_t bytes_read{0};
-        const auto result{parser.parse(req, buffer.data(), buffer.data() + bytes_read)};
+        const auto [result, _]{parser.parse(req, buffer.data(), buffer.data() + bytes_read)};
         CHECK(result == RequestParser::indeterminate);
     }
 
@@ -68,7 +68,7 @@ TEST_CASE("parse", "[silkrpc][http][request_parser]") {
         for (const auto& s : continue_requests) {
             silkrpc::http::RequestParser parser;
             silkrpc::http::Request req;
-            const auto result{parser.parse(req, s.data(), s.data() + s.size())};
+            const auto [result, _]{parser.parse(req, s.data(), s.data() + s.size())};
             CHECK(result == RequestParser::processing_continue);
         }
     }
@@ -88,17 +88,15 @@ TEST_CASE("parse", "[silkrpc][http][request_parser]") {
             "POST / HTTP/1.*",
             "POST / HTTP/1.1*",
             "POST / HTTP/1.1\r*",
-            "POST / HTTP/1.1\r\n\r\n",
             "POST / HTTP/1.1\r\nHost:*",
             "POST / HTTP/1.1\r\nHost: localhost:8545\r*",
             "POST / HTTP/1.1\r\nHost: localhost:8545\r\nUser-Agent: curl/7.68.0\r\nAccept: */*\r\nContent-Type: application/json\r\nContent-Length: 0\r\n\r\t", // invalid char instead of \n
             "POST / HTTP/1.1\r\nHost: localhost:8545\r\nUser-Agent: curl/7.68.0\r\nAccept: */*\r\nContent-Type: application/json\r\nContent-Length: 0\r\n{", // missing \r\n
-            "POST / HTTP/1.1\r\nExpect: 100-continue\r\n\r\n",
         };
         for (const auto& s : bad_requests) {
             silkrpc::http::RequestParser parser;
             silkrpc::http::Request req;
-            const auto result{parser.parse(req, s.data(), s.data() + s.size())};
+            const auto [result, _]{parser.parse(req, s.data(), s.data() + s.size())};
             CHECK(result == RequestParser::bad);
         }
     }
@@ -118,7 +116,7 @@ TEST_CASE("parse", "[silkrpc][http][request_parser]") {
         for (const auto& s : incomplete_requests) {
             silkrpc::http::RequestParser parser;
             silkrpc::http::Request req;
-            const auto result{parser.parse(req, s.data(), s.data() + s.size())};
+            const auto [result, _]{parser.parse(req, s.data(), s.data() + s.size())};
             CHECK(result == RequestParser::indeterminate);
         }
     }
@@ -126,6 +124,8 @@ TEST_CASE("parse", "[silkrpc][http][request_parser]") {
     SECTION("good requests") {
         std::vector<std::string> good_requests{
             "POST / HTTP/1.1\r\nContent-Length: 0\r\n\r\n",
+            "POST / HTTP/1.1\r\n\r\n", // no Content-Length means no content
+            "GET / HTTP/1.1\r\nHost: localhost:8545\r\nUser-Agent: curl/7.68.0\r\nAccept: */*\r\n\r\n",
             "POST / HTTP/1.1\r\nExpect: 100-continue\r\nContent-Length: 0\r\n\r\n",
             "POST / HTTP/1.1\r\nHost: localhost:8545\r\nUser-Agent: curl/7.68.0\r\nAccept: */*\r\nContent-Type: application/json\r\nContent-Length: 0\r\n\r\n",
             "POST / HTTP/1.1\r\nHost: localhost:8545 \r\nUser-Agent: curl/7.68.0 \r\nAccept: */* \r\nContent-Type: application/json \r\nContent-Length: 0\r\n\r\n",
@@ -135,10 +135,66 @@ TEST_CASE("parse", "[silkrpc][http][request_parser]") {
         for (const auto& s : good_requests) {
             silkrpc::http::RequestParser parser;
             silkrpc::http::Request req;
-            const auto result{parser.parse(req, s.data(), s.data() + s.size())};
+            const auto [result, _]{parser.parse(req, s.data(), s.data() + s.size())};
             CHECK(result == RequestParser::good);
         }
     }
+
+    SECTION("accept encoding") {
+        const std::string s{"POST / HTTP/1.1\r\nAccept-Encoding: gzip, deflate\r\nContent-Length: 0\r\n\r\n"};
+        silkrpc::http::RequestParser parser;
+        silkrpc::http::Request req;
+        const auto [result, _]{parser.parse(req, s.data(), s.data() + s.size())};
+        CHECK(result == RequestParser::good);
+        CHECK(req.accept_encoding == silkrpc::http::ContentEncoding::kGzip);
+        req.reset();
+        CHECK(req.accept_encoding == silkrpc::http::ContentEncoding::kIdentity);
+    }
+
+    SECTION("header names in lowercase") {
+        const std::string s{"POST / HTTP/1.1\r\naccept-encoding: gzip\r\ncontent-length: 2\r\n\r\n{}"};
+        silkrpc::http::RequestParser parser;
+        silkrpc::http::Request req;
+        const auto [result, _]{parser.parse(req, s.data(), s.data() + s.size())};
+        CHECK(result == RequestParser::good);
+        CHECK(req.accept_encoding == silkrpc::http::ContentEncoding::kGzip);
+        CHECK(req.content == "{}");
+    }
+}
+
+TEST_CASE("parse pipelined requests", "[silkrpc][http][request_parser]") {
+    const std::string first{"POST / HTTP/1.1\r\nContent-Length: 15\r\n\r\n{\"json\": \"2.0\"}"};
+    const std::string second{"POST / HTTP/1.1\r\nContent-Length: 0\r\n\r\n"};
+
+    SECTION("two complete requests") {
+        const std::string s{first + second};
+        silkrpc::http::RequestParser parser;
+        silkrpc::http::Request req;
+        const auto [result1, consumed1]{parser.parse(req, s.data(), s.data() + s.size())};
+        CHECK(result1 == RequestParser::good);
+        CHECK(consumed1 == s.data() + first.size());
+        CHECK(req.content == "{\"json\": \"2.0\"}");
+        req.reset();
+        parser.reset();
+        const auto [result2, consumed2]{parser.parse(req, consumed1, s.data() + s.size())};
+        CHECK(result2 == RequestParser::good);
+        CHECK(consumed2 == s.data() + s.size());
+        CHECK(req.content.empty());
+    }
+
+    SECTION("complete request followed by incomplete one") {
+        const std::string s{first + second.substr(0, 10)};
+        silkrpc::http::RequestParser parser;
+        silkrpc::http::Request req;
+        const auto [result1, consumed1]{parser.parse(req, s.data(), s.data() + s.size())};
+        CHECK(result1 == RequestParser::good);
+        CHECK(consumed1 == s.data() + first.size());
+        req.reset();
+        parser.reset();
+        const auto [result2, consumed2]{parser.parse(req, consumed1, s.data() + s.size())};
+        CHECK(result2 == RequestParser::indeterminate);
+        CHECK(consumed2 == s.data() + s.size());
+    }
 }
 
 TEST_CASE("reset", "[silkrpc][http][request_parser]") {
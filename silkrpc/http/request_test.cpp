@@ -49,4 +49,24 @@ TEST_CASE("check reset method", "[silkrpc][http][request]") {
     CHECK(req.content_length == 0);
 }
 
+TEST_CASE("check reset releases large content", "[silkrpc][http][request]") {
+    Request req{"POST", "/", 1, 1, {}, 0, ""};
+
+    SECTION("small content is retained") {
+        req.content.reserve(kRequestContentInitialCapacity);
+        req.content.assign(kRequestContentInitialCapacity, 'a');
+        const auto capacity = req.content.capacity();
+        req.reset();
+        CHECK(req.content.empty());
+        CHECK(req.content.capacity() == capacity);
+    }
+
+    SECTION("large content is released") {
+        req.content.assign(2 * kRequestContentMaxRetainedCapacity, 'a');
+        req.reset();
+        CHECK(req.content.empty());
+        CHECK(req.content.capacity() <= kRequestContentMaxRetainedCapacity);
+    }
+}
+
 } // namespace silkrpc::http
@@ -23,7 +23,9 @@
 #include "server.hpp"
 
 #include <cstring>
+#include <filesystem>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -33,8 +35,10 @@
 
 #include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
+#include <silkrpc/common/metrics.hpp>
 #include <silkrpc/common/util.hpp>
 #include <silkrpc/http/connection.hpp>
+#include <silkrpc/http/ipc_connection.hpp>
 #include <silkrpc/http/methods.hpp>
 
 namespace silkrpc::http {
@@ -45,50 +49,139 @@ std::tuple<std::string, std::string> Server::parse_endpoint(const std::string& t
     return {host, port};
 }
 
-Server::Server(const std::string& end_point, const std::string& api_spec, ContextPool& context_pool, asio::thread_pool& workers)
-: context_pool_(context_pool), workers_(workers), acceptor_{context_pool.get_io_context()}, handler_table_{api_spec} {
+Server::Server(const std::string& end_point, const std::string& api_spec, ContextPool& context_pool, commands::WorkerPools& workers,
+    bool reuse_port, const std::string& concurrency_limits, const std::string& ipc_path, const ConnectionLimits& connection_limits)
+: context_pool_(context_pool), workers_(workers), reuse_port_(reuse_port), connection_limits_(connection_limits), ipc_path_(ipc_path),
+  handler_table_{api_spec}, admission_control_{concurrency_limits} {
+    for (std::size_t i{0}; i < context_pool.num_contexts(); ++i) {
+        auto& context = context_pool.get_context(i);
+        rpc_apis_.emplace(&context, std::make_unique<commands::RpcApi>(context, workers));
+    }
+
     const auto [host, port] = parse_endpoint(end_point);
 
-    // Open the acceptor with the option to reuse the address (i.e. SO_REUSEADDR).
-    asio::ip::tcp::resolver resolver{acceptor_.get_executor()};
+    const auto num_acceptors = reuse_port ? context_pool.num_contexts() : 1;
+    acceptors_.reserve(num_acceptors);
+    for (std::size_t i{0}; i < num_acceptors; ++i) {
+        auto& io_context = reuse_port ? *context_pool.get_context(i).io_context : context_pool.get_io_context();
+        acceptors_.emplace_back(io_context);
+    }
+
+    asio::ip::tcp::resolver resolver{acceptors_[0].get_executor()};
     asio::ip::tcp::endpoint endpoint = *resolver.resolve(host, port).begin();
-    acceptor_.open(endpoint.protocol());
-    acceptor_.set_option(asio::ip::tcp::acceptor::reuse_address(true));
-    acceptor_.bind(endpoint);
+    for (auto& acceptor : acceptors_) {
+        open_acceptor(acceptor, endpoint, reuse_port);
+    }
+
+    if (!ipc_path.empty()) {
+        ipc_acceptor_.emplace(context_pool.get_io_context());
+        open_ipc_acceptor(*ipc_acceptor_, ipc_path);
+    }
+
+    metrics_collector_id_ = Metrics::add_collector([this, end_point](std::vector<MetricSample>& samples) {
+        collect_metrics("endpoint=\"" + end_point + "\"", samples);
+    });
 }
 
-void Server::start() {
-    asio::co_spawn(acceptor_.get_executor(), run(), [&](std::exception_ptr eptr) {
-        if (eptr) std::rethrow_exception(eptr);
+Server::~Server() {
+    Metrics::remove_collector(metrics_collector_id_);
+}
+
+void Server::collect_metrics(const std::string& endpoint_label, std::vector<MetricSample>& samples) const {
+    samples.push_back({"silkrpc_open_connections", "gauge", "Number of open TCP and IPC connections", endpoint_label, static_cast<double>(num_connections_)});
+    admission_control_.for_each_limiter([&](const std::string& name, const commands::ConcurrencyLimiter& limiter) {
+        const auto labels = endpoint_label + ",limit=\"" + name + "\"";
+        samples.push_back({"silkrpc_admission_running", "gauge", "Number of requests running within the concurrency limit", labels,
+                           static_cast<double>(limiter.running())});
+        samples.push_back({"silkrpc_admission_queued", "gauge", "Number of requests queued by the concurrency limit", labels,
+                           static_cast<double>(limiter.queued())});
+        samples.push_back({"silkrpc_admission_rejected_total", "counter", "Number of requests rejected by the concurrency limit", labels,
+                           static_cast<double>(limiter.rejected())});
     });
 }
 
-asio::awaitable<void> Server::run() {
-    acceptor_.listen();
+void Server::open_acceptor(asio::ip::tcp::acceptor& acceptor, const asio::ip::tcp::endpoint& endpoint, bool reuse_port) {
+    // Open the acceptor with the option to reuse the address (i.e. SO_REUSEADDR).
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(asio::ip::tcp::acceptor::reuse_address(true));
+    if (reuse_port) {
+#ifdef SO_REUSEPORT
+        // Let all the acceptors bind to the same end-point (i.e. SO_REUSEPORT).
+        acceptor.set_option(asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+#else
+        throw std::runtime_error{"Server::open_acceptor SO_REUSEPORT not supported on this platform"};
+#endif
+    }
+    acceptor.bind(endpoint);
+}
+
+void Server::open_ipc_acceptor(asio::local::stream_protocol::acceptor& acceptor, const std::string& ipc_path) {
+    // A socket file left behind by a previous run would make bind fail, anything else is not ours to remove
+    if (std::filesystem::is_socket(ipc_path)) {
+        std::filesystem::remove(ipc_path);
+    }
+    acceptor.open();
+    acceptor.bind(asio::local::stream_protocol::endpoint{ipc_path});
+}
 
-    try {
-        while (acceptor_.is_open()) {
-            // Get the next context to use chosen round-robin, then get both io_context *and* database from it
-            auto& context = context_pool_.get_context();
-            auto& io_context = context.io_context;
+void Server::start() {
+    for (std::size_t i{0}; i < acceptors_.size(); ++i) {
+        asio::co_spawn(acceptors_[i].get_executor(), run(i), [&](std::exception_ptr eptr) {
+            if (eptr) std::rethrow_exception(eptr);
+        });
+    }
+    if (ipc_acceptor_) {
+        asio::co_spawn(ipc_acceptor_->get_executor(), run_ipc(), [&](std::exception_ptr eptr) {
+            if (eptr) std::rethrow_exception(eptr);
+        });
+    }
+}
 
-            SILKRPC_DEBUG << "Server::start accepting using io_context " << io_context << "...\n" << std::flush;
+asio::awaitable<void> Server::run(std::size_t acceptor_index) {
+    auto& acceptor = acceptors_[acceptor_index];
+    acceptor.listen();
 
-            auto new_connection = std::make_shared<Connection>(context, workers_, handler_table_);
-            co_await acceptor_.async_accept(new_connection->socket(), asio::use_awaitable);
-            if (!acceptor_.is_open()) {
+    try {
+        while (acceptor.is_open()) {
+            SILKRPC_DEBUG << "Server::start accepting using acceptor " << acceptor_index << "...\n" << std::flush;
+
+            // Accept before choosing the context, so that the choice reflects the load when the connection arrives
+            asio::ip::tcp::socket socket{acceptor.get_executor()};
+            co_await acceptor.async_accept(socket, asio::use_awaitable);
+            if (!acceptor.is_open()) {
                 SILKRPC_TRACE << "Server::start returning...\n";
                 co_return;
             }
 
+            // Accepting and closing immediately keeps the backlog from filling up with connections that would never be served
+            if (!try_open_connection()) {
+                continue;
+            }
+
+            // Get the context owning the acceptor or the one chosen by the pool, then get both io_context *and* database from it
+            auto& context = reuse_port_ ? context_pool_.get_context(acceptor_index) : context_pool_.get_context();
+            auto& io_context = context.io_context;
+            auto& load = *context.load;
+            ++load.connections;
+
+            auto new_connection = std::make_shared<Connection>(context, rpc_api(context), workers_, handler_table_, admission_control_, connection_limits_);
+            if (socket.get_executor() == new_connection->socket().get_executor()) {
+                new_connection->socket() = std::move(socket);
+            } else {
+                const auto protocol = socket.local_endpoint().protocol();
+                new_connection->socket().assign(protocol, socket.release());
+            }
             new_connection->socket().set_option(asio::ip::tcp::socket::keep_alive(true));
 
             SILKRPC_TRACE << "Server::start starting connection for socket: " << &new_connection->socket() << "\n";
             auto new_connection_starter = [=]() -> asio::awaitable<void> { co_await new_connection->start(); };
 
             // https://github.com/chriskohlhoff/asio/issues/552
-            asio::dispatch(*io_context, [=]() mutable {
-                asio::co_spawn(*io_context, new_connection_starter, [&](std::exception_ptr eptr) {
+            // When the acceptor belongs to the connection context, dispatch runs inline without any handoff
+            asio::dispatch(*io_context, [=, &load, this]() mutable {
+                asio::co_spawn(*io_context, new_connection_starter, [&load, this](std::exception_ptr eptr) {
+                    --load.connections;
+                    --num_connections_;
                     if (eptr) std::rethrow_exception(eptr);
                 });
             });
@@ -104,10 +197,77 @@ asio::awaitable<void> Server::run() {
     SILKRPC_DEBUG << "Server::start exiting...\n" << std::flush;
 }
 
+asio::awaitable<void> Server::run_ipc() {
+    ipc_acceptor_->listen();
+
+    try {
+        while (ipc_acceptor_->is_open()) {
+            asio::local::stream_protocol::socket socket{ipc_acceptor_->get_executor()};
+            co_await ipc_acceptor_->async_accept(socket, asio::use_awaitable);
+            if (!ipc_acceptor_->is_open()) {
+                SILKRPC_TRACE << "Server::run_ipc returning...\n";
+                co_return;
+            }
+
+            if (!try_open_connection()) {
+                continue;
+            }
+
+            auto& context = context_pool_.get_context();
+            auto& io_context = context.io_context;
+            auto& load = *context.load;
+            ++load.connections;
+
+            auto new_connection = std::make_shared<IpcConnection>(context, rpc_api(context), workers_, handler_table_, admission_control_,
+                connection_limits_);
+            if (socket.get_executor() == new_connection->socket().get_executor()) {
+                new_connection->socket() = std::move(socket);
+            } else {
+                new_connection->socket().assign(asio::local::stream_protocol{}, socket.release());
+            }
+
+            SILKRPC_TRACE << "Server::run_ipc starting connection for socket: " << &new_connection->socket() << "\n";
+            asio::dispatch(*io_context, [=, &load, this]() mutable {
+                asio::co_spawn(*io_context, [=]() -> asio::awaitable<void> { co_await new_connection->start(); }, [&load, this](std::exception_ptr eptr) {
+                    --load.connections;
+                    --num_connections_;
+                    if (eptr) std::rethrow_exception(eptr);
+                });
+            });
+        }
+    } catch (const std::system_error& se) {
+        if (se.code() != asio::error::operation_aborted) {
+            SILKRPC_ERROR << "Server::run_ipc system_error: " << se.what() << "\n" << std::flush;
+            throw;
+        }
+        SILKRPC_DEBUG << "Server::run_ipc operation_aborted: " << se.what() << "\n" << std::flush;
+    }
+    SILKRPC_DEBUG << "Server::run_ipc exiting...\n" << std::flush;
+}
+
+bool Server::try_open_connection() {
+    // The slot is taken before checking, because the acceptors of other contexts may be doing the same with --reusePort
+    const auto max_connections = connection_limits_.max_connections;
+    const auto open_connections = num_connections_.fetch_add(1);
+    if (max_connections > 0 && open_connections >= max_connections) {
+        --num_connections_;
+        SILKRPC_WARN << "Server::try_open_connection too many connections: " << open_connections << ", closing new one\n" << std::flush;
+        return false;
+    }
+    return true;
+}
+
 void Server::stop() {
     // The server is stopped by cancelling all outstanding asynchronous operations.
     SILKRPC_DEBUG << "Server::stop started...\n";
-    acceptor_.close();
+    for (auto& acceptor : acceptors_) {
+        acceptor.close();
+    }
+    if (ipc_acceptor_) {
+        ipc_acceptor_->close();
+        std::error_code ec;
+        std::filesystem::remove(ipc_path_, ec);
+    }
     SILKRPC_DEBUG << "Server::stop completed\n" << std::flush;
 }
 
@@ -23,6 +23,11 @@
 #ifndef SILKRPC_HTTP_SERVER_HPP_
 #define SILKRPC_HTTP_SERVER_HPP_
 
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -31,12 +36,17 @@
 
 #include <asio/awaitable.hpp>
 #include <asio/ip/tcp.hpp>
-#include <asio/thread_pool.hpp>
+#include <asio/local/stream_protocol.hpp>
 
 #include <silkrpc/context_pool.hpp>
+#include <silkrpc/common/metrics.hpp>
+#include <silkrpc/http/connection.hpp>
 #include <silkrpc/http/request_handler.hpp>
 
+#include <silkrpc/commands/admission_control.hpp>
+#include <silkrpc/commands/rpc_api.hpp>
 #include <silkrpc/commands/rpc_api_table.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
 
 namespace silkrpc::http {
 
@@ -46,28 +56,80 @@ public:
     Server(const Server&) = delete;
     Server& operator=(const Server&) = delete;
 
-    // Construct the server to listen on the specified local TCP end-point
-    explicit Server(const std::string& end_point, const std::string& api_spec, ContextPool& context_pool, asio::thread_pool& workers);
+    // Construct the server to listen on the specified local TCP end-point. If reuse_port is true, each context gets
+    // its own acceptor bound to the same end-point using SO_REUSEPORT, so that the kernel balances incoming connections
+    // across the contexts and each connection is served by the context accepting it. If ipc_path is not empty, the server
+    // also listens for local connections on the Unix domain socket at such path. The connection limits apply to both
+    explicit Server(const std::string& end_point, const std::string& api_spec, ContextPool& context_pool, commands::WorkerPools& workers,
+        bool reuse_port, const std::string& concurrency_limits, const std::string& ipc_path, const ConnectionLimits& connection_limits);
+
+    ~Server();
+
+    // The admission control applying the concurrency limits
+    const commands::AdmissionControl& admission_control() const { return admission_control_; }
+
+    // The number of TCP and IPC connections currently open
+    std::size_t num_connections() const { return num_connections_; }
 
     void start();
 
     void stop();
 
+    // Open the acceptor bound to the Unix domain socket at the given path, replacing the socket file left behind by a previous run
+    static void open_ipc_acceptor(asio::local::stream_protocol::acceptor& acceptor, const std::string& ipc_path);
+
 private:
     static std::tuple<std::string, std::string> parse_endpoint(const std::string& tcp_end_point);
 
-    asio::awaitable<void> run();
+    void open_acceptor(asio::ip::tcp::acceptor& acceptor, const asio::ip::tcp::endpoint& endpoint, bool reuse_port);
+
+    asio::awaitable<void> run(std::size_t acceptor_index);
+
+    asio::awaitable<void> run_ipc();
+
+    // Take a slot for a new connection, unless the maximum number of connections is already open
+    bool try_open_connection();
+
+    // Add the samples of open connections and admission control queues, labelled by end-point
+    void collect_metrics(const std::string& endpoint_label, std::vector<MetricSample>& samples) const;
+
+    // The API handlers shared by all the connections served by the given context
+    commands::RpcApi& rpc_api(const Context& context) { return *rpc_apis_.at(&context); }
 
     // The repository of API request handlers
     commands::RpcApiTable handler_table_;
 
+    // The concurrency limits applied before dispatching requests to their handlers
+    commands::AdmissionControl admission_control_;
+
     // The context pool used to perform asynchronous operations
     ContextPool& context_pool_;
 
-    // The acceptor used to listen for incoming TCP connections
-    asio::ip::tcp::acceptor acceptor_;
+    // The stateless API handlers, one instance per context (read-only after construction, so lookups are thread-safe)
+    std::map<const Context*, std::unique_ptr<commands::RpcApi>> rpc_apis_;
+
+    // The acceptors used to listen for incoming TCP connections, either one per context or just one for all contexts
+    std::vector<asio::ip::tcp::acceptor> acceptors_;
+
+    // Flag indicating if each context has its own acceptor
+    bool reuse_port_;
+
+    // The limits applied to each TCP or IPC connection
+    ConnectionLimits connection_limits_;
+
+    // The number of TCP and IPC connections currently open, shared by the acceptors running on different contexts
+    std::atomic<std::size_t> num_connections_{0};
+
+    // The acceptor used to listen for incoming local connections, if any
+    std::optional<asio::local::stream_protocol::acceptor> ipc_acceptor_;
+
+    // The path of the Unix domain socket used by the IPC acceptor
+    std::string ipc_path_;
+
+    commands::WorkerPools& workers_;
 
-    asio::thread_pool& workers_;
+    // The identifier of the metrics collector registered by this server
+    std::size_t metrics_collector_id_;
 };
 
 } // namespace silkrpc::http
@@ -16,6 +16,12 @@
 
 #include "server.hpp"
 
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#include <asio/io_context.hpp>
+#include <asio/local/stream_protocol.hpp>
 #include <catch2/catch.hpp>
 #include <grpcpp/grpcpp.h>
 
@@ -40,4 +46,40 @@ TEST_CASE("server creation", "[silkrpc][http][server]") {
     }
 }
 
+TEST_CASE("server IPC acceptor", "[silkrpc][http][server]") {
+    asio::io_context io_context;
+    const auto ipc_path = (std::filesystem::temp_directory_path() / "silkrpc_server_test.ipc").string();
+    std::filesystem::remove(ipc_path);
+
+    SECTION("new socket file") {
+        asio::local::stream_protocol::acceptor acceptor{io_context};
+        CHECK_NOTHROW(Server::open_ipc_acceptor(acceptor, ipc_path));
+        CHECK(std::filesystem::is_socket(ipc_path));
+    }
+
+    SECTION("stale socket file removed") {
+        {
+            // Closing the acceptor does not remove its socket file, as if the previous run crashed
+            asio::local::stream_protocol::acceptor previous_acceptor{io_context};
+            Server::open_ipc_acceptor(previous_acceptor, ipc_path);
+        }
+        REQUIRE(std::filesystem::is_socket(ipc_path));
+
+        asio::local::stream_protocol::acceptor acceptor{io_context};
+        CHECK_NOTHROW(Server::open_ipc_acceptor(acceptor, ipc_path));
+        acceptor.listen();
+        asio::local::stream_protocol::socket client{io_context};
+        CHECK_NOTHROW(client.connect(asio::local::stream_protocol::endpoint{ipc_path}));
+    }
+
+    SECTION("other file kept") {
+        std::ofstream{ipc_path} << "not a socket";
+        asio::local::stream_protocol::acceptor acceptor{io_context};
+        CHECK_THROWS_AS(Server::open_ipc_acceptor(acceptor, ipc_path), std::system_error);
+        CHECK(std::filesystem::is_regular_file(ipc_path));
+    }
+
+    std::filesystem::remove(ipc_path);
+}
+
 } // namespace silkrpc::http
@@ -0,0 +1,249 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "websocket.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <stdexcept>
+#include <string_view>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/util.hpp>
+
+namespace silkrpc::http::websocket {
+
+namespace {
+
+// The GUID concatenated to the client key to compute the accept key (RFC 6455, section 1.3)
+constexpr const char* kAcceptKeyGuid{"258EAFA5-E914-47DA-95CA-C5AB0DC85B11"};
+
+constexpr const char* kSupportedVersion{"13"};
+
+// SHA-1 is only needed by the opening handshake (RFC 3174)
+std::array<uint8_t, 20> sha1(std::string_view message) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    std::string padded{message};
+    padded.push_back(static_cast<char>(0x80));
+    while (padded.size() % 64 != 56) {
+        padded.push_back(0);
+    }
+    const uint64_t bit_length = static_cast<uint64_t>(message.size()) * 8;
+    for (int i{7}; i >= 0; --i) {
+        padded.push_back(static_cast<char>((bit_length >> (i * 8)) & 0xFF));
+    }
+
+    const auto rotl = [](uint32_t x, int n) { return (x << n) | (x >> (32 - n)); };
+    for (std::size_t chunk{0}; chunk < padded.size(); chunk += 64) {
+        uint32_t w[80];
+        for (int i{0}; i < 16; ++i) {
+            const auto p = reinterpret_cast<const uint8_t*>(padded.data() + chunk + i * 4);
+            w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+        }
+        for (int i{16}; i < 80; ++i) {
+            w[i] = rotl(w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i{0}; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            const uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    std::array<uint8_t, 20> digest{};
+    for (int i{0}; i < 5; ++i) {
+        digest[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+    }
+    return digest;
+}
+
+// Check if the comma-separated header value contains the given token (case insensitive)
+bool contains_token(std::string_view value, std::string_view token) {
+    while (!value.empty()) {
+        const auto comma = value.find(',');
+        auto item = value.substr(0, comma);
+        while (!item.empty() && std::isspace(static_cast<unsigned char>(item.front()))) {
+            item.remove_prefix(1);
+        }
+        while (!item.empty() && std::isspace(static_cast<unsigned char>(item.back()))) {
+            item.remove_suffix(1);
+        }
+        if (iequals(item, token)) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        value.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+const Header* find_header(const Request& request, std::string_view name) {
+    const auto it = std::find_if(request.headers.begin(), request.headers.end(), [&](const Header& h) { return iequals(h.name, name); });
+    return it != request.headers.end() ? &*it : nullptr;
+}
+
+} // namespace
+
+bool is_upgrade_request(const Request& request) {
+    if (request.method != "GET") {
+        return false;
+    }
+    const auto upgrade = find_header(request, "Upgrade");
+    const auto connection = find_header(request, "Connection");
+    return upgrade && connection && contains_token(upgrade->value, "websocket") && contains_token(connection->value, "upgrade");
+}
+
+std::string make_accept_key(const std::string& client_key) {
+    const auto digest = sha1(client_key + kAcceptKeyGuid);
+    return base64_encode(digest.data(), digest.size(), /*url=*/false);
+}
+
+Reply make_upgrade_reply(const Request& request) {
+    const auto key = find_header(request, "Sec-WebSocket-Key");
+    const auto version = find_header(request, "Sec-WebSocket-Version");
+    if (!key || key->value.empty() || !version || version->value != kSupportedVersion) {
+        auto reply = Reply::stock_reply(Reply::bad_request);
+        reply.headers.emplace_back(Header{"Sec-WebSocket-Version", kSupportedVersion});
+        return reply;
+    }
+
+    Reply reply;
+    reply.status = Reply::switching_protocols;
+    reply.headers.reserve(3);
+    reply.headers.emplace_back(Header{"Upgrade", "websocket"});
+    reply.headers.emplace_back(Header{"Connection", "Upgrade"});
+    reply.headers.emplace_back(Header{"Sec-WebSocket-Accept", make_accept_key(key->value)});
+    return reply;
+}
+
+std::size_t decode_frame(const char* begin, const char* end, Frame& frame) {
+    const auto data = reinterpret_cast<const uint8_t*>(begin);
+    const auto size = static_cast<std::size_t>(end - begin);
+    if (size < 2) {
+        return 0;
+    }
+
+    if ((data[0] & 0x70) != 0) {
+        throw std::runtime_error{"websocket: reserved bits set"};
+    }
+    const auto opcode = static_cast<Opcode>(data[0] & 0x0F);
+    switch (opcode) {
+        case Opcode::kContinuation:
+        case Opcode::kText:
+        case Opcode::kBinary:
+        case Opcode::kClose:
+        case Opcode::kPing:
+        case Opcode::kPong:
+            break;
+        default:
+            throw std::runtime_error{"websocket: unknown opcode"};
+    }
+    const bool fin = (data[0] & 0x80) != 0;
+    if ((data[1] & 0x80) == 0) {
+        throw std::runtime_error{"websocket: unmasked client frame"};
+    }
+
+    std::size_t header_size{2};
+    uint64_t payload_length = data[1] & 0x7F;
+    if (payload_length == 126) {
+        header_size += 2;
+        if (size < header_size) {
+            return 0;
+        }
+        payload_length = (uint64_t(data[2]) << 8) | uint64_t(data[3]);
+    } else if (payload_length == 127) {
+        header_size += 8;
+        if (size < header_size) {
+            return 0;
+        }
+        payload_length = 0;
+        for (std::size_t i{2}; i < 10; ++i) {
+            payload_length = (payload_length << 8) | uint64_t(data[i]);
+        }
+    }
+    if (static_cast<uint8_t>(opcode) >= static_cast<uint8_t>(Opcode::kClose) && (!fin || payload_length > 125)) {
+        throw std::runtime_error{"websocket: invalid control frame"};
+    }
+    if (payload_length > kMaxWebSocketMessageSize) {
+        throw std::runtime_error{"websocket: frame too big"};
+    }
+
+    const auto mask = data + header_size;
+    header_size += 4;
+    if (size < header_size + payload_length) {
+        return 0;
+    }
+
+    frame.fin = fin;
+    frame.opcode = opcode;
+    frame.payload.resize(payload_length);
+    const auto payload = data + header_size;
+    for (std::size_t i{0}; i < payload_length; ++i) {
+        frame.payload[i] = static_cast<char>(payload[i] ^ mask[i % 4]);
+    }
+    return header_size + payload_length;
+}
+
+std::string encode_frame_header(Opcode opcode, std::size_t payload_length) {
+    std::string header;
+    header.reserve(10);
+    header.push_back(static_cast<char>(0x80 | static_cast<uint8_t>(opcode)));
+    if (payload_length < 126) {
+        header.push_back(static_cast<char>(payload_length));
+    } else if (payload_length <= 0xFFFF) {
+        header.push_back(static_cast<char>(126));
+        header.push_back(static_cast<char>((payload_length >> 8) & 0xFF));
+        header.push_back(static_cast<char>(payload_length & 0xFF));
+    } else {
+        header.push_back(static_cast<char>(127));
+        for (int i{7}; i >= 0; --i) {
+            header.push_back(static_cast<char>((uint64_t(payload_length) >> (i * 8)) & 0xFF));
+        }
+    }
+    return header;
+}
+
+} // namespace silkrpc::http::websocket
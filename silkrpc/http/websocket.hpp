@@ -0,0 +1,64 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_WEBSOCKET_HPP_
+#define SILKRPC_HTTP_WEBSOCKET_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <silkrpc/http/reply.hpp>
+#include <silkrpc/http/request.hpp>
+
+// WebSocket protocol support as defined in RFC 6455 (https://datatracker.ietf.org/doc/html/rfc6455)
+namespace silkrpc::http::websocket {
+
+enum class Opcode : uint8_t {
+    kContinuation = 0x0,
+    kText = 0x1,
+    kBinary = 0x2,
+    kClose = 0x8,
+    kPing = 0x9,
+    kPong = 0xA
+};
+
+/// A single (possibly fragmented) WebSocket frame received from a client.
+struct Frame {
+    bool fin{true};
+    Opcode opcode{Opcode::kText};
+    std::string payload;
+};
+
+/// Check if the request is a valid HTTP/1.1 upgrade request to the WebSocket protocol.
+bool is_upgrade_request(const Request& request);
+
+/// Compute the Sec-WebSocket-Accept value for the Sec-WebSocket-Key sent by the client.
+std::string make_accept_key(const std::string& client_key);
+
+/// Build the 101 Switching Protocols reply accepting the upgrade request.
+Reply make_upgrade_reply(const Request& request);
+
+/// Decode the frame at the beginning of the input, unmasking its payload. Return the number of consumed bytes,
+/// zero if the input does not contain a complete frame yet. Throw std::runtime_error on protocol violations.
+std::size_t decode_frame(const char* begin, const char* end, Frame& frame);
+
+/// Encode the header of a final, unmasked server frame carrying payload_length bytes.
+std::string encode_frame_header(Opcode opcode, std::size_t payload_length);
+
+} // namespace silkrpc::http::websocket
+
+#endif // SILKRPC_HTTP_WEBSOCKET_HPP_
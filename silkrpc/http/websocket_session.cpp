@@ -0,0 +1,291 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "websocket_session.hpp"
+
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include <asio/buffer.hpp>
+#include <asio/co_spawn.hpp>
+#include <asio/use_awaitable.hpp>
+#include <asio/write.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/json/stream.hpp>
+#include <silkrpc/json/types.hpp>
+#include <silkrpc/types/filter.hpp>
+
+namespace silkrpc::http {
+
+// Close status codes (RFC 6455, section 7.4.1)
+constexpr const uint16_t kNormalClosure{1000};
+constexpr const uint16_t kProtocolError{1002};
+constexpr const uint16_t kMessageTooBig{1009};
+
+WebSocketSession::WebSocketSession(asio::ip::tcp::socket& socket, RequestHandler& request_handler, subscriptions::SubscriptionManager& subscription_manager,
+    TimerWheel& timer_wheel, const ConnectionLimits& limits)
+: socket_(socket), request_handler_(request_handler), subscription_manager_(subscription_manager), pending_write_{socket.get_executor()},
+  timeouts_{socket, timer_wheel, limits} {
+    SILKRPC_DEBUG << "WebSocketSession::WebSocketSession socket " << &socket_ << " upgraded\n";
+}
+
+WebSocketSession::~WebSocketSession() {
+    // Subscription handlers refer to this session, so they must not outlive it
+    unsubscribe_all();
+    SILKRPC_DEBUG << "WebSocketSession::~WebSocketSession socket " << &socket_ << " closed\n";
+}
+
+asio::awaitable<void> WebSocketSession::run(std::string_view initial_data) {
+    std::exception_ptr read_error;
+    try {
+        co_await do_read(initial_data);
+    } catch (...) {
+        read_error = std::current_exception();
+    }
+
+    unsubscribe_all();
+    if (read_error) {
+        // The client is gone, so abort any write in progress
+        asio::error_code ec;
+        socket_.cancel(ec);
+    }
+    co_await pending_write_.wait();
+
+    if (read_error) {
+        std::rethrow_exception(read_error);
+    }
+}
+
+asio::awaitable<void> WebSocketSession::do_read(std::string_view initial_data) {
+    incoming_.assign(initial_data);
+    websocket::Frame frame;
+    while (!closing_) {
+        // Process all the complete frames available, the last one can be incomplete
+        std::size_t offset{0};
+        while (!closing_) {
+            std::size_t consumed{0};
+            try {
+                consumed = websocket::decode_frame(incoming_.data() + offset, incoming_.data() + incoming_.size(), frame);
+            } catch (const std::runtime_error& e) {
+                SILKRPC_DEBUG << "WebSocketSession::do_read invalid frame: " << e.what() << "\n";
+                close(kProtocolError);
+                break;
+            }
+            if (consumed == 0) {
+                break;
+            }
+            offset += consumed;
+            co_await handle_frame(frame);
+        }
+        incoming_.erase(0, offset);
+        if (closing_) {
+            break;
+        }
+
+        // Waiting for the rest of a message is bounded by the read timeout, waiting for a new message by the idle one unless
+        // the client is waiting for notifications
+        if (!incoming_.empty() || fragmented_) {
+            timeouts_.start_read(/*partial_request=*/true);
+        } else if (subscriptions_.empty()) {
+            timeouts_.start_read(/*partial_request=*/false);
+        }
+        const auto bytes_read = co_await socket_.async_read_some(asio::buffer(buffer_), asio::use_awaitable);
+        timeouts_.stop_read();
+        SILKRPC_TRACE << "WebSocketSession::do_read bytes_read: " << bytes_read << "\n";
+        incoming_.append(buffer_.data(), bytes_read);
+    }
+}
+
+asio::awaitable<void> WebSocketSession::handle_frame(websocket::Frame& frame) {
+    switch (frame.opcode) {
+        case websocket::Opcode::kText:
+        case websocket::Opcode::kBinary:
+            if (fragmented_) {
+                close(kProtocolError);
+            } else if (frame.fin) {
+                co_await handle_message(frame.payload);
+            } else {
+                message_ = std::move(frame.payload);
+                fragmented_ = true;
+            }
+            break;
+        case websocket::Opcode::kContinuation:
+            if (!fragmented_) {
+                close(kProtocolError);
+            } else if (message_.size() + frame.payload.size() > kMaxWebSocketMessageSize) {
+                close(kMessageTooBig);
+            } else {
+                message_ += frame.payload;
+                if (frame.fin) {
+                    fragmented_ = false;
+                    const auto message{std::move(message_)};
+                    message_.clear();
+                    co_await handle_message(message);
+                }
+            }
+            break;
+        case websocket::Opcode::kPing: {
+            ChainedBuffer payload;
+            payload.append(frame.payload);
+            send(websocket::Opcode::kPong, std::move(payload));
+            break;
+        }
+        case websocket::Opcode::kPong:
+            break;
+        case websocket::Opcode::kClose:
+            close(kNormalClosure);
+            break;
+    }
+}
+
+asio::awaitable<void> WebSocketSession::handle_message(const std::string& message) {
+    SILKRPC_DEBUG << "WebSocketSession::handle_message message: " << message << "\n";
+
+    ChainedBuffer reply_content;
+    try {
+        const auto request_json = nlohmann::json::parse(message);
+
+        const auto is_call = request_json.is_object() && request_json.contains("method") && request_json["method"].is_string();
+        const auto method = is_call ? request_json["method"].get<std::string>() : std::string{};
+        if (method == "eth_subscribe") {
+            JsonStream{reply_content}.write_json(handle_subscribe(request_json));
+        } else if (method == "eth_unsubscribe") {
+            JsonStream{reply_content}.write_json(handle_unsubscribe(request_json));
+        } else {
+            co_await request_handler_.handle_request(request_json, reply_content);
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "WebSocketSession::handle_message exception: " << e.what() << "\n";
+        reply_content.clear();
+        JsonStream{reply_content}.write_json(make_json_error(0, 100, e.what()));
+    }
+
+    // Notifications get no reply
+    if (!reply_content.empty()) {
+        send(websocket::Opcode::kText, std::move(reply_content));
+    }
+}
+
+nlohmann::json WebSocketSession::handle_subscribe(const nlohmann::json& request_json) {
+    const auto request_id = request_json.contains("id") ? request_json["id"].get<uint32_t>() : 0;
+    if (!request_json.contains("params") || !request_json["params"].is_array() || request_json["params"].empty()
+        || !request_json["params"][0].is_string()) {
+        return make_json_error(request_id, -32602, "invalid eth_subscribe params");
+    }
+    const auto& params = request_json["params"];
+    const auto type = params[0].get<std::string>();
+
+    auto handler = [this](const nlohmann::json& notification) {
+        ChainedBuffer payload;
+        JsonStream{payload}.write_json(notification);
+        send(websocket::Opcode::kText, std::move(payload));
+    };
+    subscriptions::SubscriptionId subscription_id{0};
+    if (type == "newHeads") {
+        subscription_id = subscription_manager_.subscribe_new_heads(handler);
+    } else if (type == "logs") {
+        const auto filter = params.size() > 1 ? params[1].get<Filter>() : Filter{};
+        subscription_id = subscription_manager_.subscribe_logs(filter, handler);
+    } else if (type == "newPendingTransactions") {
+        subscription_id = subscription_manager_.subscribe_new_pending_transactions(handler);
+    } else {
+        return make_json_error(request_id, -32602, "unsupported subscription type: " + type);
+    }
+    subscriptions_.insert(subscription_id);
+
+    return make_json_content(request_id, subscriptions::to_subscription_id(subscription_id));
+}
+
+nlohmann::json WebSocketSession::handle_unsubscribe(const nlohmann::json& request_json) {
+    const auto request_id = request_json.contains("id") ? request_json["id"].get<uint32_t>() : 0;
+    if (!request_json.contains("params") || !request_json["params"].is_array() || request_json["params"].size() != 1
+        || !request_json["params"][0].is_string()) {
+        return make_json_error(request_id, -32602, "invalid eth_unsubscribe params");
+    }
+    const auto subscription_id = subscriptions::from_subscription_id(request_json["params"][0].get<std::string>());
+
+    // Clients can only cancel their own subscriptions
+    const bool unsubscribed = subscription_id && subscriptions_.erase(*subscription_id) > 0 && subscription_manager_.unsubscribe(*subscription_id);
+    return make_json_content(request_id, unsubscribed);
+}
+
+void WebSocketSession::send(websocket::Opcode opcode, ChainedBuffer&& payload) {
+    if (closing_) {
+        return;
+    }
+    if (outgoing_.size() >= kMaxWebSocketPendingMessages) {
+        // The client is not keeping up with its notifications, so drop it instead of buffering without limit
+        SILKRPC_WARN << "WebSocketSession::send socket " << &socket_ << " too many pending messages, closing\n";
+        closing_ = true;
+        unsubscribe_all();
+        asio::error_code ec;
+        socket_.cancel(ec);
+        return;
+    }
+
+    outgoing_.emplace_back(opcode, std::move(payload));
+    if (pending_write_.in_progress()) {
+        return;
+    }
+    pending_write_.start();
+    asio::co_spawn(socket_.get_executor(), do_write(), [this](std::exception_ptr eptr) {
+        if (eptr) {
+            // Messages cannot be delivered anymore, so stop producing them
+            closing_ = true;
+            outgoing_.clear();
+            asio::error_code ec;
+            socket_.cancel(ec);
+        }
+        pending_write_.complete();
+    });
+}
+
+void WebSocketSession::close(uint16_t status_code) {
+    ChainedBuffer payload;
+    payload.append(static_cast<char>(status_code >> 8));
+    payload.append(static_cast<char>(status_code & 0xFF));
+    send(websocket::Opcode::kClose, std::move(payload));
+    closing_ = true;
+}
+
+void WebSocketSession::unsubscribe_all() {
+    for (const auto subscription_id : subscriptions_) {
+        subscription_manager_.unsubscribe(subscription_id);
+    }
+    subscriptions_.clear();
+}
+
+asio::awaitable<void> WebSocketSession::do_write() {
+    while (!outgoing_.empty()) {
+        // References to deque elements stay valid while new messages are queued at the back
+        const auto& [opcode, payload] = outgoing_.front();
+        const auto header = websocket::encode_frame_header(opcode, payload.size());
+        std::vector<asio::const_buffer> buffers;
+        buffers.reserve(1 + payload.num_chunks());
+        buffers.push_back(asio::buffer(header));
+        payload.to_buffers(buffers);
+        timeouts_.start_write();
+        const auto bytes_transferred = co_await asio::async_write(socket_, buffers, asio::use_awaitable);
+        timeouts_.stop_write();
+        SILKRPC_TRACE << "WebSocketSession::do_write bytes_transferred: " << bytes_transferred << "\n";
+        outgoing_.pop_front();
+    }
+}
+
+} // namespace silkrpc::http
@@ -0,0 +1,126 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_HTTP_WEBSOCKET_SESSION_HPP_
+#define SILKRPC_HTTP_WEBSOCKET_SESSION_HPP_
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <silkrpc/config.hpp>
+
+#include <asio/awaitable.hpp>
+#include <asio/ip/tcp.hpp>
+#include <nlohmann/json.hpp>
+
+#include <silkrpc/common/chained_buffer.hpp>
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/timer_wheel.hpp>
+#include <silkrpc/http/connection_io.hpp>
+#include <silkrpc/http/request_handler.hpp>
+#include <silkrpc/http/websocket.hpp>
+#include <silkrpc/subscriptions/subscription_manager.hpp>
+
+namespace silkrpc::http {
+
+/// Represents the WebSocket session established on a connection after a successful upgrade.
+class WebSocketSession {
+public:
+    WebSocketSession(const WebSocketSession&) = delete;
+    WebSocketSession& operator=(const WebSocketSession&) = delete;
+
+    /// Construct a session using the connection socket and request handler, enforcing the connection timeouts.
+    WebSocketSession(asio::ip::tcp::socket& socket, RequestHandler& request_handler, subscriptions::SubscriptionManager& subscription_manager,
+        TimerWheel& timer_wheel, const ConnectionLimits& limits);
+
+    ~WebSocketSession();
+
+    /// Serve the session until it gets closed, starting from the data already received after the upgrade request.
+    asio::awaitable<void> run(std::string_view initial_data);
+
+private:
+    /// Read and process the incoming frames until the session gets closed.
+    asio::awaitable<void> do_read(std::string_view initial_data);
+
+    /// Process a single incoming frame.
+    asio::awaitable<void> handle_frame(websocket::Frame& frame);
+
+    /// Process a complete incoming message.
+    asio::awaitable<void> handle_message(const std::string& message);
+
+    /// Handle eth_subscribe, which needs the session to push notifications.
+    nlohmann::json handle_subscribe(const nlohmann::json& request_json);
+
+    /// Handle eth_unsubscribe, restricted to the subscriptions opened by this session.
+    nlohmann::json handle_unsubscribe(const nlohmann::json& request_json);
+
+    /// Queue a message for sending, starting the writer if not already running.
+    void send(websocket::Opcode opcode, ChainedBuffer&& payload);
+
+    /// Send a close frame with the given status code and stop processing incoming frames.
+    void close(uint16_t status_code);
+
+    /// Cancel all the subscriptions opened by this session.
+    void unsubscribe_all();
+
+    /// Write the queued messages until there are none left.
+    asio::awaitable<void> do_write();
+
+    /// Socket for the connection, owned by the connection itself.
+    asio::ip::tcp::socket& socket_;
+
+    /// The handler used to process the incoming requests other than subscriptions.
+    RequestHandler& request_handler_;
+
+    /// The subscription manager of the execution context.
+    subscriptions::SubscriptionManager& subscription_manager_;
+
+    /// Buffer for incoming data.
+    std::array<char, kHttpIncomingBufferSize> buffer_;
+
+    /// The incoming data not yet decoded as frames.
+    std::string incoming_;
+
+    /// The fragmented incoming message being reassembled.
+    std::string message_;
+
+    /// Flag indicating if a fragmented message is being reassembled.
+    bool fragmented_{false};
+
+    /// The outgoing messages waiting to be written.
+    std::deque<std::pair<websocket::Opcode, ChainedBuffer>> outgoing_;
+
+    /// The writer of the outgoing messages.
+    PendingWrite pending_write_;
+
+    /// Flag indicating if the session is closing.
+    bool closing_{false};
+
+    /// The subscriptions opened by this session.
+    std::set<subscriptions::SubscriptionId> subscriptions_;
+
+    /// The idle, read and write timeouts.
+    ConnectionTimeouts<asio::ip::tcp::socket> timeouts_;
+};
+
+} // namespace silkrpc::http
+
+#endif // SILKRPC_HTTP_WEBSOCKET_SESSION_HPP_
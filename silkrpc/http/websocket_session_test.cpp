@@ -0,0 +1,303 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "websocket_session.hpp"
+
+#include <array>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <asio/co_spawn.hpp>
+#include <asio/ip/tcp.hpp>
+#include <asio/post.hpp>
+#include <asio/read.hpp>
+#include <asio/use_future.hpp>
+#include <asio/write.hpp>
+#include <catch2/catch.hpp>
+#include <gmock/gmock.h>
+#include <grpcpp/grpcpp.h>
+#include <nlohmann/json.hpp>
+
+#include <silkrpc/grpc/async_completion_handler.hpp>
+#include <silkrpc/http/connection_test_fixture.hpp>
+#include <silkrpc/interfaces/remote/ethbackend_mock.grpc.pb.h>
+#include <silkrpc/interfaces/remote/kv_mock.grpc.pb.h>
+#include <silkrpc/interfaces/txpool/txpool_mock.grpc.pb.h>
+
+namespace silkrpc::http {
+
+using testing::Return;
+using testing::_;
+
+namespace {
+
+class NoDatabase : public ethdb::Database {
+public:
+    asio::awaitable<std::unique_ptr<ethdb::Transaction>> begin() override {
+        throw std::runtime_error{"unexpected begin"};
+    }
+};
+
+// Pending transactions stream returning the same transactions at each read
+class MockClientAsyncOnAddReader : public grpc::ClientAsyncReaderInterface<::txpool::OnAddReply> {
+public:
+    explicit MockClientAsyncOnAddReader(std::vector<std::string> rlp_txs) : rlp_txs_(std::move(rlp_txs)) {}
+
+    void StartCall(void* tag) override { tag_ = tag; }
+    void ReadInitialMetadata(void* tag) override {}
+    void Read(::txpool::OnAddReply* msg, void* tag) override {
+        msg->clear_rpltxs();
+        for (const auto& rlp_tx : rlp_txs_) {
+            msg->add_rpltxs(rlp_tx);
+        }
+    }
+    void Finish(grpc::Status* status, void* tag) override { *status = grpc::Status::CANCELLED; }
+
+    void* tag() const { return tag_; }
+
+private:
+    std::vector<std::string> rlp_txs_;
+    void* tag_{nullptr};
+};
+
+// Build a masked client frame as a browser would send it
+std::string make_masked_frame(uint8_t first_byte, const std::string& payload) {
+    const char mask[4] = {0x12, static_cast<char>(0xab), 0x5c, 0x07};
+    std::string frame;
+    frame.push_back(static_cast<char>(first_byte));
+    if (payload.size() < 126) {
+        frame.push_back(static_cast<char>(0x80 | payload.size()));
+    } else {
+        frame.push_back(static_cast<char>(0x80 | 126));
+        frame.push_back(static_cast<char>(payload.size() >> 8));
+        frame.push_back(static_cast<char>(payload.size() & 0xFF));
+    }
+    frame.append(mask, 4);
+    for (std::size_t i{0}; i < payload.size(); ++i) {
+        frame.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+    }
+    return frame;
+}
+
+} // namespace
+
+TEST_CASE_METHOD(ConnectionTestFixture, "websocket session", "[silkrpc][http][websocket_session]") {
+    RequestHandler request_handler{context_pool.get_context(), rpc_api, workers, rpc_api_table, admission_control};
+
+    // The pending transactions stream is driven explicitly by the test
+    auto& io_context = context_pool.get_io_context();
+    grpc::CompletionQueue queue;
+    NoDatabase database;
+    auto txpool_stub = std::make_unique<::txpool::MockTxpoolStub>();
+    auto txpool_stub_ptr = txpool_stub.get();
+    subscriptions::SubscriptionManager subscription_manager{io_context, std::make_unique<::remote::MockETHBACKENDStub>(),
+        std::make_unique<::remote::MockKVStub>(), std::move(txpool_stub), &queue, database};
+
+    // The client talks synchronously to the session served on the context thread
+    asio::ip::tcp::acceptor acceptor{io_context, asio::ip::tcp::endpoint{asio::ip::address_v4::loopback(), 0}};
+    asio::ip::tcp::socket socket{io_context};
+    asio::ip::tcp::socket client{io_context};
+    client.connect(acceptor.local_endpoint());
+    acceptor.accept(socket);
+    ConnectionLimits limits;
+    limits.idle_timeout = std::chrono::milliseconds{500};
+    limits.read_timeout = std::chrono::milliseconds{500};
+    WebSocketSession session{socket, request_handler, subscription_manager, *context_pool.get_context().timer_wheel, limits};
+    auto served{asio::co_spawn(io_context, session.run({}), asio::use_future)};
+
+    const auto send = [&](uint8_t first_byte, const std::string& payload) {
+        asio::write(client, asio::buffer(make_masked_frame(first_byte, payload)));
+    };
+    const auto receive = [&]() {
+        std::array<uint8_t, 2> header{};
+        asio::read(client, asio::buffer(header));
+        std::size_t payload_length = header[1] & 0x7F;
+        if (payload_length == 126) {
+            std::array<uint8_t, 2> length{};
+            asio::read(client, asio::buffer(length));
+            payload_length = (std::size_t(length[0]) << 8) | length[1];
+        } else if (payload_length == 127) {
+            std::array<uint8_t, 8> length{};
+            asio::read(client, asio::buffer(length));
+            payload_length = 0;
+            for (const auto byte : length) {
+                payload_length = (payload_length << 8) | byte;
+            }
+        }
+        std::string payload(payload_length, '\0');
+        asio::read(client, asio::buffer(payload));
+        return std::make_pair(header[0], payload);
+    };
+    const auto on_context = [&](auto&& f) {
+        return asio::post(io_context, asio::use_future(std::forward<decltype(f)>(f))).get();
+    };
+
+    const std::string sha3_request{R"({"jsonrpc":"2.0","id":1,"method":"web3_sha3","params":["0x"]})"};
+    const std::string sha3_result{"0xc5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"};
+
+    SECTION("text message") {
+        send(0x81, sha3_request);
+        const auto [first_byte, payload] = receive();
+        CHECK(first_byte == 0x81);
+        const auto reply = nlohmann::json::parse(payload);
+        CHECK(reply["id"] == 1);
+        CHECK(reply["result"] == sha3_result);
+    }
+
+    SECTION("fragmented message") {
+        send(0x01, sha3_request.substr(0, 10));
+        send(0x00, sha3_request.substr(10, 20));
+        send(0x80, sha3_request.substr(30));
+        const auto [first_byte, payload] = receive();
+        CHECK(first_byte == 0x81);
+        CHECK(nlohmann::json::parse(payload)["result"] == sha3_result);
+    }
+
+    SECTION("ping interleaved with fragmented message") {
+        send(0x01, sha3_request.substr(0, 10));
+        send(0x89, "ping");
+        const auto [pong_first_byte, pong_payload] = receive();
+        CHECK(pong_first_byte == 0x8A);
+        CHECK(pong_payload == "ping");
+        send(0x80, sha3_request.substr(10));
+        const auto [first_byte, payload] = receive();
+        CHECK(first_byte == 0x81);
+        CHECK(nlohmann::json::parse(payload)["result"] == sha3_result);
+    }
+
+    SECTION("continuation without first fragment") {
+        send(0x80, sha3_request);
+        const auto [first_byte, payload] = receive();
+        CHECK(first_byte == 0x88);
+        CHECK(payload == std::string{"\x03\xEA"}); // 1002: protocol error
+        CHECK_NOTHROW(served.get());
+    }
+
+    SECTION("invalid json") {
+        send(0x81, "{");
+        const auto [first_byte, payload] = receive();
+        CHECK(first_byte == 0x81);
+        CHECK(nlohmann::json::parse(payload).contains("error"));
+    }
+
+    SECTION("close handshake") {
+        send(0x88, std::string{"\x03\xE8"});
+        const auto [first_byte, payload] = receive();
+        CHECK(first_byte == 0x88);
+        CHECK(payload == std::string{"\x03\xE8"}); // 1000: normal closure
+        CHECK_NOTHROW(served.get());
+    }
+
+    SECTION("subscribe and unsubscribe") {
+        auto mock_reader = new MockClientAsyncOnAddReader{{"tx1"}};
+        EXPECT_CALL(*txpool_stub_ptr, PrepareAsyncOnAddRaw(_, _, _)).WillOnce(Return(mock_reader));
+
+        send(0x81, R"({"jsonrpc":"2.0","id":1,"method":"eth_subscribe","params":["newPendingTransactions"]})");
+        const auto subscribe_reply = nlohmann::json::parse(receive().second);
+        REQUIRE(subscribe_reply.contains("result"));
+        const auto subscription_id = subscribe_reply["result"].get<std::string>();
+        CHECK(on_context([&]() { return subscription_manager.num_subscriptions(); }) == 1);
+
+        auto handler = AsyncCompletionHandler::detag(mock_reader->tag());
+        on_context([&]() { handler->completed(true); }); // StartCall
+        on_context([&]() { handler->completed(true); }); // Read
+        const auto notification = nlohmann::json::parse(receive().second);
+        CHECK(notification["method"] == "eth_subscription");
+        CHECK(notification["params"]["subscription"] == subscription_id);
+
+        // Unknown subscriptions cannot be cancelled, just the ones opened by the session
+        send(0x81, R"({"jsonrpc":"2.0","id":2,"method":"eth_unsubscribe","params":["0x12345"]})");
+        CHECK(nlohmann::json::parse(receive().second)["result"] == false);
+        send(0x81, R"({"jsonrpc":"2.0","id":3,"method":"eth_unsubscribe","params":[")" + subscription_id + R"("]})");
+        CHECK(nlohmann::json::parse(receive().second)["result"] == true);
+        CHECK(on_context([&]() { return subscription_manager.num_subscriptions(); }) == 0);
+
+        on_context([&]() { handler->completed(false); }); // stream cancelled
+        on_context([&]() { handler->completed(true); });  // Finish
+    }
+
+    SECTION("unsupported subscription") {
+        send(0x81, R"({"jsonrpc":"2.0","id":1,"method":"eth_subscribe","params":["syncing"]})");
+        CHECK(nlohmann::json::parse(receive().second).contains("error"));
+        CHECK(on_context([&]() { return subscription_manager.num_subscriptions(); }) == 0);
+    }
+
+    SECTION("idle session closed") {
+        send(0x81, sha3_request);
+        CHECK(nlohmann::json::parse(receive().second)["result"] == sha3_result);
+        CHECK(served.wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+    }
+
+    SECTION("partial frame timed out") {
+        asio::write(client, asio::buffer(make_masked_frame(0x81, sha3_request).substr(0, 10)));
+        CHECK(served.wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+    }
+
+    SECTION("fragmented message timed out") {
+        send(0x01, sha3_request.substr(0, 10));
+        CHECK(served.wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+    }
+
+    SECTION("session with subscriptions not idle") {
+        auto mock_reader = new MockClientAsyncOnAddReader{{"tx1"}};
+        EXPECT_CALL(*txpool_stub_ptr, PrepareAsyncOnAddRaw(_, _, _)).WillOnce(Return(mock_reader));
+
+        send(0x81, R"({"jsonrpc":"2.0","id":1,"method":"eth_subscribe","params":["newPendingTransactions"]})");
+        const auto subscription_id = nlohmann::json::parse(receive().second)["result"].get<std::string>();
+        CHECK(served.wait_for(std::chrono::seconds{1}) == std::future_status::timeout);
+
+        // The idle timeout applies again as soon as the last subscription is gone
+        send(0x81, R"({"jsonrpc":"2.0","id":2,"method":"eth_unsubscribe","params":[")" + subscription_id + R"("]})");
+        CHECK(nlohmann::json::parse(receive().second)["result"] == true);
+        CHECK(served.wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+
+        auto handler = AsyncCompletionHandler::detag(mock_reader->tag());
+        on_context([&]() { handler->completed(false); }); // stream cancelled
+        on_context([&]() { handler->completed(true); });  // Finish
+    }
+
+    SECTION("slow client dropped") {
+        // One read delivers more notifications than can be queued, so the client is dropped without reading them
+        auto mock_reader = new MockClientAsyncOnAddReader{std::vector<std::string>(kMaxWebSocketPendingMessages + 1, "tx")};
+        EXPECT_CALL(*txpool_stub_ptr, PrepareAsyncOnAddRaw(_, _, _)).WillOnce(Return(mock_reader));
+
+        send(0x81, R"({"jsonrpc":"2.0","id":1,"method":"eth_subscribe","params":["newPendingTransactions"]})");
+        CHECK(nlohmann::json::parse(receive().second).contains("result"));
+
+        auto handler = AsyncCompletionHandler::detag(mock_reader->tag());
+        on_context([&]() { handler->completed(true); }); // StartCall
+        on_context([&]() { handler->completed(true); }); // Read
+        CHECK_THROWS_AS(served.get(), std::system_error);
+        CHECK(on_context([&]() { return subscription_manager.num_subscriptions(); }) == 0);
+
+        on_context([&]() { handler->completed(false); }); // stream cancelled
+        on_context([&]() { handler->completed(true); });  // Finish
+    }
+
+    client.close();
+    if (served.valid()) {
+        served.wait();
+    }
+    stop();
+}
+
+} // namespace silkrpc::http
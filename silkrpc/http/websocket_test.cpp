@@ -0,0 +1,171 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "websocket.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include <silkrpc/http/request_parser.hpp>
+
+namespace silkrpc::http::websocket {
+
+// Build a masked client frame as a browser would send it
+std::string make_client_frame(uint8_t first_byte, const std::string& payload) {
+    const char mask[4] = {0x37, static_cast<char>(0xfa), 0x21, 0x3d};
+    std::string frame;
+    frame.push_back(static_cast<char>(first_byte));
+    if (payload.size() < 126) {
+        frame.push_back(static_cast<char>(0x80 | payload.size()));
+    } else {
+        frame.push_back(static_cast<char>(0x80 | 126));
+        frame.push_back(static_cast<char>(payload.size() >> 8));
+        frame.push_back(static_cast<char>(payload.size() & 0xFF));
+    }
+    frame.append(mask, 4);
+    for (std::size_t i{0}; i < payload.size(); ++i) {
+        frame.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+    }
+    return frame;
+}
+
+TEST_CASE("check websocket upgrade request", "[silkrpc][http][websocket]") {
+    Request request{"GET", "/", 1, 1, {{"Host", "localhost"}, {"upgrade", "WebSocket"}, {"Connection", "keep-alive, Upgrade"}}};
+
+    SECTION("valid upgrade request") {
+        CHECK(is_upgrade_request(request));
+    }
+
+    SECTION("POST request") {
+        request.method = "POST";
+        CHECK(!is_upgrade_request(request));
+    }
+
+    SECTION("missing connection upgrade") {
+        request.headers[2].value = "keep-alive";
+        CHECK(!is_upgrade_request(request));
+    }
+
+    SECTION("plain HTTP request") {
+        CHECK(!is_upgrade_request(Request{"POST", "/", 1, 1, {{"Content-Length", "0"}}}));
+    }
+}
+
+TEST_CASE("make websocket accept key", "[silkrpc][http][websocket]") {
+    // Example from RFC 6455, section 1.3
+    CHECK(make_accept_key("dGhlIHNhbXBsZSBub25jZQ==") == "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+TEST_CASE("make websocket upgrade reply", "[silkrpc][http][websocket]") {
+    Request request{"GET", "/", 1, 1, {{"Upgrade", "websocket"}, {"Connection", "Upgrade"}, {"Sec-WebSocket-Key", "dGhlIHNhbXBsZSBub25jZQ=="}}};
+
+    SECTION("supported version") {
+        request.headers.push_back({"Sec-WebSocket-Version", "13"});
+        const auto reply = make_upgrade_reply(request);
+        CHECK(reply.status == Reply::switching_protocols);
+        CHECK(reply.headers.size() == 3);
+        CHECK(reply.headers[2] == Header{"Sec-WebSocket-Accept", "s3pPLMBiTxaQ9kYGzzhZRbK+xOo="});
+    }
+
+    SECTION("unsupported version") {
+        request.headers.push_back({"Sec-WebSocket-Version", "8"});
+        const auto reply = make_upgrade_reply(request);
+        CHECK(reply.status == Reply::bad_request);
+        CHECK(reply.headers.back() == Header{"Sec-WebSocket-Version", "13"});
+    }
+}
+
+TEST_CASE("parse websocket handshake", "[silkrpc][http][websocket]") {
+    // Opening handshake from RFC 6455, section 1.2: a GET request without Content-Length
+    const std::string handshake{
+        "GET /chat HTTP/1.1\r\n"
+        "Host: server.example.com\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+        "Origin: http://example.com\r\n"
+        "Sec-WebSocket-Protocol: chat, superchat\r\n"
+        "Sec-WebSocket-Version: 13\r\n"
+        "\r\n"};
+    RequestParser parser;
+    Request request;
+    const auto [result, consumed_end]{parser.parse(request, handshake.data(), handshake.data() + handshake.size())};
+    CHECK(result == RequestParser::good);
+    CHECK(consumed_end == handshake.data() + handshake.size());
+    CHECK(request.content.empty());
+    CHECK(is_upgrade_request(request));
+    const auto reply = make_upgrade_reply(request);
+    CHECK(reply.status == Reply::switching_protocols);
+    CHECK(reply.headers.back() == Header{"Sec-WebSocket-Accept", "s3pPLMBiTxaQ9kYGzzhZRbK+xOo="});
+}
+
+TEST_CASE("decode websocket frame", "[silkrpc][http][websocket]") {
+    Frame frame;
+
+    SECTION("masked text frame") {
+        const auto data = make_client_frame(0x81, "Hello");
+        CHECK(decode_frame(data.data(), data.data() + data.size(), frame) == data.size());
+        CHECK(frame.fin);
+        CHECK(frame.opcode == Opcode::kText);
+        CHECK(frame.payload == "Hello");
+    }
+
+    SECTION("text frame with 16-bit length") {
+        const std::string payload(300, 'a');
+        const auto data = make_client_frame(0x81, payload);
+        CHECK(decode_frame(data.data(), data.data() + data.size(), frame) == data.size());
+        CHECK(frame.payload == payload);
+    }
+
+    SECTION("incomplete frame") {
+        const auto data = make_client_frame(0x81, "Hello");
+        for (std::size_t size{0}; size < data.size(); ++size) {
+            CHECK(decode_frame(data.data(), data.data() + size, frame) == 0);
+        }
+    }
+
+    SECTION("two frames in buffer") {
+        const auto data = make_client_frame(0x01, "Hel") + make_client_frame(0x80, "lo");
+        const auto consumed = decode_frame(data.data(), data.data() + data.size(), frame);
+        CHECK(!frame.fin);
+        CHECK(frame.payload == "Hel");
+        CHECK(decode_frame(data.data() + consumed, data.data() + data.size(), frame) == data.size() - consumed);
+        CHECK(frame.fin);
+        CHECK(frame.opcode == Opcode::kContinuation);
+        CHECK(frame.payload == "lo");
+    }
+
+    SECTION("unmasked frame") {
+        const std::string data{"\x81\x02hi"};
+        CHECK_THROWS_AS(decode_frame(data.data(), data.data() + data.size(), frame), std::runtime_error);
+    }
+
+    SECTION("fragmented control frame") {
+        const auto data = make_client_frame(0x09, "ping");
+        CHECK_THROWS_AS(decode_frame(data.data(), data.data() + data.size(), frame), std::runtime_error);
+    }
+}
+
+TEST_CASE("encode websocket frame header", "[silkrpc][http][websocket]") {
+    CHECK(encode_frame_header(Opcode::kText, 5) == std::string{"\x81\x05"});
+    CHECK(encode_frame_header(Opcode::kPong, 0) == std::string{"\x8A\x00", 2});
+    CHECK(encode_frame_header(Opcode::kText, 300) == std::string{"\x81\x7E\x01\x2C"});
+    CHECK(encode_frame_header(Opcode::kBinary, 65536) == std::string{"\x82\x7F\x00\x00\x00\x00\x00\x01\x00\x00", 10});
+}
+
+} // namespace silkrpc::http::websocket
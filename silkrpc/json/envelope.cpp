@@ -0,0 +1,260 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "envelope.hpp"
+
+#include <limits>
+#include <string>
+
+namespace silkrpc {
+
+namespace {
+
+bool is_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool is_scalar_char(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+// Single forward pass over the request content, no allocation and no DOM
+class EnvelopeScanner {
+public:
+    explicit EnvelopeScanner(std::string_view content) : current_{content.data()}, end_{content.data() + content.size()} {}
+
+    bool at_end() {
+        skip_whitespace();
+        return current_ == end_;
+    }
+
+    bool consume(char c) {
+        skip_whitespace();
+        if (current_ == end_ || *current_ != c) {
+            return false;
+        }
+        ++current_;
+        return true;
+    }
+
+    // Scan a string containing neither escape sequences nor control characters, those are left to the full parser
+    bool scan_plain_string(std::string_view& value) {
+        if (!consume('"')) {
+            return false;
+        }
+        const auto begin = current_;
+        while (current_ != end_ && *current_ != '"') {
+            if (*current_ == '\\' || static_cast<unsigned char>(*current_) < 0x20) {
+                return false;
+            }
+            ++current_;
+        }
+        if (current_ == end_) {
+            return false;
+        }
+        value = {begin, static_cast<std::size_t>(current_ - begin)};
+        ++current_;
+        return true;
+    }
+
+    bool scan_uint32(uint32_t& value) {
+        skip_whitespace();
+        const auto begin = current_;
+        uint64_t number{0};
+        while (current_ != end_ && *current_ >= '0' && *current_ <= '9') {
+            number = number * 10 + static_cast<uint64_t>(*current_ - '0');
+            if (number > std::numeric_limits<uint32_t>::max()) {
+                return false;
+            }
+            ++current_;
+        }
+        const auto num_digits = current_ - begin;
+        if (num_digits == 0 || (num_digits > 1 && *begin == '0')) {
+            return false;
+        }
+        if (current_ != end_ && (*current_ == '.' || *current_ == 'e' || *current_ == 'E')) {
+            return false;
+        }
+        value = static_cast<uint32_t>(number);
+        return true;
+    }
+
+    // Skip any value checking just that strings and brackets are terminated, the value gets validated when parsed
+    bool skip_value(std::string_view& raw_value) {
+        skip_whitespace();
+        const auto begin = current_;
+        if (current_ == end_) {
+            return false;
+        }
+        if (*current_ == '"') {
+            if (!skip_string()) {
+                return false;
+            }
+        } else if (*current_ == '[' || *current_ == '{') {
+            std::size_t depth{0};
+            do {
+                if (current_ == end_) {
+                    return false;
+                }
+                const auto c = *current_;
+                if (c == '"') {
+                    if (!skip_string()) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (c == '[' || c == '{') {
+                    ++depth;
+                } else if (c == ']' || c == '}') {
+                    --depth;
+                }
+                ++current_;
+            } while (depth > 0);
+        } else {
+            while (current_ != end_ && is_scalar_char(*current_)) {
+                ++current_;
+            }
+            if (current_ == begin) {
+                return false;
+            }
+        }
+        raw_value = {begin, static_cast<std::size_t>(current_ - begin)};
+        return true;
+    }
+
+private:
+    void skip_whitespace() {
+        while (current_ != end_ && is_whitespace(*current_)) {
+            ++current_;
+        }
+    }
+
+    bool skip_string() {
+        ++current_;
+        while (current_ != end_) {
+            if (*current_ == '"') {
+                ++current_;
+                return true;
+            }
+            if (*current_ == '\\') {
+                if (end_ - current_ < 2) {
+                    return false;
+                }
+                ++current_;
+            }
+            ++current_;
+        }
+        return false;
+    }
+
+    const char* current_;
+    const char* end_;
+};
+
+} // namespace
+
+bool parse_envelope(std::string_view content, RequestEnvelope& envelope) {
+    envelope = RequestEnvelope{};
+
+    EnvelopeScanner scanner{content};
+    if (!scanner.consume('{')) {
+        return false;
+    }
+    bool has_id{false};
+    bool has_method{false};
+    do {
+        std::string_view key;
+        if (!scanner.scan_plain_string(key) || !scanner.consume(':')) {
+            return false;
+        }
+        if (key == "id") {
+            if (!scanner.scan_uint32(envelope.id)) {
+                return false;
+            }
+            has_id = true;
+        } else if (key == "method") {
+            if (!scanner.scan_plain_string(envelope.method)) {
+                return false;
+            }
+            has_method = true;
+        } else if (key == "jsonrpc") {
+            if (!scanner.scan_plain_string(envelope.jsonrpc)) {
+                return false;
+            }
+        } else if (key == "params") {
+            if (!scanner.skip_value(envelope.params)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    } while (scanner.consume(','));
+
+    return scanner.consume('}') && scanner.at_end() && has_id && has_method;
+}
+
+bool find_reply_id(std::string_view reply, std::string_view& raw_id) {
+    EnvelopeScanner scanner{reply};
+    if (!scanner.consume('{')) {
+        return false;
+    }
+    do {
+        std::string_view key;
+        if (!scanner.scan_plain_string(key) || !scanner.consume(':')) {
+            return false;
+        }
+        std::string_view raw_value;
+        if (!scanner.skip_value(raw_value)) {
+            return false;
+        }
+        if (key == "id") {
+            raw_id = raw_value;
+            return true;
+        }
+    } while (scanner.consume(','));
+    return false;
+}
+
+nlohmann::json make_request_json(const RequestEnvelope& envelope) {
+    nlohmann::json request_json;
+    request_json["id"] = envelope.id;
+    if (!envelope.jsonrpc.empty()) {
+        request_json["jsonrpc"] = std::string{envelope.jsonrpc};
+    }
+    request_json["method"] = std::string{envelope.method};
+    if (!envelope.params.empty()) {
+        request_json["params"] = nlohmann::json::parse(envelope.params);
+    }
+    return request_json;
+}
+
+std::string LazyRequestJson::params_text() const {
+    if (envelope_) {
+        return std::string{envelope_->params};
+    }
+    return request_json_->contains("params") ? (*request_json_)["params"].dump() : std::string{};
+}
+
+const nlohmann::json& LazyRequestJson::get() {
+    if (request_json_ == nullptr) {
+        parsed_json_ = make_request_json(*envelope_);
+        request_json_ = &*parsed_json_;
+    }
+    return *request_json_;
+}
+
+} // namespace silkrpc
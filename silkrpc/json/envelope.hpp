@@ -0,0 +1,77 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#ifndef SILKRPC_JSON_ENVELOPE_HPP_
+#define SILKRPC_JSON_ENVELOPE_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+namespace silkrpc {
+
+// The JSON-RPC request members needed for routing, scanned without building any DOM. All views refer to the
+// request content, which must outlive the envelope.
+struct RequestEnvelope {
+    uint32_t id{0};
+    std::string_view jsonrpc;
+    std::string_view method;
+    std::string_view params; // raw JSON text of the params value, empty if not present
+};
+
+// Scan the content of a single JSON-RPC request, extracting jsonrpc, id and method and skipping over params.
+// Only the common well-formed shape is accepted: an object with an unsigned 32-bit integer id, a method string
+// without escapes and no other members than jsonrpc, id, method and params. Return false for anything else
+// (batches, unusual ids, unknown members, malformed input): the caller must then fall back to a full parse.
+bool parse_envelope(std::string_view content, RequestEnvelope& envelope);
+
+// Build the request JSON expected by the handlers, parsing the params only now.
+nlohmann::json make_request_json(const RequestEnvelope& envelope);
+
+// The request JSON expected by the handlers, either already parsed or built from the envelope on first access, so
+// that requests rejected or served by an identical one in flight never parse their params. Whatever it refers to
+// must outlive it. Not thread-safe.
+class LazyRequestJson {
+public:
+    explicit LazyRequestJson(const RequestEnvelope& envelope) : envelope_{envelope} {}
+    explicit LazyRequestJson(const nlohmann::json& request_json) : request_json_{&request_json} {}
+
+    LazyRequestJson(const LazyRequestJson&) = delete;
+    LazyRequestJson& operator=(const LazyRequestJson&) = delete;
+
+    // The JSON text of the params: as received if scanned from the envelope, serialized again otherwise (empty if not present)
+    std::string params_text() const;
+
+    // The request JSON, parsing the params the first time. Throw nlohmann::json::parse_error if they are malformed.
+    const nlohmann::json& get();
+
+private:
+    std::optional<RequestEnvelope> envelope_;
+    const nlohmann::json* request_json_{nullptr};
+    std::optional<nlohmann::json> parsed_json_;
+};
+
+// Locate the raw JSON text of the id member within the serialized reply to a single JSON-RPC request, scanning just
+// the top-level members. Return false if the reply is not an object having an id member.
+bool find_reply_id(std::string_view reply, std::string_view& raw_id);
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_JSON_ENVELOPE_HPP_
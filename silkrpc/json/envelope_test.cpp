@@ -0,0 +1,152 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+#include "envelope.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace silkrpc {
+
+TEST_CASE("parse request envelope", "[silkrpc][json][envelope]") {
+    RequestEnvelope envelope;
+
+    SECTION("full request") {
+        const std::string content{R"({"jsonrpc":"2.0","id":1,"method":"eth_getBalance","params":["0x0715a7794a1dc8e42615f059dd6e406a6594651a","latest"]})"};
+        CHECK(parse_envelope(content, envelope));
+        CHECK(envelope.id == 1);
+        CHECK(envelope.jsonrpc == "2.0");
+        CHECK(envelope.method == "eth_getBalance");
+        CHECK(envelope.params == R"(["0x0715a7794a1dc8e42615f059dd6e406a6594651a","latest"])");
+    }
+
+    SECTION("any member order and whitespace") {
+        const std::string content{" {\n\t\"params\" : [ {\"a\":[1,\"]}\\\"\"]} ] ,\"method\": \"eth_call\" , \"id\" :4294967295 } \r\n"};
+        CHECK(parse_envelope(content, envelope));
+        CHECK(envelope.id == 4294967295);
+        CHECK(envelope.jsonrpc.empty());
+        CHECK(envelope.method == "eth_call");
+        CHECK(envelope.params == R"([ {"a":[1,"]}\""]} ])");
+    }
+
+    SECTION("no params") {
+        CHECK(parse_envelope(R"({"id":0,"method":"eth_blockNumber"})", envelope));
+        CHECK(envelope.id == 0);
+        CHECK(envelope.params.empty());
+    }
+
+    SECTION("scalar params") {
+        CHECK(parse_envelope(R"({"id":2,"method":"m","params":null})", envelope));
+        CHECK(envelope.params == "null");
+    }
+
+    SECTION("unsupported shapes fall back") {
+        CHECK(!parse_envelope(R"([{"id":1,"method":"eth_blockNumber"}])", envelope));
+        CHECK(!parse_envelope(R"({"id":"1","method":"eth_blockNumber"})", envelope));
+        CHECK(!parse_envelope(R"({"id":-1,"method":"eth_blockNumber"})", envelope));
+        CHECK(!parse_envelope(R"({"id":1.5,"method":"eth_blockNumber"})", envelope));
+        CHECK(!parse_envelope(R"({"id":01,"method":"eth_blockNumber"})", envelope));
+        CHECK(!parse_envelope(R"({"id":4294967296,"method":"eth_blockNumber"})", envelope));
+        CHECK(!parse_envelope(R"({"id":1,"method":"eth_\u0062lockNumber"})", envelope));
+        CHECK(!parse_envelope(R"({"id":1,"method":"eth_blockNumber","extra":true})", envelope));
+        CHECK(!parse_envelope(R"({"id":1})", envelope));
+        CHECK(!parse_envelope(R"({"method":"eth_blockNumber"})", envelope));
+    }
+
+    SECTION("malformed content") {
+        CHECK(!parse_envelope("", envelope));
+        CHECK(!parse_envelope("{}", envelope));
+        CHECK(!parse_envelope(R"({"id":1,"method":"eth_blockNumber")", envelope));
+        CHECK(!parse_envelope(R"({"id":1,"method":"eth_blockNumber"}})", envelope));
+        CHECK(!parse_envelope(R"({"id":1,"method":"eth_blockNumber",})", envelope));
+        CHECK(!parse_envelope(R"({"id":1,"method":"eth_blockNumber","params":["latest"})", envelope));
+        CHECK(!parse_envelope(R"({"id":1,"method":"eth_blockNumber","params":["latest]})", envelope));
+    }
+}
+
+TEST_CASE("make request json from envelope", "[silkrpc][json][envelope]") {
+    RequestEnvelope envelope;
+
+    SECTION("same as full parse") {
+        const std::string content{R"({"jsonrpc":"2.0","id":3,"method":"eth_getBlockByNumber","params":["0x1",true]})"};
+        CHECK(parse_envelope(content, envelope));
+        CHECK(make_request_json(envelope) == nlohmann::json::parse(content));
+    }
+
+    SECTION("no params") {
+        const std::string content{R"({"id":3,"method":"eth_blockNumber"})"};
+        CHECK(parse_envelope(content, envelope));
+        CHECK(make_request_json(envelope) == nlohmann::json::parse(content));
+    }
+
+    SECTION("invalid params") {
+        CHECK(parse_envelope(R"({"id":3,"method":"eth_blockNumber","params":[1 2]})", envelope));
+        CHECK_THROWS_AS(make_request_json(envelope), nlohmann::json::parse_error);
+    }
+}
+
+TEST_CASE("find reply id", "[silkrpc][json][envelope]") {
+    std::string_view raw_id;
+
+    SECTION("content reply") {
+        const std::string reply{R"({"id":3,"jsonrpc":"2.0","result":{"id":"nested"}})"};
+        CHECK(find_reply_id(reply, raw_id));
+        CHECK(raw_id == "3");
+        CHECK(raw_id.data() == reply.data() + 6);
+    }
+
+    SECTION("error reply") {
+        const std::string reply{R"({"error":{"code":100,"message":"\"id\":7"},"id":12,"jsonrpc":"2.0"})"};
+        CHECK(find_reply_id(reply, raw_id));
+        CHECK(raw_id == "12");
+    }
+
+    SECTION("no id") {
+        CHECK(!find_reply_id(R"({"jsonrpc":"2.0","result":[{"id":1}]})", raw_id));
+        CHECK(!find_reply_id(R"([{"id":1}])", raw_id));
+        CHECK(!find_reply_id(R"({"id")", raw_id));
+    }
+}
+
+TEST_CASE("lazy request json", "[silkrpc][json][envelope]") {
+    SECTION("from envelope") {
+        const std::string content{R"({"jsonrpc":"2.0","id":3,"method":"eth_getBalance","params":["0x1", "latest"]})"};
+        RequestEnvelope envelope;
+        CHECK(parse_envelope(content, envelope));
+        LazyRequestJson request{envelope};
+        CHECK(request.params_text() == R"(["0x1", "latest"])");
+        CHECK(request.get() == nlohmann::json::parse(content));
+        CHECK(&request.get() == &request.get());
+        CHECK(request.params_text() == R"(["0x1", "latest"])");
+    }
+
+    SECTION("invalid params parsed on first access") {
+        RequestEnvelope envelope;
+        CHECK(parse_envelope(R"({"id":3,"method":"eth_blockNumber","params":[1 2]})", envelope));
+        LazyRequestJson request{envelope};
+        CHECK(request.params_text() == "[1 2]");
+        CHECK_THROWS_AS(request.get(), nlohmann::json::parse_error);
+    }
+
+    SECTION("from parsed json") {
+        const auto request_json = nlohmann::json::parse(R"({"id":3,"method":"eth_blockNumber"})");
+        LazyRequestJson request{request_json};
+        CHECK(request.params_text().empty());
+        CHECK(&request.get() == &request_json);
+    }
+}
+
+} // namespace silkrpc
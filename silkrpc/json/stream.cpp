@@ -0,0 +1,595 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "stream.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <string>
+
+#include <boost/endian/conversion.hpp>
+#include <silkworm/common/endian.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/util.hpp>
+
+namespace silkrpc {
+
+namespace {
+
+constexpr const char* kHexDigits{"0123456789abcdef"};
+
+// Number of bytes converted to hex digits at once on the stack
+constexpr const std::size_t kHexBlockSize{256};
+
+void append_hex_digits(ChainedBuffer& buffer, silkworm::ByteView bytes) {
+    char hex[2 * kHexBlockSize];
+    while (!bytes.empty()) {
+        const auto count = std::min(bytes.size(), kHexBlockSize);
+        for (std::size_t i{0}; i < count; ++i) {
+            hex[2 * i] = kHexDigits[bytes[i] >> 4];
+            hex[2 * i + 1] = kHexDigits[bytes[i] & 0x0f];
+        }
+        buffer.append(std::string_view{hex, 2 * count});
+        bytes.remove_prefix(count);
+    }
+}
+
+// Location of a transaction within its block, exposed together with the transaction fields
+struct TransactionLocation {
+    const evmc::bytes32& block_hash;
+    uint64_t block_number;
+    intx::uint256 gas_price;
+    uint64_t index;
+};
+
+void write_transaction(JsonStream& stream, const silkworm::Transaction& transaction, const TransactionLocation& location) {
+    if (!transaction.from) {
+        (const_cast<silkworm::Transaction&>(transaction)).recover_sender();
+    }
+    const bool is_legacy = transaction.type == silkworm::Transaction::Type::kLegacy;
+
+    stream.open_object();
+    if (!is_legacy) {
+        stream.write_key("accessList"); // EIP2930
+        stream.open_array();
+        for (const auto& access_list_entry : transaction.access_list) {
+            stream.open_object();
+            stream.write_key("account");
+            stream.write_address(access_list_entry.account);
+            stream.write_key("storage_keys");
+            stream.open_array();
+            for (const auto& storage_key : access_list_entry.storage_keys) {
+                stream.write_bytes32(storage_key);
+            }
+            stream.close_array();
+            stream.close_object();
+        }
+        stream.close_array();
+    }
+    stream.write_key("blockHash");
+    stream.write_bytes32(location.block_hash);
+    stream.write_key("blockNumber");
+    stream.write_quantity(location.block_number);
+    if (!is_legacy) {
+        stream.write_key("chainId");
+        stream.write_quantity(*transaction.chain_id);
+    }
+    if (transaction.from) {
+        stream.write_key("from");
+        stream.write_address(*transaction.from);
+    }
+    stream.write_key("gas");
+    stream.write_quantity(transaction.gas_limit);
+    stream.write_key("gasPrice");
+    stream.write_quantity(location.gas_price);
+    stream.write_key("hash");
+    stream.write_hex(full_view(hash_of_transaction(transaction)));
+    stream.write_key("input");
+    stream.write_hex(transaction.data);
+    if (transaction.type == silkworm::Transaction::Type::kEip1559) {
+        stream.write_key("maxFeePerGas");
+        stream.write_quantity(transaction.max_fee_per_gas);
+        stream.write_key("maxPriorityFeePerGas");
+        stream.write_quantity(transaction.max_priority_fee_per_gas);
+    }
+    stream.write_key("nonce");
+    stream.write_quantity(transaction.nonce);
+    stream.write_key("r");
+    stream.write_quantity(silkworm::endian::to_big_compact(transaction.r));
+    stream.write_key("s");
+    stream.write_quantity(silkworm::endian::to_big_compact(transaction.s));
+    stream.write_key("to");
+    if (transaction.to) {
+        stream.write_address(*transaction.to);
+    } else {
+        stream.write_null();
+    }
+    stream.write_key("transactionIndex");
+    stream.write_quantity(location.index);
+    stream.write_key("type");
+    stream.write_quantity(static_cast<uint64_t>(transaction.type));
+    stream.write_key("v");
+    if (!is_legacy) {
+        stream.write_quantity(static_cast<uint64_t>(transaction.odd_y_parity));
+    } else {
+        stream.write_quantity(silkworm::endian::to_big_compact(transaction.v()));
+    }
+    stream.write_key("value");
+    stream.write_quantity(transaction.value);
+    stream.close_object();
+}
+
+// Write the account as member of the accounts object of the dump
+void write_account(JsonStream& stream, const evmc::address& address, const DumpAccount& account) {
+    stream.write_key("0x" + silkworm::to_hex(address));
+    stream.open_object();
+    stream.write_key("balance");
+    stream.write_string(to_dec(account.balance));
+    if (account.code) {
+        stream.write_key("code");
+        stream.write_hex(*account.code);
+    }
+    stream.write_key("codeHash");
+    stream.write_bytes32(account.code_hash);
+    stream.write_key("nonce");
+    stream.write_uint(account.nonce);
+    stream.write_key("root");
+    stream.write_bytes32(account.root);
+    if (account.storage) {
+        stream.write_key("storage");
+        stream.open_object();
+        for (const auto& [location, value] : *account.storage) {
+            stream.write_key("0x" + silkworm::to_hex(location));
+            stream.write_hex(value);
+        }
+        stream.close_object();
+    }
+    stream.close_object();
+}
+
+// Close the accounts and write the remaining members of the dump
+void write_dump_tail(JsonStream& stream, const DumpAccounts& dump) {
+    stream.close_object();
+    stream.write_key("next");
+    stream.write_string(base64_encode(dump.next.bytes, silkworm::kAddressLength, false));
+    stream.write_key("root");
+    stream.write_bytes32(dump.root);
+    stream.close_object();
+}
+
+// Write the members of the reply content preceding the result
+void write_content_head(JsonStream& stream, uint32_t id) {
+    stream.open_object();
+    stream.write_key("id");
+    stream.write_uint(id);
+    stream.write_key("jsonrpc");
+    stream.write_string("2.0");
+    stream.write_key("result");
+}
+
+} // namespace
+
+void JsonStream::open_object() {
+    write_separator();
+    buffer_.append('{');
+    need_separator_ = false;
+}
+
+void JsonStream::close_object() {
+    buffer_.append('}');
+    need_separator_ = true;
+}
+
+void JsonStream::open_array() {
+    write_separator();
+    buffer_.append('[');
+    need_separator_ = false;
+}
+
+void JsonStream::close_array() {
+    buffer_.append(']');
+    need_separator_ = true;
+}
+
+void JsonStream::write_key(std::string_view key) {
+    write_separator();
+    write_escaped(key);
+    buffer_.append(':');
+    need_separator_ = false;
+}
+
+void JsonStream::write_string(std::string_view value) {
+    write_separator();
+    write_escaped(value);
+    need_separator_ = true;
+}
+
+void JsonStream::write_hex(silkworm::ByteView bytes) {
+    write_separator();
+    buffer_.append("\"0x");
+    append_hex_digits(buffer_, bytes);
+    buffer_.append('"');
+    need_separator_ = true;
+}
+
+void JsonStream::write_address(const evmc::address& address) {
+    write_hex(full_view(address));
+}
+
+void JsonStream::write_bytes32(const evmc::bytes32& bytes32) {
+    write_hex(full_view(bytes32));
+}
+
+void JsonStream::write_quantity(uint64_t number) {
+    uint8_t number_bytes[sizeof(uint64_t)];
+    boost::endian::store_big_u64(number_bytes, number);
+    write_quantity(silkworm::ByteView{number_bytes, sizeof(uint64_t)});
+}
+
+void JsonStream::write_quantity(const intx::uint256& number) {
+    if (number == 0) {
+        write_raw_value("\"0x0\"");
+        return;
+    }
+    write_quantity(silkworm::endian::to_big_compact(number));
+}
+
+void JsonStream::write_quantity(silkworm::ByteView bytes) {
+    // Same digits as to_quantity: no leading zeros, except the last one for a zero value
+    while (bytes.size() > 1 && bytes[0] == 0) {
+        bytes.remove_prefix(1);
+    }
+    write_separator();
+    buffer_.append("\"0x");
+    if (!bytes.empty()) {
+        if ((bytes[0] >> 4) != 0) {
+            buffer_.append(kHexDigits[bytes[0] >> 4]);
+        }
+        buffer_.append(kHexDigits[bytes[0] & 0x0f]);
+        append_hex_digits(buffer_, bytes.substr(1));
+    }
+    buffer_.append('"');
+    need_separator_ = true;
+}
+
+void JsonStream::write_uint(uint64_t number) {
+    char digits[24];
+    const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), number);
+    write_raw_value({digits, static_cast<std::size_t>(end - digits)});
+}
+
+void JsonStream::write_bool(bool value) {
+    write_raw_value(value ? "true" : "false");
+}
+
+void JsonStream::write_null() {
+    write_raw_value("null");
+}
+
+void JsonStream::write_json(const nlohmann::json& json) {
+    switch (json.type()) {
+        case nlohmann::json::value_t::null:
+            write_null();
+            break;
+        case nlohmann::json::value_t::object:
+            open_object();
+            for (auto it = json.begin(); it != json.end(); ++it) {
+                write_key(it.key());
+                write_json(it.value());
+            }
+            close_object();
+            break;
+        case nlohmann::json::value_t::array:
+            open_array();
+            for (const auto& element : json) {
+                write_json(element);
+            }
+            close_array();
+            break;
+        case nlohmann::json::value_t::string:
+            write_string(json.get_ref<const std::string&>());
+            break;
+        case nlohmann::json::value_t::boolean:
+            write_bool(json.get<bool>());
+            break;
+        case nlohmann::json::value_t::number_unsigned:
+            write_uint(json.get<uint64_t>());
+            break;
+        case nlohmann::json::value_t::number_integer: {
+            char digits[24];
+            const auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), json.get<int64_t>());
+            write_raw_value({digits, static_cast<std::size_t>(end - digits)});
+            break;
+        }
+        default:
+            // Floating-point numbers and binary values are rare enough to keep the nlohmann formatting
+            write_raw_value(json.dump(/*indent=*/-1, /*indent_char=*/' ', /*ensure_ascii=*/false, nlohmann::json::error_handler_t::replace));
+            break;
+    }
+}
+
+void JsonStream::write_serialized(std::string_view json) {
+    write_raw_value(json);
+}
+
+asio::awaitable<void> JsonStream::flush() {
+    if (flusher_ && buffer_.size() >= kReplyFlushSize) {
+        flushed_ = true;
+        co_await flusher_(buffer_);
+    }
+}
+
+void JsonStream::clear() {
+    buffer_.clear();
+    need_separator_ = false;
+}
+
+void JsonStream::write_separator() {
+    if (need_separator_) {
+        buffer_.append(',');
+    }
+}
+
+void JsonStream::write_raw_value(std::string_view value) {
+    write_separator();
+    buffer_.append(value);
+    need_separator_ = true;
+}
+
+void JsonStream::write_escaped(std::string_view value) {
+    const auto is_special = [](char c) {
+        const auto uc = static_cast<unsigned char>(c);
+        return uc < 0x20 || uc >= 0x80 || c == '"' || c == '\\';
+    };
+    const auto special = std::find_if(value.begin(), value.end(), is_special);
+    if (special == value.end()) {
+        buffer_.append('"');
+        buffer_.append(value);
+        buffer_.append('"');
+        return;
+    }
+    if (std::any_of(special, value.end(), [](char c) { return static_cast<unsigned char>(c) >= 0x80; })) {
+        // Leave UTF-8 validation and replacement of invalid sequences to nlohmann
+        buffer_.append(nlohmann::json(std::string{value}).dump(
+            /*indent=*/-1, /*indent_char=*/' ', /*ensure_ascii=*/false, nlohmann::json::error_handler_t::replace));
+        return;
+    }
+
+    buffer_.append('"');
+    for (const char c : value) {
+        switch (c) {
+            case '"':
+                buffer_.append("\\\"");
+                break;
+            case '\\':
+                buffer_.append("\\\\");
+                break;
+            case '\b':
+                buffer_.append("\\b");
+                break;
+            case '\f':
+                buffer_.append("\\f");
+                break;
+            case '\n':
+                buffer_.append("\\n");
+                break;
+            case '\r':
+                buffer_.append("\\r");
+                break;
+            case '\t':
+                buffer_.append("\\t");
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    const char escaped[6] = {'\\', 'u', '0', '0', kHexDigits[(c >> 4) & 0x0f], kHexDigits[c & 0x0f]};
+                    buffer_.append(std::string_view{escaped, sizeof(escaped)});
+                } else {
+                    buffer_.append(c);
+                }
+                break;
+        }
+    }
+    buffer_.append('"');
+}
+
+void write_json(JsonStream& stream, const Block& block) {
+    const auto& header = block.block.header;
+
+    stream.open_object();
+    if (header.base_fee_per_gas.has_value()) {
+        stream.write_key("baseFeePerGas");
+        stream.write_quantity(*header.base_fee_per_gas);
+    }
+    stream.write_key("difficulty");
+    stream.write_quantity(silkworm::endian::to_big_compact(header.difficulty));
+    stream.write_key("extraData");
+    stream.write_hex(header.extra_data);
+    stream.write_key("gasLimit");
+    stream.write_quantity(header.gas_limit);
+    stream.write_key("gasUsed");
+    stream.write_quantity(header.gas_used);
+    stream.write_key("hash");
+    stream.write_bytes32(block.hash);
+    stream.write_key("logsBloom");
+    stream.write_hex(full_view(header.logs_bloom));
+    stream.write_key("miner");
+    stream.write_address(header.beneficiary);
+    stream.write_key("mixHash");
+    stream.write_bytes32(header.mix_hash);
+    stream.write_key("nonce");
+    stream.write_hex({header.nonce.data(), header.nonce.size()});
+    stream.write_key("number");
+    stream.write_quantity(header.number);
+    stream.write_key("parentHash");
+    stream.write_bytes32(header.parent_hash);
+    stream.write_key("receiptsRoot");
+    stream.write_bytes32(header.receipts_root);
+    stream.write_key("sha3Uncles");
+    stream.write_bytes32(header.ommers_hash);
+    stream.write_key("size");
+    stream.write_quantity(block.get_block_size());
+    stream.write_key("stateRoot");
+    stream.write_bytes32(header.state_root);
+    stream.write_key("timestamp");
+    stream.write_quantity(header.timestamp);
+    stream.write_key("totalDifficulty");
+    stream.write_quantity(silkworm::endian::to_big_compact(block.total_difficulty));
+    stream.write_key("transactions");
+    stream.open_array();
+    const auto& transactions = block.block.transactions;
+    for (std::size_t i{0}; i < transactions.size(); ++i) {
+        if (block.full_tx) {
+            const auto gas_price = transactions[i].effective_gas_price(header.base_fee_per_gas.value_or(0));
+            write_transaction(stream, transactions[i], {block.hash, header.number, gas_price, i});
+        } else {
+            stream.write_hex(full_view(hash_of_transaction(transactions[i])));
+        }
+    }
+    stream.close_array();
+    stream.write_key("transactionsRoot");
+    stream.write_bytes32(header.transactions_root);
+    stream.write_key("uncles");
+    stream.open_array();
+    for (const auto& ommer : block.block.ommers) {
+        stream.write_bytes32(ommer.hash());
+    }
+    stream.close_array();
+    stream.close_object();
+}
+
+void write_json(JsonStream& stream, const Transaction& transaction) {
+    write_transaction(stream, transaction, {transaction.block_hash, transaction.block_number, transaction.effective_gas_price(), transaction.transaction_index});
+}
+
+void write_json(JsonStream& stream, const Receipt& receipt) {
+    stream.open_object();
+    stream.write_key("blockHash");
+    stream.write_bytes32(receipt.block_hash);
+    stream.write_key("blockNumber");
+    stream.write_quantity(receipt.block_number);
+    stream.write_key("contractAddress");
+    if (receipt.contract_address) {
+        stream.write_address(receipt.contract_address);
+    } else {
+        stream.write_null();
+    }
+    stream.write_key("cumulativeGasUsed");
+    stream.write_quantity(receipt.cumulative_gas_used);
+    stream.write_key("effectiveGasPrice");
+    stream.write_quantity(receipt.effective_gas_price);
+    stream.write_key("from");
+    stream.write_address(receipt.from.value_or(evmc::address{}));
+    stream.write_key("gasUsed");
+    stream.write_quantity(receipt.gas_used);
+    stream.write_key("logs");
+    write_json(stream, receipt.logs);
+    stream.write_key("logsBloom");
+    stream.write_hex(full_view(receipt.bloom));
+    stream.write_key("status");
+    stream.write_quantity(uint64_t{receipt.success ? 1u : 0u});
+    stream.write_key("to");
+    stream.write_address(receipt.to.value_or(evmc::address{}));
+    stream.write_key("transactionHash");
+    stream.write_bytes32(receipt.tx_hash);
+    stream.write_key("transactionIndex");
+    stream.write_quantity(receipt.tx_index);
+    stream.write_key("type");
+    stream.write_quantity(uint64_t{receipt.type ? receipt.type.value() : 0u});
+    stream.close_object();
+}
+
+void write_json(JsonStream& stream, const std::vector<Receipt>& receipts) {
+    stream.open_array();
+    for (const auto& receipt : receipts) {
+        write_json(stream, receipt);
+    }
+    stream.close_array();
+}
+
+void write_json(JsonStream& stream, const Log& log) {
+    stream.open_object();
+    stream.write_key("address");
+    stream.write_address(log.address);
+    stream.write_key("blockHash");
+    stream.write_bytes32(log.block_hash);
+    stream.write_key("blockNumber");
+    stream.write_quantity(log.block_number);
+    stream.write_key("data");
+    stream.write_hex(log.data);
+    stream.write_key("logIndex");
+    stream.write_quantity(log.index);
+    stream.write_key("removed");
+    stream.write_bool(log.removed);
+    stream.write_key("topics");
+    stream.open_array();
+    for (const auto& topic : log.topics) {
+        stream.write_bytes32(topic);
+    }
+    stream.close_array();
+    stream.write_key("transactionHash");
+    stream.write_bytes32(log.tx_hash);
+    stream.write_key("transactionIndex");
+    stream.write_quantity(log.tx_index);
+    stream.close_object();
+}
+
+void write_json(JsonStream& stream, const std::vector<Log>& logs) {
+    stream.open_array();
+    for (const auto& log : logs) {
+        write_json(stream, log);
+    }
+    stream.close_array();
+}
+
+void write_json(JsonStream& stream, const DumpAccounts& dump) {
+    open_json_dump(stream);
+    write_json_dump_accounts(stream, dump.accounts);
+    close_json_dump(stream, dump);
+}
+
+void write_json_content_serialized(JsonStream& stream, uint32_t id, std::string_view result) {
+    write_content_head(stream, id);
+    stream.write_serialized(result);
+    stream.close_object();
+}
+
+void open_json_content(JsonStream& stream, uint32_t id) {
+    write_content_head(stream, id);
+}
+
+void close_json_content(JsonStream& stream) {
+    stream.close_object();
+}
+
+void open_json_dump(JsonStream& stream) {
+    stream.open_object();
+    stream.write_key("accounts");
+    stream.open_object();
+}
+
+void write_json_dump_accounts(JsonStream& stream, const AccountsMap& accounts) {
+    for (const auto& [address, account] : accounts) {
+        write_account(stream, address, account);
+    }
+}
+
+void close_json_dump(JsonStream& stream, const DumpAccounts& dump) {
+    write_dump_tail(stream, dump);
+}
+
+} // namespace silkrpc
@@ -0,0 +1,146 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_JSON_STREAM_HPP_
+#define SILKRPC_JSON_STREAM_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <silkrpc/config.hpp>
+
+#include <asio/awaitable.hpp>
+#include <evmc/evmc.hpp>
+#include <intx/intx.hpp>
+#include <nlohmann/json.hpp>
+#include <silkworm/common/base.hpp>
+
+#include <silkrpc/common/chained_buffer.hpp>
+#include <silkrpc/types/block.hpp>
+#include <silkrpc/types/dump_account.hpp>
+#include <silkrpc/types/log.hpp>
+#include <silkrpc/types/receipt.hpp>
+#include <silkrpc/types/transaction.hpp>
+
+namespace silkrpc {
+
+// JSON writer serializing directly into a ChainedBuffer, without building any intermediate DOM. Object keys must be
+// written in lexicographic order to produce the same output as nlohmann::json::dump.
+class JsonStream {
+public:
+    // Asynchronous consumer of the output written so far, e.g. sending it to the client as an HTTP chunk
+    using Flusher = std::function<asio::awaitable<void>(ChainedBuffer&)>;
+
+    explicit JsonStream(ChainedBuffer& buffer) : buffer_(buffer) {}
+    JsonStream(ChainedBuffer& buffer, Flusher flusher) : buffer_(buffer), flusher_(std::move(flusher)) {}
+
+    JsonStream(const JsonStream&) = delete;
+    JsonStream& operator=(const JsonStream&) = delete;
+
+    void open_object();
+    void close_object();
+    void open_array();
+    void close_array();
+
+    void write_key(std::string_view key);
+
+    void write_string(std::string_view value);
+    void write_hex(silkworm::ByteView bytes);
+    void write_address(const evmc::address& address);
+    void write_bytes32(const evmc::bytes32& bytes32);
+    void write_quantity(uint64_t number);
+    void write_quantity(const intx::uint256& number);
+    void write_quantity(silkworm::ByteView bytes);
+    void write_uint(uint64_t number);
+    void write_bool(bool value);
+    void write_null();
+
+    // Write the DOM as dump would do, replacing invalid UTF-8 sequences
+    void write_json(const nlohmann::json& json);
+
+    // Write a value already serialized as JSON text, e.g. a cached result
+    void write_serialized(std::string_view json);
+
+    // Hand the output over to the flusher, if any, once it exceeds kReplyFlushSize
+    asio::awaitable<void> flush();
+
+    // True once some output has been handed over to the flusher: what is sent cannot be replaced by an error anymore
+    bool flushed() const { return flushed_; }
+
+    // Discard the output not flushed yet, e.g. a partial result to be replaced by an error
+    void clear();
+
+private:
+    void write_separator();
+    void write_raw_value(std::string_view value);
+    void write_escaped(std::string_view value);
+
+    ChainedBuffer& buffer_;
+    Flusher flusher_;
+    bool need_separator_{false};
+    bool flushed_{false};
+};
+
+void write_json(JsonStream& stream, const Block& block);
+void write_json(JsonStream& stream, const Transaction& transaction);
+void write_json(JsonStream& stream, const Receipt& receipt);
+void write_json(JsonStream& stream, const std::vector<Receipt>& receipts);
+void write_json(JsonStream& stream, const Log& log);
+void write_json(JsonStream& stream, const std::vector<Log>& logs);
+void write_json(JsonStream& stream, const DumpAccounts& dump);
+
+// Streaming counterpart of make_json_content
+template <typename T>
+void write_json_content(JsonStream& stream, uint32_t id, const T& result) {
+    stream.open_object();
+    stream.write_key("id");
+    stream.write_uint(id);
+    stream.write_key("jsonrpc");
+    stream.write_string("2.0");
+    stream.write_key("result");
+    write_json(stream, result);
+    stream.close_object();
+}
+
+// Serialize just the result, so that it can be reused for replies to different requests
+template <typename T>
+std::string make_json_result(const T& result) {
+    ChainedBuffer buffer;
+    JsonStream stream{buffer};
+    write_json(stream, result);
+    return buffer.to_string();
+}
+
+// Counterpart of write_json_content for a result already serialized by make_json_result
+void write_json_content_serialized(JsonStream& stream, uint32_t id, std::string_view result);
+
+// Pieces of write_json_content for potentially huge results, written element by element while they are produced so
+// that the stream can be flushed in between: open_json_content writes the members preceding the result
+void open_json_content(JsonStream& stream, uint32_t id);
+void close_json_content(JsonStream& stream);
+
+// Pieces of write_json for DumpAccounts, the accounts being written batch by batch in between
+void open_json_dump(JsonStream& stream);
+void write_json_dump_accounts(JsonStream& stream, const AccountsMap& accounts);
+void close_json_dump(JsonStream& stream, const DumpAccounts& dump);
+
+} // namespace silkrpc
+
+#endif  // SILKRPC_JSON_STREAM_HPP_
@@ -0,0 +1,334 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "stream.hpp"
+
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <asio/co_spawn.hpp>
+#include <asio/detached.hpp>
+#include <asio/io_context.hpp>
+#include <asio/use_future.hpp>
+#include <catch2/catch.hpp>
+#include <evmc/evmc.hpp>
+#include <intx/intx.hpp>
+#include <nlohmann/json.hpp>
+#include <silkworm/common/util.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/json/types.hpp>
+
+namespace silkrpc {
+
+using evmc::literals::operator""_address, evmc::literals::operator""_bytes32;
+using silkworm::kGiga;
+
+// The streamed output must be the same as the DOM serialization
+template <typename T>
+std::string stream_json(const T& value) {
+    ChainedBuffer buffer;
+    JsonStream stream{buffer};
+    write_json(stream, value);
+    return buffer.to_string();
+}
+
+std::string stream_dom(const nlohmann::json& json) {
+    ChainedBuffer buffer;
+    JsonStream stream{buffer};
+    stream.write_json(json);
+    return buffer.to_string();
+}
+
+// Write the content element by element as eth_getLogs does, flushing the stream in between
+asio::awaitable<void> write_logs_flushed(JsonStream& stream, uint32_t id, const std::vector<Log>& logs) {
+    open_json_content(stream, id);
+    stream.open_array();
+    for (const auto& log : logs) {
+        write_json(stream, log);
+        co_await stream.flush();
+    }
+    stream.close_array();
+    close_json_content(stream);
+}
+
+TEST_CASE("stream quantities", "[silkrpc][json][stream]") {
+    ChainedBuffer buffer;
+    JsonStream stream{buffer};
+    stream.open_array();
+    stream.write_quantity(uint64_t{0});
+    stream.write_quantity(uint64_t{4206337});
+    stream.write_quantity(intx::uint256{0});
+    stream.write_quantity(intx::uint256{100});
+    stream.write_quantity(silkworm::ByteView{});
+    stream.write_quantity(*silkworm::from_hex("000f10"));
+    stream.close_array();
+    CHECK(buffer.to_string() == R"(["0x0","0x402f01","0x0","0x64","0x","0xf10"])");
+}
+
+TEST_CASE("stream DOM", "[silkrpc][json][stream]") {
+    SECTION("scalars") {
+        CHECK(stream_dom(nullptr) == "null");
+        CHECK(stream_dom(true) == "true");
+        CHECK(stream_dom(-32601) == "-32601");
+        CHECK(stream_dom(uint64_t{18446744073709551615u}) == "18446744073709551615");
+        CHECK(stream_dom(1.5) == nlohmann::json(1.5).dump());
+    }
+
+    SECTION("escaped strings") {
+        const nlohmann::json json = std::string{"quote\" backslash\\ newline\n tab\t bell\x07 del\x7f"};
+        CHECK(stream_dom(json) == json.dump());
+    }
+
+    SECTION("UTF-8 strings") {
+        const nlohmann::json valid = "caf\xc3\xa9\n";
+        CHECK(stream_dom(valid) == valid.dump());
+        const nlohmann::json invalid = "invalid \xff";
+        CHECK(stream_dom(invalid) == invalid.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace));
+    }
+
+    SECTION("nested containers") {
+        const auto json = R"({"jsonrpc":"2.0","id":1,"result":{"a":[1,{"b":null},[]],"c":{}}})"_json;
+        CHECK(stream_dom(json) == json.dump());
+    }
+
+    SECTION("error") {
+        const auto json = make_json_error(3, -32601, "method not existent or not implemented");
+        CHECK(stream_dom(json) == json.dump());
+    }
+}
+
+TEST_CASE("stream log", "[silkrpc][json][stream]") {
+    Log log{
+        0x0715a7794a1dc8e42615f059dd6e406a6594651a_address,
+        {0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32},
+        *silkworm::from_hex("001122aabbcc"),
+        4206337,
+        0xb02a3b0ee16c858afaa34bcd6770b3c20ee56aa2f75858733eb0e927b5b7126f_bytes32,
+        3,
+        0x22ea9f6b28db76a7162054c05ed812deb2f519cd00000000000000000000000a_bytes32,
+        12,
+        false
+    };
+    CHECK(stream_json(log) == nlohmann::json(log).dump());
+    CHECK(stream_json(std::vector<Log>{}) == "[]");
+    CHECK(stream_json(std::vector<Log>{log, log}) == nlohmann::json(std::vector<Log>{log, log}).dump());
+}
+
+TEST_CASE("stream receipt", "[silkrpc][json][stream]") {
+    Receipt receipt{
+        true,
+        454647,
+        silkworm::Bloom{},
+        Logs{Log{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address}},
+        0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32,
+        0x0715a7794a1dc8e42615f059dd6e406a6594651a_address,
+        10,
+        0xb02a3b0ee16c858afaa34bcd6770b3c20ee56aa2f75858733eb0e927b5b7126f_bytes32,
+        5000000,
+        3,
+        0x22ea9f6b28db76a7162054c05ed812deb2f519cd_address,
+        0x22ea9f6b28db76a7162054c05ed812deb2f519cd_address,
+        1,
+        2000000000
+    };
+    CHECK(stream_json(receipt) == nlohmann::json(receipt).dump());
+
+    SECTION("receipts") {
+        CHECK(stream_json(Receipts{receipt, receipt}) == nlohmann::json(Receipts{receipt, receipt}).dump());
+    }
+
+    SECTION("without contract address") {
+        receipt.contract_address = evmc::address{};
+        receipt.type = std::nullopt;
+        CHECK(stream_json(receipt) == nlohmann::json(receipt).dump());
+    }
+}
+
+TEST_CASE("stream transaction", "[silkrpc][json][stream]") {
+    silkrpc::Transaction transaction{};
+    transaction.type = silkworm::Transaction::Type::kEip1559;
+    transaction.max_priority_fee_per_gas = 50'000 * kGiga;
+    transaction.max_fee_per_gas = 50'000 * kGiga;
+    transaction.gas_limit = 21'000;
+    transaction.to = 0x5df9b87991262f6ba471f09758cde1c0fc1de734_address;
+    transaction.value = 31337;
+    transaction.data = *silkworm::from_hex("001122aabbcc");
+    transaction.odd_y_parity = true;
+    transaction.chain_id = intx::uint256{1};
+    transaction.r = intx::from_string<intx::uint256>("0x88ff6cf0fefd94db46111149ae4bfc179e9b94721fffd821d38d16464b3f71d0");
+    transaction.s = intx::from_string<intx::uint256>("0x45e0aff800961cfce805daef7016b9b675c137a6a41a548f7b60a3484c06a33a");
+    transaction.access_list = {
+        {0xde0b295669a9fd93d5f28d9ec85e40f4cb697bae_address, {0x0000000000000000000000000000000000000000000000000000000000000003_bytes32}},
+    };
+    transaction.from = 0x007fb8417eb9ad4d958b050fc3720d5b46a2c053_address;
+    transaction.block_hash = 0x374f3a049e006f36f6cf91b02a3b0ee16c858af2f75858733eb0e927b5b7126c_bytes32;
+    transaction.block_number = 123123;
+    transaction.block_base_fee_per_gas = intx::uint256{12};
+    transaction.transaction_index = 3;
+    CHECK(stream_json(transaction) == nlohmann::json(transaction).dump());
+
+    SECTION("legacy contract creation") {
+        transaction.type = silkworm::Transaction::Type::kLegacy;
+        transaction.to = std::nullopt;
+        transaction.access_list.clear();
+        transaction.chain_id = std::nullopt;
+        CHECK(stream_json(transaction) == nlohmann::json(transaction).dump());
+    }
+}
+
+TEST_CASE("stream block", "[silkrpc][json][stream]") {
+    silkrpc::Block block{};
+    CHECK(stream_json(block) == nlohmann::json(block).dump());
+
+    silkworm::Transaction transaction{};
+    transaction.type = silkworm::Transaction::Type::kLegacy;
+    transaction.nonce = 7;
+    transaction.gas_limit = 21'000;
+    transaction.max_priority_fee_per_gas = 10 * kGiga;
+    transaction.max_fee_per_gas = 10 * kGiga;
+    transaction.to = 0x5df9b87991262f6ba471f09758cde1c0fc1de734_address;
+    transaction.value = 31337;
+    transaction.r = intx::uint256{18};
+    transaction.s = intx::uint256{36};
+    transaction.from = 0x007fb8417eb9ad4d958b050fc3720d5b46a2c053_address;
+    block.block.transactions = {transaction, transaction};
+    block.block.ommers.resize(1);
+    block.block.header.number = 5;
+    block.block.header.difficulty = 17171480576;
+    block.block.header.base_fee_per_gas = intx::uint256{7};
+    block.block.header.extra_data = *silkworm::from_hex("d88301091a846765746888676f312e31352e36856c696e7578");
+    block.hash = 0xb02a3b0ee16c858afaa34bcd6770b3c20ee56aa2f75858733eb0e927b5b7126f_bytes32;
+    block.total_difficulty = 34342961152;
+
+    SECTION("transaction hashes") {
+        CHECK(stream_json(block) == nlohmann::json(block).dump());
+    }
+
+    SECTION("full transactions") {
+        block.full_tx = true;
+        CHECK(stream_json(block) == nlohmann::json(block).dump());
+    }
+}
+
+TEST_CASE("stream dump accounts", "[silkrpc][json][stream]") {
+    DumpAccounts dump{};
+    CHECK(stream_json(dump) == nlohmann::json(dump).dump());
+
+    dump.root = 0xb10e2d527612073b26eecdfd717e6a320cf44b4afac2b0732d9fcbe2b7fa0cf6_bytes32;
+    dump.next = 0x79a4d418f7887dd4d5123a41b6c8c186686ae8cb_address;
+    DumpAccount account{10, 1, 0, 0x5df9b87991262f6ba471f09758cde1c0fc1de734000000000000000000000000_bytes32};
+    account.code = *silkworm::from_hex("600160");
+    account.storage = Storage{{0x0000000000000000000000000000000000000000000000000000000000000001_bytes32, *silkworm::from_hex("2a")}};
+    dump.accounts.emplace(0x79a4d418f7887dd4d5123a41b6c8c186686ae8cb_address, account);
+    dump.accounts.emplace(0x0715a7794a1dc8e42615f059dd6e406a6594651a_address, DumpAccount{});
+    CHECK(stream_json(dump) == nlohmann::json(dump).dump());
+
+    SECTION("batch by batch") {
+        ChainedBuffer buffer;
+        JsonStream stream{buffer};
+        open_json_dump(stream);
+        for (const auto& [address, account] : dump.accounts) {
+            write_json_dump_accounts(stream, AccountsMap{{address, account}});
+        }
+        close_json_dump(stream, dump);
+        CHECK(buffer.to_string() == nlohmann::json(dump).dump());
+    }
+}
+
+TEST_CASE("stream json content", "[silkrpc][json][stream]") {
+    ChainedBuffer buffer;
+    JsonStream stream{buffer};
+    write_json_content(stream, 7, std::vector<Log>{});
+    CHECK(buffer.to_string() == make_json_content(7, std::vector<Log>{}).dump());
+}
+
+TEST_CASE("stream serialized json content", "[silkrpc][json][stream]") {
+    Log log{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address, {}, silkworm::Bytes{0x12, 0x34}};
+    const auto result = make_json_result(std::vector<Log>{log});
+    CHECK(result == nlohmann::json(std::vector<Log>{log}).dump());
+
+    ChainedBuffer buffer;
+    JsonStream stream{buffer};
+    write_json_content_serialized(stream, 7, result);
+    CHECK(buffer.to_string() == make_json_content(7, std::vector<Log>{log}).dump());
+}
+
+TEST_CASE("stream cleared", "[silkrpc][json][stream]") {
+    ChainedBuffer buffer;
+    JsonStream stream{buffer};
+    open_json_content(stream, 7);
+    stream.open_array();
+    write_json(stream, Log{});
+    stream.clear();
+    stream.write_json(make_json_error(7, 100, "error"));
+    CHECK(buffer.to_string() == make_json_error(7, 100, "error").dump());
+}
+
+TEST_CASE("stream flushed json content", "[silkrpc][json][stream]") {
+    asio::io_context io_context;
+    std::string flushed;
+    std::size_t num_flushes{0};
+    ChainedBuffer buffer;
+    JsonStream stream{buffer, [&](ChainedBuffer& content) -> asio::awaitable<void> {
+        flushed += content.to_string();
+        content.clear();
+        ++num_flushes;
+        co_return;
+    }};
+
+    const std::vector<Log> logs(1000, Log{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address, {}, silkworm::Bytes(100, 0xab)});
+    asio::co_spawn(io_context, write_logs_flushed(stream, 7, logs), asio::detached);
+    io_context.run();
+    CHECK(num_flushes > 1);
+    CHECK(buffer.size() < kReplyFlushSize);
+    CHECK(flushed + buffer.to_string() == make_json_content(7, logs).dump());
+    CHECK(stream.flushed());
+}
+
+TEST_CASE("stream flushed json content aborted", "[silkrpc][json][stream]") {
+    asio::io_context io_context;
+    std::size_t num_flushes{0};
+    ChainedBuffer buffer;
+    JsonStream stream{buffer, [&](ChainedBuffer& content) -> asio::awaitable<void> {
+        if (++num_flushes > 1) {
+            throw std::system_error{std::make_error_code(std::errc::broken_pipe)};
+        }
+        content.clear();
+        co_return;
+    }};
+
+    SECTION("small content is not flushed") {
+        const std::vector<Log> logs(1, Log{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address, {}, silkworm::Bytes(100, 0xab)});
+        auto result{asio::co_spawn(io_context, write_logs_flushed(stream, 7, logs), asio::use_future)};
+        io_context.run();
+        CHECK_NOTHROW(result.get());
+        CHECK(!stream.flushed());
+        CHECK(buffer.to_string() == make_json_content(7, logs).dump());
+    }
+
+    SECTION("failed flush is propagated after the first chunk") {
+        const std::vector<Log> logs(1000, Log{0x0715a7794a1dc8e42615f059dd6e406a6594651a_address, {}, silkworm::Bytes(100, 0xab)});
+        auto result{asio::co_spawn(io_context, write_logs_flushed(stream, 7, logs), asio::use_future)};
+        io_context.run();
+        CHECK_THROWS_AS(result.get(), std::system_error);
+        CHECK(num_flushes == 2);
+        CHECK(stream.flushed());
+    }
+}
+
+} // namespace silkrpc
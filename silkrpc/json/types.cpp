@@ -543,4 +543,8 @@ nlohmann::json make_json_error(uint32_t id, const RevertError& error) {
     return {{"jsonrpc", "2.0"}, {"id", id}, {"error", error}};
 }
 
+nlohmann::json make_json_notification(const std::string& subscription_id, const nlohmann::json& result) {
+    return {{"jsonrpc", "2.0"}, {"method", "eth_subscription"}, {"params", {{"subscription", subscription_id}, {"result", result}}}};
+}
+
 } // namespace silkrpc
@@ -105,6 +105,8 @@ nlohmann::json make_json_content(uint32_t id, const nlohmann::json& result);
 nlohmann::json make_json_error(uint32_t id, int32_t code, const std::string& message);
 nlohmann::json make_json_error(uint32_t id, const RevertError& error);
 
+nlohmann::json make_json_notification(const std::string& subscription_id, const nlohmann::json& result);
+
 } // namespace silkrpc
 
 namespace nlohmann {
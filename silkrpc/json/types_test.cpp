@@ -1454,4 +1454,13 @@ TEST_CASE("make json revert error", "[silkrpc::json][make_json_error]") {
     })"_json);
 }
 
+TEST_CASE("make json notification", "[silkrpc::json][make_json_notification]") {
+    const auto j = silkrpc::make_json_notification("0x1", "0x2b3c");
+    CHECK(j == R"({
+        "jsonrpc":"2.0",
+        "method":"eth_subscription",
+        "params":{"subscription":"0x1","result":"0x2b3c"}
+    })"_json);
+}
+
 } // namespace silkrpc
@@ -17,10 +17,14 @@
 #include <silkrpc/config.hpp>
 
 #include <cxxabi.h>
+#include <chrono>
 #include <exception>
 #include <filesystem>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 #include <absl/flags/flag.h>
 #include <absl/flags/parse.h>
@@ -31,11 +35,12 @@
 #include <asio/awaitable.hpp>
 #include <asio/co_spawn.hpp>
 #include <asio/signal_set.hpp>
-#include <asio/thread_pool.hpp>
 #include <boost/process/environment.hpp>
 #include <grpcpp/grpcpp.h>
 
 #include <silkrpc/context_pool.hpp>
+#include <silkrpc/commands/worker_pools.hpp>
+#include <silkrpc/common/affinity.hpp>
 #include <silkrpc/common/constants.hpp>
 #include <silkrpc/common/log.hpp>
 #include <silkrpc/http/server.hpp>
@@ -47,9 +52,26 @@ ABSL_FLAG(std::string, eth1_local, silkrpc::kDefaultEth1Local, "Ethereum JSON RP
 ABSL_FLAG(std::string, eth2_local, silkrpc::kDefaultEth2Local, "Engine JSON RPC API local end-point as string <address>:<port>");
 ABSL_FLAG(std::string, target, silkrpc::kDefaultTarget, "Erigon Core gRPC service location as string <address>:<port>");
 ABSL_FLAG(std::string, api_spec, silkrpc::kDefaultEth1ApiSpec, "JSON RPC API namespaces as comma-separated list of strings");
+ABSL_FLAG(std::string, ipc_path, "", "Ethereum JSON RPC API Unix domain socket path as string (newline-delimited JSON, disabled if empty)");
 ABSL_FLAG(uint32_t, numContexts, std::thread::hardware_concurrency() / 2, "number of running I/O contexts as 32-bit integer");
+ABSL_FLAG(std::string, contextCpus, "", "CPUs shared out among the I/O contexts to pin their threads as list <cpu>|<first>-<last>[,...] (no affinity if empty)");
+ABSL_FLAG(std::string, workerCpus, "", "CPUs to pin the worker threads as list <cpu>|<first>-<last>[,...] (contextCpus if empty)");
+ABSL_FLAG(uint32_t, numEngineContexts, 1, "number of I/O contexts dedicated to the Engine JSON RPC API as 32-bit integer (0 means shared with Ethereum API)");
+ABSL_FLAG(std::string, engineCpus, "", "CPUs shared out among the Engine API I/O contexts to pin their threads as list <cpu>|<first>-<last>[,...] (no affinity if empty)");
+ABSL_FLAG(bool, singleThreadContexts, false, "run each I/O context and its gRPC completion queue on the same thread as boolean");
 ABSL_FLAG(uint32_t, numWorkers, 16, "number of worker threads as 32-bit integer");
-ABSL_FLAG(uint32_t, timeout, silkrpc::kDefaultTimeout.count(), "gRPC call timeout as 32-bit integer");
+ABSL_FLAG(uint32_t, maxWorkers, 0, "maximum number of worker threads the pool can grow to as 32-bit integer (numWorkers if lower)");
+ABSL_FLAG(std::string, workerPools, "", "additional worker pools as comma-separated list of <name>:<threads>|<min>-<max>[:<max queued>]");
+ABSL_FLAG(std::string, workerPoolRoutes, "", "worker pools running the methods as comma-separated list of <method|namespace>:<pool>");
+ABSL_FLAG(std::string, concurrencyLimits, "", "Ethereum JSON RPC API concurrency limits as comma-separated list of <method|namespace>:<max running>[:<max queued>]");
+ABSL_FLAG(std::string, contextSelection, "round_robin", "policy choosing the I/O context of new connections as string: round_robin, least_loaded or power_of_two");
+ABSL_FLAG(bool, reusePort, false, "one SO_REUSEPORT acceptor per I/O context as boolean");
+ABSL_FLAG(uint32_t, maxConnections, silkrpc::kDefaultMaxConnections, "maximum number of open connections per end-point as 32-bit integer (0 means no limit)");
+ABSL_FLAG(uint32_t, idleTimeout, silkrpc::kDefaultIdleTimeout.count(), "idle connection timeout in milliseconds as 32-bit integer (0 means no timeout)");
+ABSL_FLAG(uint32_t, readTimeout, silkrpc::kDefaultReadTimeout.count(), "partial request read timeout in milliseconds as 32-bit integer (0 means no timeout)");
+ABSL_FLAG(uint32_t, writeTimeout, silkrpc::kDefaultWriteTimeout.count(), "reply write timeout in milliseconds as 32-bit integer (0 means no timeout)");
+ABSL_FLAG(uint32_t, pooledKvTransactions, 0, "idle Erigon KV transactions kept open for reuse per I/O context as 32-bit integer (0 means no reuse)");
+ABSL_FLAG(uint32_t, timeout, silkrpc::kDefaultTimeout.count(), "request deadline in milliseconds for Erigon KV transactions as 32-bit integer (0 means no deadline)");
 ABSL_FLAG(silkrpc::LogLevel, logLevel, silkrpc::LogLevel::Critical, "logging level");
 
 const char* currentExceptionTypeName() {
@@ -148,6 +170,31 @@ int main(int argc, char* argv[]) {
             return -1;
         }
 
+        silkrpc::ContextSelection context_selection;
+        try {
+            context_selection = silkrpc::parse_context_selection(absl::GetFlag(FLAGS_contextSelection));
+        } catch (const std::invalid_argument&) {
+            SILKRPC_ERROR << "Parameter contextSelection is invalid: [" << absl::GetFlag(FLAGS_contextSelection) << "]\n";
+            SILKRPC_ERROR << "Use --contextSelection flag to specify one of round_robin, least_loaded or power_of_two\n";
+            return -1;
+        }
+
+        std::vector<std::size_t> context_cpus;
+        std::vector<std::size_t> worker_cpus;
+        std::vector<std::size_t> engine_cpus;
+        try {
+            context_cpus = silkrpc::parse_cpu_list(absl::GetFlag(FLAGS_contextCpus));
+            worker_cpus = silkrpc::parse_cpu_list(absl::GetFlag(FLAGS_workerCpus));
+            engine_cpus = silkrpc::parse_cpu_list(absl::GetFlag(FLAGS_engineCpus));
+        } catch (const std::invalid_argument& e) {
+            SILKRPC_ERROR << "Parameter contextCpus, workerCpus or engineCpus is invalid: " << e.what() << "\n";
+            SILKRPC_ERROR << "Use --contextCpus, --workerCpus and --engineCpus flags to specify CPU lists like 0-7,16-23\n";
+            return -1;
+        }
+        if (worker_cpus.empty()) {
+            worker_cpus = context_cpus;
+        }
+
         auto numWorkers{absl::GetFlag(FLAGS_numWorkers)};
         if (numWorkers < 0) {
             SILKRPC_ERROR << "Parameter numWorkers is invalid: [" << numWorkers << "]\n";
@@ -190,11 +237,44 @@ int main(int argc, char* argv[]) {
         SILKRPC_LOG << txpool_protocol_check.result << "\n";
 
         // TODO(canepat): handle also local (shared-memory) database
-        silkrpc::ContextPool context_pool{numContexts, create_channel};
-        asio::thread_pool worker_pool{numWorkers};
-
-        silkrpc::http::Server eth_rpc_service{eth1_local, api_spec, context_pool, worker_pool};
-        silkrpc::http::Server engine_rpc_service{eth2_local, kDefaultEth2ApiSpec, context_pool, worker_pool};
+        const auto single_thread_contexts{absl::GetFlag(FLAGS_singleThreadContexts)};
+        const auto pooled_kv_transactions{absl::GetFlag(FLAGS_pooledKvTransactions)};
+        silkrpc::ContextPool context_pool{numContexts, create_channel, std::chrono::milliseconds{timeout}, context_selection, single_thread_contexts,
+            pooled_kv_transactions};
+        context_pool.set_name("eth");
+        context_pool.set_cpu_affinity(context_cpus);
+
+        // Engine API calls from the consensus client must not queue behind Ethereum API traffic, neither on the I/O contexts
+        // nor on the gRPC connection: a local subchannel pool gives the engine channel its own connection to Erigon Core
+        std::unique_ptr<silkrpc::ContextPool> engine_context_pool;
+        const auto num_engine_contexts{absl::GetFlag(FLAGS_numEngineContexts)};
+        if (num_engine_contexts > 0) {
+            silkrpc::ChannelFactory create_engine_channel = [&]() {
+                grpc::ChannelArguments channel_args;
+                channel_args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+                return grpc::CreateCustomChannel(target, grpc::InsecureChannelCredentials(), channel_args);
+            };
+            engine_context_pool = std::make_unique<silkrpc::ContextPool>(num_engine_contexts, create_engine_channel,
+                std::chrono::milliseconds{timeout}, silkrpc::ContextSelection::kRoundRobin, single_thread_contexts);
+            engine_context_pool->set_name("engine");
+            engine_context_pool->set_cpu_affinity(engine_cpus);
+        }
+        auto& engine_pool = engine_context_pool ? *engine_context_pool : context_pool;
+        silkrpc::commands::WorkerPools worker_pools{numWorkers, absl::GetFlag(FLAGS_maxWorkers), absl::GetFlag(FLAGS_workerPools),
+            absl::GetFlag(FLAGS_workerPoolRoutes), worker_cpus};
+
+        const auto reuse_port{absl::GetFlag(FLAGS_reusePort)};
+        const auto concurrency_limits{absl::GetFlag(FLAGS_concurrencyLimits)};
+        const auto ipc_path{absl::GetFlag(FLAGS_ipc_path)};
+        silkrpc::http::ConnectionLimits connection_limits;
+        connection_limits.max_connections = absl::GetFlag(FLAGS_maxConnections);
+        connection_limits.idle_timeout = std::chrono::milliseconds{absl::GetFlag(FLAGS_idleTimeout)};
+        connection_limits.read_timeout = std::chrono::milliseconds{absl::GetFlag(FLAGS_readTimeout)};
+        connection_limits.write_timeout = std::chrono::milliseconds{absl::GetFlag(FLAGS_writeTimeout)};
+        silkrpc::http::Server eth_rpc_service{eth1_local, api_spec, context_pool, worker_pools, reuse_port, concurrency_limits, ipc_path,
+            connection_limits};
+        silkrpc::http::Server engine_rpc_service{eth2_local, kDefaultEth2ApiSpec, engine_pool, worker_pools, reuse_port, "", "",
+            connection_limits};
 
         auto& io_context = context_pool.get_io_context();
         asio::signal_set signals{io_context, SIGINT, SIGTERM};
@@ -203,6 +283,9 @@ int main(int argc, char* argv[]) {
             std::cout << "\n";
             SILKRPC_INFO << "Signal caught, error: " << error.what() << " number: " << signal_number << "\n" << std::flush;
             context_pool.stop();
+            if (engine_context_pool) {
+                engine_context_pool->stop();
+            }
             eth_rpc_service.stop();
             engine_rpc_service.stop();
         });
@@ -215,7 +298,16 @@ int main(int argc, char* argv[]) {
 
         SILKRPC_LOG << "Silkrpc is now running [pid=" << pid << ", main thread=" << tid << "]\n";
 
+        std::thread engine_context_pool_thread;
+        if (engine_context_pool) {
+            engine_context_pool_thread = std::thread{[&]() { engine_context_pool->run(); }};
+        }
+
         context_pool.run();
+
+        if (engine_context_pool_thread.joinable()) {
+            engine_context_pool_thread.join();
+        }
     } catch (const std::exception& e) {
         SILKRPC_CRIT << "Exception: " << e.what() << "\n" << std::flush;
     } catch (...) {
@@ -0,0 +1,326 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "subscription_manager.hpp"
+
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <asio/co_spawn.hpp>
+#include <asio/detached.hpp>
+#include <boost/endian/conversion.hpp>
+#include <silkworm/common/util.hpp>
+#include <silkworm/rlp/decode.hpp>
+#include <silkworm/types/block.hpp>
+
+#include <silkrpc/common/constants.hpp>
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/common/util.hpp>
+#include <silkrpc/core/logs.hpp>
+#include <silkrpc/core/rawdb/chain.hpp>
+#include <silkrpc/ethdb/transaction_database.hpp>
+#include <silkrpc/grpc/util.hpp>
+#include <silkrpc/json/types.hpp>
+
+namespace silkrpc::subscriptions {
+
+namespace {
+
+evmc::bytes32 bytes32_from_H256(const ::types::H256& h256) {
+    evmc::bytes32 bytes32;
+    boost::endian::store_big_u64(bytes32.bytes, h256.hi().hi());
+    boost::endian::store_big_u64(bytes32.bytes + 8, h256.hi().lo());
+    boost::endian::store_big_u64(bytes32.bytes + 16, h256.lo().hi());
+    boost::endian::store_big_u64(bytes32.bytes + 24, h256.lo().lo());
+    return bytes32;
+}
+
+evmc::bytes32 hash_of_rlp(const std::string& rlp) {
+    const auto hash{hash_of(silkworm::byte_view_of_string(rlp))};
+    return silkworm::to_bytes32({hash.bytes, silkworm::kHashLength});
+}
+
+// Visit the subscriptions existing when called. Handlers may (un)subscribe, so the next one is looked up again after
+// each visit and the current one is kept alive meanwhile
+template <typename Subscription, typename Visitor>
+void for_each_subscription(const std::map<SubscriptionId, std::shared_ptr<Subscription>>& subscriptions, Visitor visitor) {
+    if (subscriptions.empty()) {
+        return;
+    }
+    const auto last_id = subscriptions.rbegin()->first;
+    auto it = subscriptions.begin();
+    while (it != subscriptions.end() && it->first <= last_id) {
+        const auto [id, subscription] = *it;
+        visitor(id, *subscription);
+        it = subscriptions.upper_bound(id);
+    }
+}
+
+void notify(const std::map<SubscriptionId, std::shared_ptr<NotificationHandler>>& subscriptions, const nlohmann::json& result) {
+    for_each_subscription(subscriptions, [&](SubscriptionId id, const NotificationHandler& handler) {
+        handler(make_json_notification(to_subscription_id(id), result));
+    });
+}
+
+} // namespace
+
+std::string to_subscription_id(SubscriptionId id) {
+    return to_quantity(id);
+}
+
+std::optional<SubscriptionId> from_subscription_id(const std::string& id) {
+    if (id.size() < 3 || id.size() > 18 || id[0] != '0' || (id[1] != 'x' && id[1] != 'X')) {
+        return std::nullopt;
+    }
+    SubscriptionId subscription_id{0};
+    for (std::size_t i{2}; i < id.size(); ++i) {
+        const auto c = id[i];
+        uint8_t digit{0};
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint8_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint8_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint8_t>(c - 'A' + 10);
+        } else {
+            return std::nullopt;
+        }
+        subscription_id = (subscription_id << 4) | digit;
+    }
+    return subscription_id;
+}
+
+SubscriptionManager::SubscriptionManager(asio::io_context& io_context,
+    std::unique_ptr<::remote::ETHBACKEND::StubInterface> backend_stub,
+    std::unique_ptr<::remote::KV::StubInterface> kv_stub,
+    std::unique_ptr<::txpool::Txpool::StubInterface> txpool_stub,
+    grpc::CompletionQueue* queue,
+    ethdb::Database& database)
+    : io_context_(io_context), backend_stub_(std::move(backend_stub)), kv_stub_(std::move(kv_stub)), txpool_stub_(std::move(txpool_stub)),
+      queue_(queue), database_(database), headers_{io_context}, state_changes_{io_context}, pending_transactions_{io_context},
+      pending_logs_{std::make_shared<PendingLogs>()} {
+    SILKRPC_TRACE << "SubscriptionManager::ctor " << this << "\n";
+}
+
+SubscriptionManager::~SubscriptionManager() {
+    SILKRPC_TRACE << "SubscriptionManager::dtor " << this << "\n";
+    stopping_ = true;
+    pending_logs_->stopped = true;
+    pending_logs_->blocks.clear();
+    stop_upstream(headers_);
+    stop_upstream(state_changes_);
+    stop_upstream(pending_transactions_);
+}
+
+SubscriptionId SubscriptionManager::subscribe_new_heads(NotificationHandler handler) {
+    const auto id = next_id_++;
+    new_heads_.emplace(id, std::make_shared<NotificationHandler>(std::move(handler)));
+    SILKRPC_DEBUG << "SubscriptionManager::subscribe_new_heads id: " << id << " #subscriptions: " << new_heads_.size() << "\n";
+    start_headers();
+    return id;
+}
+
+SubscriptionId SubscriptionManager::subscribe_logs(const Filter& filter, NotificationHandler handler) {
+    const auto id = next_id_++;
+    logs_.emplace(id, std::make_shared<LogsSubscription>(LogsSubscription{filter, std::move(handler)}));
+    SILKRPC_DEBUG << "SubscriptionManager::subscribe_logs id: " << id << " filter: " << filter << " #subscriptions: " << logs_.size() << "\n";
+    start_state_changes();
+    return id;
+}
+
+SubscriptionId SubscriptionManager::subscribe_new_pending_transactions(NotificationHandler handler) {
+    const auto id = next_id_++;
+    new_pending_transactions_.emplace(id, std::make_shared<NotificationHandler>(std::move(handler)));
+    SILKRPC_DEBUG << "SubscriptionManager::subscribe_new_pending_transactions id: " << id << " #subscriptions: " << new_pending_transactions_.size() << "\n";
+    start_pending_transactions();
+    return id;
+}
+
+bool SubscriptionManager::unsubscribe(SubscriptionId id) {
+    SILKRPC_DEBUG << "SubscriptionManager::unsubscribe id: " << id << "\n";
+    if (new_heads_.erase(id) > 0) {
+        if (new_heads_.empty() && !rotating_on_new_heads_) {
+            stop_upstream(headers_);
+        }
+        return true;
+    }
+    if (logs_.erase(id) > 0) {
+        if (logs_.empty()) {
+            stop_upstream(state_changes_);
+        }
+        return true;
+    }
+    if (new_pending_transactions_.erase(id) > 0) {
+        if (new_pending_transactions_.empty()) {
+            stop_upstream(pending_transactions_);
+        }
+        return true;
+    }
+    return false;
+}
+
+void SubscriptionManager::rotate_on_new_heads() {
+    rotating_on_new_heads_ = true;
+    start_headers();
+}
+
+template<typename Client, typename StubInterface, typename Request, typename Reply>
+void SubscriptionManager::start_upstream(Upstream<Client>& upstream, std::unique_ptr<StubInterface>& stub, const Request& request,
+    void (SubscriptionManager::*on_reply)(const Reply&), std::function<bool()> is_needed) {
+    if (upstream.client && upstream.client->is_active()) {
+        return;
+    }
+    upstream.client = std::make_unique<Client>(stub, queue_);
+    upstream.client->async_call(request, [this, on_reply](const Reply& reply) {
+        (this->*on_reply)(reply);
+    },
+    [this, &upstream, &stub, request, on_reply, is_needed](const grpc::Status& status) {
+        SILKRPC_DEBUG << "SubscriptionManager upstream " << upstream.client.get() << " ended " << status << "\n";
+        if (stopping_ || !is_needed()) {
+            return;
+        }
+        // Subscribers are still there, so reconnect after some delay
+        upstream.retry_timer.expires_after(kSubscriptionRetryDelay);
+        upstream.retry_timer.async_wait([this, &upstream, &stub, request, on_reply, is_needed](const asio::error_code& ec) {
+            if (ec == asio::error::operation_aborted || stopping_ || !is_needed()) {
+                return;
+            }
+            start_upstream(upstream, stub, request, on_reply, is_needed);
+        });
+    });
+}
+
+template<typename Client>
+void SubscriptionManager::stop_upstream(Upstream<Client>& upstream) {
+    upstream.retry_timer.cancel();
+    if (upstream.client && upstream.client->is_active()) {
+        upstream.client->cancel();
+    }
+}
+
+void SubscriptionManager::start_headers() {
+    ::remote::SubscribeRequest request;
+    request.set_type(::remote::Event::HEADER);
+    start_upstream(headers_, backend_stub_, request, &SubscriptionManager::on_header, [this]() { return rotating_on_new_heads_ || !new_heads_.empty(); });
+}
+
+void SubscriptionManager::start_state_changes() {
+    ::remote::StateChangeRequest request;
+    request.set_withstorage(false);
+    request.set_withtransactions(false);
+    start_upstream(state_changes_, kv_stub_, request, &SubscriptionManager::on_state_changes, [this]() { return !logs_.empty(); });
+}
+
+void SubscriptionManager::start_pending_transactions() {
+    ::txpool::OnAddRequest request;
+    start_upstream(pending_transactions_, txpool_stub_, request, &SubscriptionManager::on_pending_transactions,
+        [this]() { return !new_pending_transactions_.empty(); });
+}
+
+void SubscriptionManager::on_header(const ::remote::SubscribeReply& reply) {
+    if (reply.type() != ::remote::Event::HEADER) {
+        return;
+    }
+    // No pooled transaction must serve the previous head to the clients notified of this one
+    const auto header_hash{hash_of_rlp(reply.data())};
+    database_.rotate(header_hash);
+    if (new_heads_.empty()) {
+        return;
+    }
+    silkworm::ByteView header_rlp{silkworm::byte_view_of_string(reply.data())};
+    silkworm::BlockHeader header;
+    const auto error = silkworm::rlp::decode(header_rlp, header);
+    if (error != silkworm::rlp::DecodingResult::kOk) {
+        SILKRPC_ERROR << "SubscriptionManager::on_header invalid RLP decoding for block header\n";
+        return;
+    }
+    nlohmann::json result = header;
+    result["hash"] = header_hash;
+    SILKRPC_DEBUG << "SubscriptionManager::on_header number: " << header.number << " #subscriptions: " << new_heads_.size() << "\n";
+    notify(new_heads_, result);
+}
+
+void SubscriptionManager::on_state_changes(const ::remote::StateChangeBatch& batch) {
+    for (const auto& change : batch.changebatch()) {
+        // Logs of unwound blocks are already gone, so they cannot be notified as removed
+        if (change.direction() != ::remote::Direction::FORWARD) {
+            continue;
+        }
+        const auto block_hash{bytes32_from_H256(change.blockhash())};
+        database_.rotate(block_hash);
+        if (!logs_.empty()) {
+            pending_logs_->blocks.emplace_back(change.blockheight(), block_hash);
+        }
+    }
+    // Blocks are notified one after the other in the order they come, by a single coroutine
+    if (!pending_logs_->notifying && !pending_logs_->blocks.empty()) {
+        pending_logs_->notifying = true;
+        asio::co_spawn(io_context_, notify_pending_logs(pending_logs_), asio::detached);
+    }
+}
+
+void SubscriptionManager::on_pending_transactions(const ::txpool::OnAddReply& reply) {
+    SILKRPC_DEBUG << "SubscriptionManager::on_pending_transactions #txs: " << reply.rpltxs_size() << "\n";
+    for (const auto& rlp_tx : reply.rpltxs()) {
+        notify(new_pending_transactions_, hash_of_rlp(rlp_tx));
+    }
+}
+
+asio::awaitable<void> SubscriptionManager::notify_pending_logs(std::shared_ptr<PendingLogs> pending_logs) {
+    // The manager may be destroyed while waiting for the database, so it must not be touched once stopped
+    while (!pending_logs->stopped && !pending_logs->blocks.empty()) {
+        const auto [block_number, block_hash] = pending_logs->blocks.front();
+        pending_logs->blocks.pop_front();
+        try {
+            co_await notify_logs(*pending_logs, block_number, block_hash);
+        } catch (const std::exception& e) {
+            SILKRPC_ERROR << "SubscriptionManager::notify_pending_logs block_number: " << block_number << " exception: " << e.what() << "\n";
+        }
+    }
+    pending_logs->notifying = false;
+}
+
+asio::awaitable<void> SubscriptionManager::notify_logs(const PendingLogs& pending_logs, uint64_t block_number, evmc::bytes32 block_hash) {
+    auto tx = co_await database_.begin();
+
+    try {
+        ethdb::TransactionDatabase tx_database{*tx};
+
+        const auto receipts = co_await core::rawdb::read_receipts(tx_database, block_hash, block_number);
+        std::vector<Log> logs;
+        for (const auto& receipt : receipts) {
+            logs.insert(logs.end(), receipt.logs.begin(), receipt.logs.end());
+        }
+        SILKRPC_DEBUG << "SubscriptionManager::notify_logs block_number: " << block_number << " #logs: " << logs.size() << "\n";
+
+        if (!pending_logs.stopped) {
+            for_each_subscription(logs_, [&](SubscriptionId id, const LogsSubscription& subscription) {
+                for (const auto& log : core::filter_logs(logs, subscription.filter)) {
+                    subscription.handler(make_json_notification(to_subscription_id(id), log));
+                }
+            });
+        }
+    } catch (const std::exception& e) {
+        SILKRPC_ERROR << "SubscriptionManager::notify_logs block_number: " << block_number << " exception: " << e.what() << "\n";
+    }
+
+    co_await tx->close(); // RAII not (yet) available with coroutines
+    co_return;
+}
+
+} // namespace silkrpc::subscriptions
@@ -0,0 +1,178 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef SILKRPC_SUBSCRIPTIONS_SUBSCRIPTION_MANAGER_HPP_
+#define SILKRPC_SUBSCRIPTIONS_SUBSCRIPTION_MANAGER_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <silkrpc/config.hpp>
+
+#include <asio/awaitable.hpp>
+#include <asio/io_context.hpp>
+#include <asio/steady_timer.hpp>
+#include <evmc/evmc.hpp>
+#include <grpcpp/grpcpp.h>
+#include <nlohmann/json.hpp>
+
+#include <silkrpc/ethdb/database.hpp>
+#include <silkrpc/grpc/async_server_streaming_client.hpp>
+#include <silkrpc/interfaces/remote/ethbackend.grpc.pb.h>
+#include <silkrpc/interfaces/remote/kv.grpc.pb.h>
+#include <silkrpc/interfaces/txpool/txpool.grpc.pb.h>
+#include <silkrpc/types/filter.hpp>
+
+namespace silkrpc::subscriptions {
+
+using HeadersClient = AsyncServerStreamingClient<
+    ::remote::ETHBACKEND::StubInterface,
+    ::remote::SubscribeRequest,
+    ::remote::SubscribeReply,
+    &::remote::ETHBACKEND::StubInterface::PrepareAsyncSubscribe
+>;
+
+using StateChangesClient = AsyncServerStreamingClient<
+    ::remote::KV::StubInterface,
+    ::remote::StateChangeRequest,
+    ::remote::StateChangeBatch,
+    &::remote::KV::StubInterface::PrepareAsyncStateChanges
+>;
+
+using PendingTransactionsClient = AsyncServerStreamingClient<
+    ::txpool::Txpool::StubInterface,
+    ::txpool::OnAddRequest,
+    ::txpool::OnAddReply,
+    &::txpool::Txpool::StubInterface::PrepareAsyncOnAdd
+>;
+
+using SubscriptionId = uint64_t;
+
+/// The handler receiving the ready-to-send eth_subscription notifications.
+using NotificationHandler = std::function<void(const nlohmann::json& notification)>;
+
+std::string to_subscription_id(SubscriptionId id);
+
+std::optional<SubscriptionId> from_subscription_id(const std::string& id);
+
+/// Fans out the upstream event streams to the eth_subscribe subscribers living in the same Context.
+/// Each upstream stream is started on the first subscription needing it and cancelled when the last one goes away.
+/// All the methods must be called within the Context io_context thread, so no synchronization is needed.
+class SubscriptionManager {
+public:
+    explicit SubscriptionManager(asio::io_context& io_context, std::shared_ptr<grpc::Channel> channel, grpc::CompletionQueue* queue, ethdb::Database& database)
+    : SubscriptionManager(io_context, ::remote::ETHBACKEND::NewStub(channel), ::remote::KV::NewStub(channel), ::txpool::Txpool::NewStub(channel), queue, database) {}
+
+    explicit SubscriptionManager(asio::io_context& io_context,
+        std::unique_ptr<::remote::ETHBACKEND::StubInterface> backend_stub,
+        std::unique_ptr<::remote::KV::StubInterface> kv_stub,
+        std::unique_ptr<::txpool::Txpool::StubInterface> txpool_stub,
+        grpc::CompletionQueue* queue,
+        ethdb::Database& database);
+
+    ~SubscriptionManager();
+
+    SubscriptionManager(const SubscriptionManager&) = delete;
+    SubscriptionManager& operator=(const SubscriptionManager&) = delete;
+
+    SubscriptionId subscribe_new_heads(NotificationHandler handler);
+
+    SubscriptionId subscribe_logs(const Filter& filter, NotificationHandler handler);
+
+    SubscriptionId subscribe_new_pending_transactions(NotificationHandler handler);
+
+    bool unsubscribe(SubscriptionId id);
+
+    /// Keep the headers streaming even without subscribers, so that the database is rotated at each new head.
+    void rotate_on_new_heads();
+
+    std::size_t num_subscriptions() const { return new_heads_.size() + logs_.size() + new_pending_transactions_.size(); }
+
+private:
+    struct LogsSubscription {
+        Filter filter;
+        NotificationHandler handler;
+    };
+
+    /// The blocks whose logs are waiting to be notified, consumed in arrival order by one coroutine at a time. It is
+    /// shared with such coroutine, which may still be waiting for the database when the manager is destroyed.
+    struct PendingLogs {
+        std::deque<std::pair<uint64_t, evmc::bytes32>> blocks;
+        bool notifying{false};
+        bool stopped{false};
+    };
+
+    /// The state of one upstream server-streaming call.
+    template<typename Client>
+    struct Upstream {
+        explicit Upstream(asio::io_context& io_context) : retry_timer{io_context} {}
+
+        std::unique_ptr<Client> client;
+        asio::steady_timer retry_timer;
+    };
+
+    template<typename Client, typename StubInterface, typename Request, typename Reply>
+    void start_upstream(Upstream<Client>& upstream, std::unique_ptr<StubInterface>& stub, const Request& request,
+        void (SubscriptionManager::*on_reply)(const Reply&), std::function<bool()> is_needed);
+
+    template<typename Client>
+    void stop_upstream(Upstream<Client>& upstream);
+
+    void start_headers();
+    void start_state_changes();
+    void start_pending_transactions();
+
+    void on_header(const ::remote::SubscribeReply& reply);
+    void on_state_changes(const ::remote::StateChangeBatch& batch);
+    void on_pending_transactions(const ::txpool::OnAddReply& reply);
+
+    asio::awaitable<void> notify_pending_logs(std::shared_ptr<PendingLogs> pending_logs);
+
+    asio::awaitable<void> notify_logs(const PendingLogs& pending_logs, uint64_t block_number, evmc::bytes32 block_hash);
+
+    asio::io_context& io_context_;
+    std::unique_ptr<::remote::ETHBACKEND::StubInterface> backend_stub_;
+    std::unique_ptr<::remote::KV::StubInterface> kv_stub_;
+    std::unique_ptr<::txpool::Txpool::StubInterface> txpool_stub_;
+    grpc::CompletionQueue* queue_;
+    ethdb::Database& database_;
+
+    Upstream<HeadersClient> headers_;
+    Upstream<StateChangesClient> state_changes_;
+    Upstream<PendingTransactionsClient> pending_transactions_;
+
+    // Subscriptions are shared, so that each one can be kept alive while notified even if its handler unsubscribes
+    std::map<SubscriptionId, std::shared_ptr<NotificationHandler>> new_heads_;
+    std::map<SubscriptionId, std::shared_ptr<LogsSubscription>> logs_;
+    std::map<SubscriptionId, std::shared_ptr<NotificationHandler>> new_pending_transactions_;
+
+    std::shared_ptr<PendingLogs> pending_logs_;
+
+    bool rotating_on_new_heads_{false};
+
+    SubscriptionId next_id_{1};
+    bool stopping_{false};
+};
+
+} // namespace silkrpc::subscriptions
+
+#endif // SILKRPC_SUBSCRIPTIONS_SUBSCRIPTION_MANAGER_HPP_
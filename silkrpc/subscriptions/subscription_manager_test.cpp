@@ -0,0 +1,306 @@
+/*
+    Copyright 2020 The Silkrpc Authors
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "subscription_manager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <asio/io_context.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/use_awaitable.hpp>
+#include <catch2/catch.hpp>
+#include <gmock/gmock.h>
+#include <nlohmann/json.hpp>
+
+#include <silkrpc/common/log.hpp>
+#include <silkrpc/grpc/async_completion_handler.hpp>
+#include <silkrpc/interfaces/remote/ethbackend_mock.grpc.pb.h>
+#include <silkrpc/interfaces/remote/kv_mock.grpc.pb.h>
+#include <silkrpc/interfaces/txpool/txpool_mock.grpc.pb.h>
+
+namespace silkrpc::subscriptions {
+
+using testing::Return;
+using testing::_;
+
+class EmptyDatabase : public ethdb::Database {
+public:
+    asio::awaitable<std::unique_ptr<ethdb::Transaction>> begin() override {
+        throw std::runtime_error{"unexpected begin"};
+    }
+
+    void rotate(const evmc::bytes32& /*head_hash*/) override { ++num_rotations; }
+
+    std::size_t num_rotations{0};
+};
+
+// Database failing each transaction after some delay, counting how many are being opened at the same time
+class SlowDatabase : public ethdb::Database {
+public:
+    explicit SlowDatabase(asio::io_context& io_context) : io_context_(io_context) {}
+
+    asio::awaitable<std::unique_ptr<ethdb::Transaction>> begin() override {
+        max_concurrent_begins = std::max(++concurrent_begins, max_concurrent_begins);
+        asio::steady_timer timer{io_context_, std::chrono::milliseconds{10}};
+        co_await timer.async_wait(asio::use_awaitable);
+        --concurrent_begins;
+        ++num_begins;
+        throw std::runtime_error{"unavailable"};
+    }
+
+    void rotate(const evmc::bytes32& /*head_hash*/) override { ++num_rotations; }
+
+    std::size_t concurrent_begins{0};
+    std::size_t max_concurrent_begins{0};
+    std::size_t num_begins{0};
+    std::size_t num_rotations{0};
+
+private:
+    asio::io_context& io_context_;
+};
+
+class MockClientAsyncStateChangesReader : public grpc::ClientAsyncReaderInterface<::remote::StateChangeBatch> {
+public:
+    explicit MockClientAsyncStateChangesReader(std::vector<uint64_t> block_heights) : block_heights_(std::move(block_heights)) {}
+
+    void StartCall(void* tag) override { tag_ = tag; }
+    void ReadInitialMetadata(void* tag) override {}
+    void Read(::remote::StateChangeBatch* msg, void* tag) override {
+        msg->clear_changebatch();
+        for (const auto block_height : block_heights_) {
+            auto change = msg->add_changebatch();
+            change->set_direction(::remote::Direction::FORWARD);
+            change->set_blockheight(block_height);
+        }
+    }
+    void Finish(grpc::Status* status, void* tag) override { *status = grpc::Status::CANCELLED; }
+
+    void* tag() const { return tag_; }
+
+private:
+    std::vector<uint64_t> block_heights_;
+    void* tag_{nullptr};
+};
+
+class MockClientAsyncSubscribeReader : public grpc::ClientAsyncReaderInterface<::remote::SubscribeReply> {
+public:
+    explicit MockClientAsyncSubscribeReader(std::string header_rlp) : header_rlp_(std::move(header_rlp)) {}
+
+    void StartCall(void* tag) override { tag_ = tag; }
+    void ReadInitialMetadata(void* tag) override {}
+    void Read(::remote::SubscribeReply* msg, void* tag) override {
+        msg->set_type(::remote::Event::HEADER);
+        msg->set_data(header_rlp_);
+    }
+    void Finish(grpc::Status* status, void* tag) override { *status = grpc::Status::CANCELLED; }
+
+    void* tag() const { return tag_; }
+
+private:
+    std::string header_rlp_;
+    void* tag_{nullptr};
+};
+
+class MockClientAsyncOnAddReader : public grpc::ClientAsyncReaderInterface<::txpool::OnAddReply> {
+public:
+    explicit MockClientAsyncOnAddReader(std::vector<std::string> rlp_txs) : rlp_txs_(std::move(rlp_txs)) {}
+
+    void StartCall(void* tag) override { tag_ = tag; }
+    void ReadInitialMetadata(void* tag) override {}
+    void Read(::txpool::OnAddReply* msg, void* tag) override {
+        msg->clear_rpltxs();
+        for (const auto& rlp_tx : rlp_txs_) {
+            msg->add_rpltxs(rlp_tx);
+        }
+    }
+    void Finish(grpc::Status* status, void* tag) override { *status = grpc::Status::CANCELLED; }
+
+    void* tag() const { return tag_; }
+
+private:
+    std::vector<std::string> rlp_txs_;
+    void* tag_{nullptr};
+};
+
+TEST_CASE("subscription id conversion", "[silkrpc][subscriptions][subscription_manager]") {
+    CHECK(to_subscription_id(1) == "0x1");
+    CHECK(to_subscription_id(0xabcdef) == "0xabcdef");
+    CHECK(from_subscription_id("0x1") == SubscriptionId{1});
+    CHECK(from_subscription_id("0xABCDEF") == SubscriptionId{0xabcdef});
+    CHECK(from_subscription_id(to_subscription_id(0xffffffffffffffff)) == SubscriptionId{0xffffffffffffffff});
+    CHECK(!from_subscription_id(""));
+    CHECK(!from_subscription_id("0x"));
+    CHECK(!from_subscription_id("12"));
+    CHECK(!from_subscription_id("0xz1"));
+    CHECK(!from_subscription_id("0x10000000000000000"));
+}
+
+TEST_CASE("subscription manager", "[silkrpc][subscriptions][subscription_manager]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    asio::io_context io_context;
+    grpc::CompletionQueue queue;
+    EmptyDatabase database;
+    auto backend_stub = std::make_unique<::remote::MockETHBACKENDStub>();
+    auto backend_stub_ptr = backend_stub.get();
+    auto kv_stub = std::make_unique<::remote::MockKVStub>();
+    auto txpool_stub = std::make_unique<::txpool::MockTxpoolStub>();
+    auto txpool_stub_ptr = txpool_stub.get();
+    SubscriptionManager manager{io_context, std::move(backend_stub), std::move(kv_stub), std::move(txpool_stub), &queue, database};
+
+    SECTION("unsubscribe unknown subscription") {
+        CHECK(!manager.unsubscribe(1));
+    }
+
+    SECTION("notify new pending transactions") {
+        auto mock_reader = new MockClientAsyncOnAddReader{{"tx1", "tx2"}};
+        EXPECT_CALL(*txpool_stub_ptr, PrepareAsyncOnAddRaw(_, _, _)).WillOnce(Return(mock_reader));
+
+        std::vector<nlohmann::json> notifications1, notifications2;
+        const auto id1 = manager.subscribe_new_pending_transactions([&](const auto& n) { notifications1.push_back(n); });
+        const auto id2 = manager.subscribe_new_pending_transactions([&](const auto& n) { notifications2.push_back(n); });
+        CHECK(id1 != id2);
+        CHECK(manager.num_subscriptions() == 2);
+
+        auto handler = AsyncCompletionHandler::detag(mock_reader->tag());
+        handler->completed(true); // StartCall
+        handler->completed(true); // Read
+        CHECK(notifications1.size() == 2);
+        CHECK(notifications2.size() == 2);
+        CHECK(notifications1[0]["method"] == "eth_subscription");
+        CHECK(notifications1[0]["params"]["subscription"] == to_subscription_id(id1));
+        CHECK(notifications2[1]["params"]["subscription"] == to_subscription_id(id2));
+        CHECK(notifications1[0]["params"]["result"] == notifications2[0]["params"]["result"]);
+        CHECK(notifications1[0]["params"]["result"] != notifications1[1]["params"]["result"]);
+
+        CHECK(manager.unsubscribe(id1));
+        handler->completed(true); // Read
+        CHECK(notifications1.size() == 2);
+        CHECK(notifications2.size() == 4);
+
+        CHECK(manager.unsubscribe(id2));
+        CHECK(manager.num_subscriptions() == 0);
+        handler->completed(false); // stream cancelled
+        handler->completed(true);  // Finish
+    }
+
+    SECTION("rotate on new heads without subscribers") {
+        auto mock_reader = new MockClientAsyncSubscribeReader{"header"};
+        EXPECT_CALL(*backend_stub_ptr, PrepareAsyncSubscribeRaw(_, _, _)).WillOnce(Return(mock_reader));
+
+        manager.rotate_on_new_heads();
+        CHECK(manager.num_subscriptions() == 0);
+
+        auto handler = AsyncCompletionHandler::detag(mock_reader->tag());
+        handler->completed(true); // StartCall
+        handler->completed(true); // Read
+        handler->completed(true); // Read
+        CHECK(database.num_rotations == 2);
+
+        // The stream is kept when the last subscriber goes away
+        const auto id = manager.subscribe_new_heads([](const auto& /*n*/) {});
+        CHECK(manager.unsubscribe(id));
+        handler->completed(true); // Read
+        CHECK(database.num_rotations == 3);
+        handler->completed(false); // stream cancelled
+        handler->completed(true);  // Finish
+    }
+
+    SECTION("handlers (un)subscribing while notified") {
+        auto mock_reader = new MockClientAsyncOnAddReader{{"tx1"}};
+        EXPECT_CALL(*txpool_stub_ptr, PrepareAsyncOnAddRaw(_, _, _)).WillOnce(Return(mock_reader));
+
+        // The first handler replaces itself with a new subscription, which gets just the next notifications
+        std::vector<nlohmann::json> notifications1, notifications2, notifications3;
+        SubscriptionId id1{0}, id3{0};
+        id1 = manager.subscribe_new_pending_transactions([&](const auto& n) {
+            notifications1.push_back(n);
+            CHECK(manager.unsubscribe(id1));
+            id3 = manager.subscribe_new_pending_transactions([&](const auto& n3) { notifications3.push_back(n3); });
+        });
+        const auto id2 = manager.subscribe_new_pending_transactions([&](const auto& n) { notifications2.push_back(n); });
+
+        auto handler = AsyncCompletionHandler::detag(mock_reader->tag());
+        handler->completed(true); // StartCall
+        handler->completed(true); // Read
+        CHECK(notifications1.size() == 1);
+        CHECK(notifications2.size() == 1);
+        CHECK(notifications3.empty());
+
+        handler->completed(true); // Read
+        CHECK(notifications1.size() == 1);
+        CHECK(notifications2.size() == 2);
+        CHECK(notifications3.size() == 1);
+
+        CHECK(manager.unsubscribe(id2));
+        CHECK(manager.unsubscribe(id3));
+        handler->completed(false); // stream cancelled
+        handler->completed(true);  // Finish
+    }
+}
+
+TEST_CASE("subscription manager logs", "[silkrpc][subscriptions][subscription_manager]") {
+    SILKRPC_LOG_VERBOSITY(LogLevel::None);
+
+    asio::io_context io_context;
+    grpc::CompletionQueue queue;
+    SlowDatabase database{io_context};
+    auto kv_stub = std::make_unique<::remote::MockKVStub>();
+    auto kv_stub_ptr = kv_stub.get();
+    auto manager = std::make_unique<SubscriptionManager>(io_context, std::make_unique<::remote::MockETHBACKENDStub>(), std::move(kv_stub),
+        std::make_unique<::txpool::MockTxpoolStub>(), &queue, database);
+
+    auto mock_reader = new MockClientAsyncStateChangesReader{{1, 2, 3}};
+    EXPECT_CALL(*kv_stub_ptr, PrepareAsyncStateChangesRaw(_, _, _)).WillOnce(Return(mock_reader));
+    const auto id = manager->subscribe_logs(Filter{}, [](const auto& /*n*/) {});
+    auto handler = AsyncCompletionHandler::detag(mock_reader->tag());
+    handler->completed(true); // StartCall
+    handler->completed(true); // Read
+    CHECK(database.num_rotations == 3);
+
+    SECTION("blocks notified one at a time") {
+        io_context.run();
+        CHECK(database.num_begins == 3);
+        CHECK(database.max_concurrent_begins == 1);
+    }
+
+    SECTION("pending blocks dropped on destruction") {
+        io_context.poll();
+        CHECK(database.concurrent_begins == 1);
+
+        CHECK(manager->unsubscribe(id));
+        handler->completed(false); // stream cancelled
+        handler->completed(true);  // Finish
+        manager.reset();
+
+        io_context.run();
+        CHECK(database.num_begins == 1);
+    }
+
+    if (manager) {
+        CHECK(manager->unsubscribe(id));
+        handler->completed(false); // stream cancelled
+        handler->completed(true);  // Finish
+    }
+}
+
+} // namespace silkrpc::subscriptions